@@ -0,0 +1,153 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <geodesk/geodesk.h>
+#include <geodesk/geom/index/ChainKernels.h>
+
+using namespace geodesk;
+
+// Compares the scalar, SSE2 and AVX2 implementations of the
+// ray-crossing and segment-intersection kernels used by the
+// point-in-polygon and within/intersects tests:
+//
+// - on a synthetic country-sized boundary (200K vertices)
+// - optionally, on the actual boundary of a country, if a GOL file
+//   is given: chain-kernel-bench <gol> [<country name>]
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    void start()
+    {
+        start_ = std::chrono::high_resolution_clock::now();
+    }
+
+    void stop(const char* msg)
+    {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start_;
+        std::cout << msg << " took " << duration.count() << " seconds\n";
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+static const ChainKernels::Implementation IMPLEMENTATIONS[] =
+{
+    ChainKernels::Implementation::SCALAR,
+    ChainKernels::Implementation::SSE2,
+    ChainKernels::Implementation::AVX2
+};
+
+// A ragged ring around the origin, roughly the size of Germany
+static std::vector<Coordinate> createBoundary(int vertexCount, std::mt19937& random)
+{
+    std::vector<Coordinate> coords;
+    std::uniform_real_distribution<double> noise(0.9, 1.1);
+    double radius = 30'000'000;
+    for (int i = 0; i < vertexCount; i++)
+    {
+        double angle = 2 * 3.14159265358979 * i / vertexCount;
+        double r = radius * noise(random);
+        coords.emplace_back(r * std::cos(angle), r * std::sin(angle));
+    }
+    coords.push_back(coords[0]);
+    return coords;
+}
+
+static void benchmarkSynthetic()
+{
+    std::mt19937 random(42);
+    std::vector<Coordinate> boundary = createBoundary(200'000, random);
+    std::uniform_int_distribution<int32_t> pos(-36'000'000, 36'000'000);
+    std::vector<Coordinate> points;
+    for (int i = 0; i < 2'000; i++) points.emplace_back(pos(random), pos(random));
+
+    // Segment pairs as produced by walking a way along the boundary
+    std::vector<ChainKernels::SegmentPairs> batches(100'000);
+    for (ChainKernels::SegmentPairs& pairs : batches)
+    {
+        size_t n = random() % (boundary.size() - 32);
+        Coordinate offset(pos(random) / 1000, pos(random) / 1000);
+        for (int i = 0; i < ChainKernels::SegmentPairs::CAPACITY; i++)
+        {
+            Coordinate a = boundary[n + i];
+            Coordinate b = boundary[n + i + 1];
+            pairs.add(a, b,
+                Coordinate(a.x + offset.x, a.y + offset.y),
+                Coordinate(b.x + offset.x, b.y + offset.y));
+        }
+    }
+
+    for (ChainKernels::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!ChainKernels::select(impl)) continue;
+        std::cout << "\n" << ChainKernels::implementationName() << ":\n";
+
+        Timer timer;
+        size_t inside = 0;
+        for (Coordinate pt : points)
+        {
+            uint32_t crossings = 0;
+            ChainKernels::countCrossings(boundary.data(), boundary.size(), pt, crossings);
+            if (crossings & 2) inside++;
+        }
+        timer.stop("Point-in-polygon (2K points x 200K vertices)");
+        std::cout << inside << " points inside\n";
+
+        timer.start();
+        size_t intersecting = 0;
+        for (int run = 0; run < 10; run++)
+        {
+            for (const ChainKernels::SegmentPairs& pairs : batches)
+            {
+                if (ChainKernels::anyIntersect(pairs)) intersecting++;
+            }
+        }
+        timer.stop("Segment intersection (16M pairs)");
+        std::cout << intersecting << " batches intersect\n";
+    }
+}
+
+static void benchmarkCountry(const char* golFile, const char* name)
+{
+    Features world(golFile);
+    std::string query = std::string("a[boundary=administrative][admin_level=2][name:en=\"")
+        + name + "\"]";
+    Feature country = world(query.c_str()).one();
+    Features nodes = world("n");
+    Features ways = world("w[highway]");
+
+    for (ChainKernels::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!ChainKernels::select(impl)) continue;
+        std::cout << "\n" << name << ", " << ChainKernels::implementationName() << ":\n";
+
+        Timer timer;
+        uint64_t count = nodes.within(country).count();
+        timer.stop("Nodes within country");
+        std::cout << count << " nodes\n";
+
+        timer.start();
+        count = ways.within(country).count();
+        timer.stop("Highways within country");
+        std::cout << count << " highways\n";
+
+        timer.start();
+        count = ways.intersecting(country).count();
+        timer.stop("Highways intersecting country");
+        std::cout << count << " highways\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmarkSynthetic();
+    if (argc > 1) benchmarkCountry(argv[1], argc > 2 ? argv[2] : "Germany");
+    return 0;
+}
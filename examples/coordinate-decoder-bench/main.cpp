@@ -0,0 +1,141 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <clarisma/util/varint.h>
+#include <geodesk/geodesk.h>
+#include <geodesk/feature/CoordinateDecoder.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+
+using namespace geodesk;
+
+// Measures the throughput (in coordinates per second) of the scalar
+// and SSSE3 implementations of the bulk coordinate decoder:
+//
+// - on a synthetic run of 10M delta-encoded coordinates
+// - optionally, on the ways of a GOL file, comparing
+//   WayCoordinateIterator::next() and nextBatch():
+//   coordinate-decoder-bench <gol> [<query>]
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    void start()
+    {
+        start_ = std::chrono::high_resolution_clock::now();
+    }
+
+    double stop(const char* msg, uint64_t coordCount)
+    {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start_;
+        std::cout << msg << " took " << duration.count() << " seconds ("
+            << static_cast<uint64_t>(coordCount / duration.count())
+            << " coordinates/s)\n";
+        return duration.count();
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+static const CoordinateDecoder::Implementation IMPLEMENTATIONS[] =
+{
+    CoordinateDecoder::Implementation::SCALAR,
+    CoordinateDecoder::Implementation::SSSE3
+};
+
+static void benchmarkSynthetic()
+{
+    // A random walk with steps of typical OSM node spacing (a few
+    // meters to a few hundred meters), plus an occasional long jump
+    constexpr size_t COUNT = 10'000'000;
+    std::mt19937 random(42);
+    std::normal_distribution<double> step(0, 3000);
+    std::vector<uint8_t> encoded(COUNT * 10);
+    uint8_t* p = encoded.data();
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        bool jump = (random() % 1000) == 0;
+        clarisma::writeSignedVarint(p, static_cast<int64_t>(step(random) * (jump ? 1000 : 1)));
+        clarisma::writeSignedVarint(p, static_cast<int64_t>(step(random) * (jump ? 1000 : 1)));
+    }
+    std::cout << "Synthetic: " << COUNT << " coordinates, "
+        << static_cast<double>(p - encoded.data()) / COUNT << " bytes each\n";
+
+    std::vector<Coordinate> reference;
+    for (CoordinateDecoder::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!CoordinateDecoder::select(impl)) continue;
+        std::cout << "\n" << CoordinateDecoder::implementationName() << ":\n";
+        std::vector<Coordinate> coords(COUNT);
+        Timer timer;
+        for (int run = 0; run < 10; run++)
+        {
+            CoordinateDecoder::decode(encoded.data(), COUNT, Coordinate(0, 0), coords.data());
+        }
+        timer.stop("Decoding 100M coordinates", COUNT * 10);
+        if (reference.empty())
+        {
+            reference = std::move(coords);
+        }
+        else if (memcmp(reference.data(), coords.data(), COUNT * sizeof(Coordinate)) != 0)
+        {
+            std::cout << "ERROR: results differ from scalar decoder\n";
+        }
+    }
+}
+
+static void benchmarkGol(const char* golFile, const char* query)
+{
+    Features world(golFile);
+    Features ways = world(query);
+
+    for (CoordinateDecoder::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!CoordinateDecoder::select(impl)) continue;
+        std::cout << "\n" << golFile << ", " << CoordinateDecoder::implementationName() << ":\n";
+
+        Timer timer;
+        uint64_t coordCount = 0;
+        int64_t checksum = 0;
+        for (Feature way : ways)
+        {
+            WayCoordinateIterator iter(WayPtr(way.ptr()));
+            for (;;)
+            {
+                Coordinate c = iter.next();
+                if (c.isNull()) break;
+                checksum += c.x;
+                coordCount++;
+            }
+        }
+        timer.stop("next()", coordCount);
+
+        timer.start();
+        int64_t batchChecksum = 0;
+        Coordinate coords[WayCoordinateIterator::BATCH_SIZE];
+        for (Feature way : ways)
+        {
+            WayCoordinateIterator iter(WayPtr(way.ptr()));
+            for (;;)
+            {
+                int count = iter.nextBatch(coords, WayCoordinateIterator::BATCH_SIZE);
+                if (count == 0) break;
+                for (int i = 0; i < count; i++) batchChecksum += coords[i].x;
+            }
+        }
+        timer.stop("nextBatch()", coordCount);
+        if (batchChecksum != checksum) std::cout << "ERROR: checksums differ\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmarkSynthetic();
+    if (argc > 1) benchmarkGol(argv[1], argc > 2 ? argv[2] : "w");
+    return 0;
+}
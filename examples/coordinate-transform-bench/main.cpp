@@ -0,0 +1,152 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <geodesk/geodesk.h>
+#include <geodesk/geom/CoordinateTransform.h>
+#include <clarisma/util/Buffer.h>
+#include <clarisma/util/BufferWriter.h>
+
+using namespace geodesk;
+
+// Compares the bulk conversion of Mercator coordinates to lon/lat
+// (scalar and AVX2) against Mercator::lonFromX() / latFromY(), for
+// 10M coordinates spread over all latitudes, both as plain conversion
+// and as conversion plus formatting with 7 decimal places (the way
+// GeometryWriter writes coordinates):
+//
+//   coordinate-transform-bench
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    void start()
+    {
+        start_ = std::chrono::high_resolution_clock::now();
+    }
+
+    void stop(const char* msg, uint64_t coordCount)
+    {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start_;
+        std::cout << msg << " took " << duration.count() << " seconds ("
+            << static_cast<uint64_t>(coordCount / duration.count())
+            << " coordinates/s)\n";
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+static const CoordinateTransform::Implementation IMPLEMENTATIONS[] =
+{
+    CoordinateTransform::Implementation::SCALAR,
+    CoordinateTransform::Implementation::AVX2
+};
+
+static const int PRECISION = 7;
+static const size_t BATCH_SIZE = 64;
+static const size_t BUFFER_SIZE = 512 * 1024 * 1024;
+
+int main(int argc, char* argv[])
+{
+    constexpr size_t COUNT = 10'000'000;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int32_t> pos(-2'000'000'000, 2'000'000'000);
+    std::vector<Coordinate> coords(COUNT);
+    for (Coordinate& c : coords) c = Coordinate(pos(random), pos(random));
+
+    std::vector<double> lon(COUNT);
+    std::vector<double> lat(COUNT);
+    std::vector<int64_t> scaledLon(COUNT);
+    std::vector<int64_t> scaledLat(COUNT);
+
+    std::cout << "Mercator::lonFromX() / latFromY():\n";
+    Timer timer;
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        lon[i] = Mercator::lonFromX(coords[i].x);
+        lat[i] = Mercator::latFromY(coords[i].y);
+    }
+    timer.stop("Conversion", COUNT);
+    clarisma::DynamicBuffer buf(BUFFER_SIZE);
+    timer.start();
+    {
+        clarisma::BufferWriter out(&buf);
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            out.formatDouble(Mercator::lonFromX(coords[i].x), PRECISION);
+            out.writeByte(',');
+            out.formatDouble(Mercator::latFromY(coords[i].y), PRECISION);
+            out.writeByte(',');
+        }
+        out.flush();
+    }
+    timer.stop("Conversion and formatDouble()", COUNT);
+    std::cout << buf.length() << " bytes\n";
+
+    for (CoordinateTransform::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!CoordinateTransform::select(impl)) continue;
+        std::cout << "\n" << CoordinateTransform::implementationName() << ":\n";
+        std::vector<double> batchLon(COUNT);
+        std::vector<double> batchLat(COUNT);
+        timer.start();
+        CoordinateTransform::toLonLat(coords.data(), COUNT, batchLon.data(), batchLat.data());
+        timer.stop("toLonLat()", COUNT);
+
+        double maxLatError = 0;
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            maxLatError = std::max(maxLatError, std::abs(batchLat[i] - lat[i]));
+        }
+        std::cout << "Max. latitude error: " << maxLatError << " degrees\n";
+
+        timer.start();
+        CoordinateTransform::toScaledLonLat(coords.data(), COUNT, PRECISION,
+            scaledLon.data(), scaledLat.data());
+        timer.stop("toScaledLonLat()", COUNT);
+
+        size_t mismatches = 0;
+        double multiplier = std::pow(10.0, PRECISION);
+        for (size_t i = 0; i < COUNT; i++)
+        {
+            if (scaledLon[i] != static_cast<int64_t>(std::round(lon[i] * multiplier)) ||
+                scaledLat[i] != static_cast<int64_t>(std::round(lat[i] * multiplier)))
+            {
+                mismatches++;
+            }
+        }
+        std::cout << "Coordinates that differ at " << PRECISION
+            << " decimal places: " << mismatches << "\n";
+
+        clarisma::DynamicBuffer buf(BUFFER_SIZE);
+        timer.start();
+        {
+            clarisma::BufferWriter out(&buf);
+            int64_t lonBatch[BATCH_SIZE];
+            int64_t latBatch[BATCH_SIZE];
+            for (size_t i = 0; i < COUNT; i += BATCH_SIZE)
+            {
+                size_t n = std::min(BATCH_SIZE, COUNT - i);
+                CoordinateTransform::toScaledLonLat(&coords[i], n, PRECISION,
+                    lonBatch, latBatch);
+                for (size_t i2 = 0; i2 < n; i2++)
+                {
+                    out.formatFixed(lonBatch[i2], PRECISION);
+                    out.writeByte(',');
+                    out.formatFixed(latBatch[i2], PRECISION);
+                    out.writeByte(',');
+                }
+            }
+            out.flush();
+        }
+        timer.stop("toScaledLonLat() and formatFixed()", COUNT);
+        std::cout << buf.length() << " bytes\n";
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <geodesk/geodesk.h>
+
+using namespace geodesk;
+
+// Builds the derived-attributes sidecar for a GOL, then finds the
+// 100 largest lakes, first by computing their areas and then by
+// reading them from the sidecar:
+//
+//   derived-attributes <gol> [<sidecar>]
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    void start()
+    {
+        start_ = std::chrono::high_resolution_clock::now();
+    }
+
+    void stop(const char* msg)
+    {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start_;
+        std::cout << msg << " took " << duration.count() << " seconds\n";
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+static std::vector<std::pair<double,int64_t>> largestLakes(const Features& world)
+{
+    std::vector<std::pair<double,int64_t>> lakes;
+    for (Feature lake : world("a[natural=water][water=lake]"))
+    {
+        lakes.emplace_back(lake.area(), lake.id());
+    }
+    size_t n = std::min<size_t>(100, lakes.size());
+    std::partial_sort(lakes.begin(), lakes.begin() + n, lakes.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+    lakes.resize(n);
+    return lakes;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: derived-attributes <gol> [<sidecar>]\n";
+        return 1;
+    }
+    std::string sidecar = argc > 2 ? argv[2] : std::string(argv[1]) + ".derived";
+    Features world(argv[1]);
+
+    Timer timer;
+    DerivedAttributes::build(world, sidecar.c_str());
+    timer.stop("Building the sidecar");
+
+    timer.start();
+    auto computed = largestLakes(world);
+    timer.stop("Largest 100 lakes (computed)");
+
+    world.store()->openDerivedAttributes(sidecar.c_str());
+    timer.start();
+    auto precomputed = largestLakes(world);
+    timer.stop("Largest 100 lakes (sidecar)");
+
+    std::cout << (computed == precomputed ? "Results match\n" : "Results differ!\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string_view>
+#include <geodesk/geodesk.h>
+
+using namespace geodesk;
+
+// Compares lookups of uncommon (local) keys via a linear scan with
+// string comparisons against lookups via Tags (which resolve key
+// strings via the thread's LocalKeyCache), using relations with many
+// name translations (country and state borders)
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    void start()
+    {
+        start_ = std::chrono::high_resolution_clock::now();
+    }
+
+    void stop(const char* msg)
+    {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start_;
+        std::cout << msg << " took " << duration.count() << " seconds\n";
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+static const char* LANGUAGE_KEYS[] =
+{
+    "name:ab", "name:ast", "name:bar", "name:bpy", "name:ckb", "name:diq",
+    "name:eml", "name:frr", "name:gan", "name:hak", "name:ilo", "name:jbo",
+    "name:kab", "name:lij", "name:mhr", "name:nds-nl", "name:pam", "name:rue",
+    "name:szl", "name:vec", "name:wuu", "name:xmf", "name:zea", "name:nonexistent"
+};
+
+int main(int argc, char* argv[])
+{
+    const char* golFile = argc > 1 ? argv[1] : R"(c:\geodesk\tests\de.gol)";
+    Features world(golFile);
+    std::vector<Feature> areas = world("ar[boundary=administrative][admin_level<=4]");
+    std::cout << areas.size() << " admin areas\n";
+
+    std::vector<std::string_view> keys;
+    for (const char* k : LANGUAGE_KEYS)
+    {
+        if (world.key(k).code() >= 0) continue;     // only benchmark local keys
+        keys.push_back(k);
+    }
+    std::cout << keys.size() << " local keys\n";
+
+    for (int run = 1; run <= 5; run++)
+    {
+        std::cout << "\nRun " << run << "\n";
+
+        Timer timer;
+        size_t found = 0;
+        for (int i = 0; i < 100; i++)
+        {
+            for (Feature area : areas)
+            {
+                TagTablePtr tags = area.ptr().tags();
+                for (std::string_view key : keys)
+                {
+                    if (tags.getLocalKeyValue(key.data(), key.size())) found++;
+                }
+            }
+        }
+        timer.stop("Lookup via linear scan");
+        std::cout << found << " tags found\n";
+
+        timer.start();
+        found = 0;
+        for (int i = 0; i < 100; i++)
+        {
+            for (Feature area : areas)
+            {
+                Tags tags = area.tags();
+                for (std::string_view key : keys)
+                {
+                    if (tags[key]) found++;
+                }
+            }
+        }
+        timer.stop("Lookup via Tags (LocalKeyCache)");
+        std::cout << found << " tags found\n";
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <geodesk/geodesk.h>
+#include <geodesk/geom/Distance.h>
+#include <geodesk/geom/MeasureKernels.h>
+
+using namespace geodesk;
+
+// Compares the accuracy and throughput of the length and area kernels
+// (scalar and AVX2, using polynomial approximations) against the
+// scalar code that calls the C library for each coordinate:
+//
+// - on a synthetic run of 10M coordinates
+// - optionally, Features::length() and area() on a GOL file:
+//   measure-kernel-bench <gol> [<query>]
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    void start()
+    {
+        start_ = std::chrono::high_resolution_clock::now();
+    }
+
+    void stop(const char* msg, uint64_t coordCount = 0)
+    {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start_;
+        std::cout << msg << " took " << duration.count() << " seconds";
+        if (coordCount)
+        {
+            std::cout << " (" << static_cast<uint64_t>(coordCount / duration.count())
+                << " coordinates/s)";
+        }
+        std::cout << "\n";
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+static const MeasureKernels::Implementation IMPLEMENTATIONS[] =
+{
+    MeasureKernels::Implementation::SCALAR,
+    MeasureKernels::Implementation::AVX2
+};
+
+static double relativeError(double value, double reference)
+{
+    if (reference == 0) return std::abs(value);
+    return std::abs((value - reference) / reference);
+}
+
+// The reference projection, as used by LambertArea::project()
+static void projectReference(Coordinate c, double& x, double& y)
+{
+    constexpr double R = 6371000;
+    double lat = Mercator::latFromY(c.y);
+    x = R * Mercator::lonFromX(c.x) * M_PI / 180 * std::cos(lat * M_PI / 180);
+    y = R * lat * M_PI / 180;
+}
+
+static void checkAccuracy()
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> tRange(-M_PI, M_PI);
+    std::uniform_real_distribution<double> xRange(0.04, 25);
+    double maxExpError = 0;
+    double maxAtanError = 0;
+    for (int i = 0; i < 1'000'000; i++)
+    {
+        double t = tRange(random);
+        maxExpError = std::max(maxExpError,
+            relativeError(MeasureKernels::exp(t), std::exp(t)));
+        double x = xRange(random);
+        maxAtanError = std::max(maxAtanError,
+            relativeError(MeasureKernels::atan(x), std::atan(x)));
+    }
+    std::cout << "Max. relative error of exp(): " << maxExpError << "\n";
+    std::cout << "Max. relative error of atan(): " << maxAtanError << "\n";
+
+    // Segments and coordinates spread over all latitudes
+    std::uniform_int_distribution<int32_t> pos(-2'000'000'000, 2'000'000'000);
+    std::uniform_int_distribution<int32_t> step(-20'000, 20'000);
+    std::vector<Coordinate> coords;
+    for (int i = 0; i < 100'000; i++)
+    {
+        Coordinate c(pos(random), pos(random));
+        coords.push_back(c);
+        coords.emplace_back(c.x + step(random), c.y + step(random));
+    }
+    std::vector<double> x(coords.size());
+    std::vector<double> y(coords.size());
+    for (MeasureKernels::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!MeasureKernels::select(impl)) continue;
+        double maxLengthError = 0;
+        double maxProjectionError = 0;
+        MeasureKernels::projectSinusoidal(coords.data(), coords.size(), x.data(), y.data());
+        for (size_t i = 0; i < coords.size(); i += 2)
+        {
+            maxLengthError = std::max(maxLengthError, relativeError(
+                MeasureKernels::length(&coords[i], 2),
+                Distance::metersBetween(coords[i], coords[i + 1])));
+            double refX, refY;
+            projectReference(coords[i], refX, refY);
+            maxProjectionError = std::max(maxProjectionError,
+                std::max(relativeError(x[i], refX), relativeError(y[i], refY)));
+        }
+        std::cout << MeasureKernels::implementationName()
+            << ": max. relative error of segment length: " << maxLengthError
+            << ", of projected coordinates: " << maxProjectionError << "\n";
+    }
+}
+
+static void benchmarkSynthetic()
+{
+    // A random walk with steps of typical OSM node spacing
+    constexpr size_t COUNT = 10'000'000;
+    std::mt19937 random(42);
+    std::normal_distribution<double> step(0, 3000);
+    std::vector<Coordinate> coords(COUNT);
+    Coordinate c(100'000'000, 600'000'000);
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        c = Coordinate(c.x + static_cast<int32_t>(step(random)),
+            c.y + static_cast<int32_t>(step(random)));
+        coords[i] = c;
+    }
+
+    std::cout << "\nC library:\n";
+    Timer timer;
+    double length = 0;
+    for (size_t i = 1; i < COUNT; i++) length += Distance::metersBetween(coords[i - 1], coords[i]);
+    timer.stop("Length", COUNT);
+    std::cout << "Length: " << length << " m\n";
+
+    timer.start();
+    std::vector<double> x(COUNT);
+    std::vector<double> y(COUNT);
+    for (size_t i = 0; i < COUNT; i++) projectReference(coords[i], x[i], y[i]);
+    timer.stop("Sinusoidal projection", COUNT);
+
+    for (MeasureKernels::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!MeasureKernels::select(impl)) continue;
+        std::cout << "\n" << MeasureKernels::implementationName() << ":\n";
+        timer.start();
+        length = MeasureKernels::length(coords.data(), COUNT);
+        timer.stop("Length", COUNT);
+        std::cout << "Length: " << length << " m\n";
+
+        timer.start();
+        MeasureKernels::projectSinusoidal(coords.data(), COUNT, x.data(), y.data());
+        timer.stop("Sinusoidal projection", COUNT);
+
+        timer.start();
+        double sum = MeasureKernels::shoelace(coords.data(), COUNT, coords[0].x);
+        timer.stop("Shoelace", COUNT);
+        std::cout << "Sum: " << sum << "\n";
+    }
+}
+
+static void benchmarkGol(const char* golFile, const char* query)
+{
+    Features world(golFile);
+    Features features = world(query);
+    for (MeasureKernels::Implementation impl : IMPLEMENTATIONS)
+    {
+        if (!MeasureKernels::select(impl)) continue;
+        std::cout << "\n" << golFile << ", " << MeasureKernels::implementationName() << ":\n";
+        Timer timer;
+        double length = features.length();
+        timer.stop("Features::length()");
+        std::cout << length << " m\n";
+        timer.start();
+        double area = features.area();
+        timer.stop("Features::area()");
+        std::cout << area << " m2\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    checkAccuracy();
+    benchmarkSynthetic();
+    if (argc > 1) benchmarkGol(argv[1], argc > 2 ? argv[2] : "w");
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <geodesk/geodesk.h>
+#include <geodesk/geom/polygon/Polygonizer.h>
+
+using namespace geodesk;
+
+// Measures ring assembly (Polygonizer::createRings() and
+// assignAndMergeHoles()) for the area relations with the most members
+// (typically large forests, wetlands and lakes with thousands of
+// outer and inner rings):
+//
+//   polygonizer-bench <gol> [<relation count>] [<query>]
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    void start()
+    {
+        start_ = std::chrono::high_resolution_clock::now();
+    }
+
+    double stop()
+    {
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start_;
+        return duration.count();
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+struct Candidate
+{
+    FeatureStore* store;
+    RelationPtr relation;
+    uint64_t memberCount;
+};
+
+static const int RUNS = 5;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: polygonizer-bench <gol> [<relation count>] [<query>]\n";
+        return 1;
+    }
+    size_t relationCount = argc > 2 ? std::stoul(argv[2]) : 20;
+    const char* query = argc > 3 ? argv[3] : "a[type=multipolygon]";
+
+    Features world(argv[1]);
+    std::vector<Candidate> candidates;
+    for (Feature f : world(query))
+    {
+        if (!f.isRelation()) continue;
+        candidates.push_back({ f.store(), RelationPtr(f.ptr()), f.members().count() });
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b)
+        {
+            return a.memberCount > b.memberCount;
+        });
+    if (candidates.size() > relationCount) candidates.resize(relationCount);
+
+    double totalCreate = 0;
+    double totalAssign = 0;
+    for (const Candidate& c : candidates)
+    {
+        double create = 0;
+        double assign = 0;
+        for (int i = 0; i < RUNS; i++)
+        {
+            Timer timer;
+            Polygonizer polygonizer;
+            polygonizer.createRings(c.store, c.relation);
+            create += timer.stop();
+            timer.start();
+            polygonizer.assignAndMergeHoles();
+            assign += timer.stop();
+        }
+        create /= RUNS;
+        assign /= RUNS;
+        totalCreate += create;
+        totalAssign += assign;
+        std::cout << "relation/" << c.relation.id() << " (" << c.memberCount
+            << " members): createRings " << create * 1000
+            << " ms, assignAndMergeHoles " << assign * 1000 << " ms\n";
+    }
+    std::cout << "Total: createRings " << totalCreate * 1000
+        << " ms, assignAndMergeHoles " << totalAssign * 1000 << " ms\n";
+    return 0;
+}
@@ -0,0 +1,23 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+namespace clarisma {
+
+/**
+ * Runtime checks for optional instruction sets, used to select
+ * SIMD implementations of kernels.
+ */
+class CpuFeatures
+{
+public:
+	/**
+	 * Returns true if the CPU supports AVX2, and the OS preserves
+	 * the YMM registers across context switches. Always false on
+	 * platforms other than x86-64.
+	 */
+	static bool hasAvx2();
+};
+
+} // namespace clarisma
@@ -2,9 +2,11 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #pragma once
+#include <exception>
 #include <sstream>
 #include <thread>
 #include <string>
+#include <vector>
 
 namespace clarisma {
 
@@ -16,5 +18,49 @@ namespace Threads
 		ss << std::this_thread::get_id();
 		return ss.str();
 	}
+
+	/**
+	 * Calls `func(i)` for each `i` in [0, threadCount), each on its
+	 * own thread (`func(0)` runs on the calling thread), and waits
+	 * for all calls to finish. If any of them throws, the exception
+	 * of the lowest-numbered call is rethrown on the calling thread
+	 * (once all threads have been joined).
+	 */
+	template<typename Func>
+	void runInParallel(size_t threadCount, Func&& func)
+	{
+		if (threadCount == 0) threadCount = 1;
+		std::vector<std::exception_ptr> errors(threadCount);
+		auto run = [&func, &errors](size_t i)
+		{
+			try
+			{
+				func(i);
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount - 1);
+		try
+		{
+			for (size_t i = 1; i < threadCount; i++) threads.emplace_back(run, i);
+		}
+		catch (...)
+		{
+			// Couldn't start a thread: wait for the ones that did start
+			for (std::thread& thread : threads) thread.join();
+			throw;
+		}
+		run(0);
+		for (std::thread& thread : threads) thread.join();
+		for (const std::exception_ptr& error : errors)
+		{
+			if (error) std::rethrow_exception(error);
+		}
+	}
 }
 } // namespace clarisma
@@ -242,6 +242,14 @@ public:
 	void formatUnsignedInt(uint64_t v);
 	void formatDouble(double d, int precision = 15, bool zeroFill = false);
 
+	/**
+	 * Writes a fixed-point number, given as an integer in units of
+	 * 10^-precision (e.g. 1234567 with precision 3 is written as
+	 * 1234.567). Avoids the floating-point work of formatDouble()
+	 * for values that have already been scaled and rounded.
+	 */
+	void formatFixed(int64_t scaled, int precision, bool zeroFill = false);
+
 	void writeJsonEscapedString(const char* s, size_t len);
 	void writeJsonEscapedString(std::string_view sv)
 	{
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+///
+/// \cond lowlevel
+///
+
+/**
+ * Bulk decoder for the coordinates of a way, which are stored as
+ * pairs of zigzag-encoded varints that hold the delta to the
+ * preceding coordinate.
+ *
+ * The SSSE3 implementation follows the masked-VByte approach: It
+ * loads 16 bytes at a time, gathers their continuation bits into a
+ * mask, and uses the low 12 bits of this mask to look up a shuffle
+ * pattern that spreads the next four varints (two coordinates) into
+ * separate 32-bit lanes. Once the 7-bit groups are merged and the
+ * values are zigzag-decoded, a prefix sum turns the deltas into
+ * coordinates. Four varints that don't all fit into 3 bytes (deltas
+ * of more than 2^20 units) are decoded by the scalar code, which also
+ * handles the tail of the run (the vector code never reads past the
+ * encoded coordinates).
+ */
+class CoordinateDecoder
+{
+public:
+    enum class Implementation
+    {
+        SCALAR,
+        SSSE3
+    };
+
+    /**
+     * Decodes `count` coordinates into `out`.
+     *
+     * @param p     pointer to the first encoded delta
+     * @param count the number of coordinates to decode
+     * @param prev  the coordinate to which the first delta is applied
+     * @param out   the array that receives the coordinates
+     * @return a pointer to the byte following the last decoded delta
+     */
+    static const uint8_t* decode(const uint8_t* p, size_t count,
+        Coordinate prev, Coordinate* out)
+    {
+        return dispatch().decode(p, count, prev, out);
+    }
+
+    static Implementation implementation() { return dispatch().implementation; }
+    static const char* implementationName();
+
+    /**
+     * Forces the use of the given implementation (if the CPU supports
+     * it), for benchmarking and testing. Not thread-safe.
+     *
+     * @return true if the implementation is supported
+     */
+    static bool select(Implementation impl);
+
+private:
+    struct Dispatch
+    {
+        const uint8_t* (*decode)(const uint8_t*, size_t, Coordinate, Coordinate*);
+        Implementation implementation;
+    };
+
+    static Dispatch& dispatch();
+};
+
+// \endcond
+} // namespace geodesk
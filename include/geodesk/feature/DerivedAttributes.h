@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <clarisma/io/ExpandableMappedFile.h>
+#include <geodesk/feature/FeaturePtr.h>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+class FeatureStore;
+class Features;
+
+///
+/// \cond lowlevel
+///
+
+/**
+ * A memory-mapped sidecar file that holds precomputed measurements
+ * of all ways and relations of a GOL: their area, length, centroid
+ * and label point. Once attached to a FeatureStore (see
+ * FeatureStore::openDerivedAttributes()), Feature::area(), length(),
+ * centroid() and labelPoint() read their results from the sidecar
+ * instead of computing them (which, for relations, requires
+ * assembling their geometry).
+ *
+ * Like IndexFile, the sidecar is a dense array keyed by ID (ways
+ * first, then relations), with fixed-size records. Records are 32
+ * bytes, so no record straddles a 1-GB segment boundary. A record
+ * whose centroid is (0,0) is treated as missing (as is any ID beyond
+ * the range of the file), in which case the accessors fall back to
+ * computing the value.
+ *
+ * The header records the GUID of the GOL for which the sidecar
+ * was built; opening it for a different GOL fails.
+ */
+class DerivedAttributes : protected clarisma::ExpandableMappedFile
+{
+public:
+	struct Record
+	{
+		double area;
+		double length;
+		Coordinate centroid;
+		Coordinate labelPoint;
+	};
+
+	static_assert(sizeof(Record) == 32);
+
+	DerivedAttributes() = default;
+	~DerivedAttributes();
+
+	/**
+	 * Opens the sidecar (read-only) for the given store.
+	 *
+	 * @throws clarisma::IOException if the file cannot be opened,
+	 *   or was built for a different GOL
+	 */
+	void open(FeatureStore* store, const char* fileName);
+
+	/**
+	 * Returns the record for the given way or relation, or `nullptr`
+	 * if the sidecar doesn't have one (or the feature is a node).
+	 */
+	const Record* get(FeaturePtr feature) const
+	{
+		if (feature.isNode()) return nullptr;
+		uint64_t id = feature.id();
+		uint64_t ofs;
+		if (feature.isWay())
+		{
+			if (id >= wayCount_) return nullptr;
+			ofs = RECORDS_OFS + id * sizeof(Record);
+		}
+		else
+		{
+			if (id >= relationCount_) return nullptr;
+			ofs = RECORDS_OFS + (wayCount_ + id) * sizeof(Record);
+		}
+		const Record* rec = reinterpret_cast<const Record*>(mainMapping() + ofs);
+		return rec->centroid.isNull() ? nullptr : rec;
+	}
+
+	/**
+	 * Computes the derived attributes of all ways and relations in
+	 * `features` and writes them to a new sidecar file. Features are
+	 * fetched in batches, and each batch is measured by all available
+	 * threads.
+	 */
+	static void build(const Features& features, const char* fileName);
+
+private:
+	static constexpr uint32_t MAGIC = 0x44524147;	// "GARD"
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint64_t RECORDS_OFS = 4096;
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint8_t guid[16];
+		uint64_t wayCount;
+		uint64_t relationCount;
+	};
+
+	uint64_t wayCount_ = 0;
+	uint64_t relationCount_ = 0;
+};
+
+// \endcond
+
+} // namespace geodesk
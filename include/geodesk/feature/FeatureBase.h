@@ -13,8 +13,10 @@
 #include <geodesk/geom/Area.h>
 #include <geodesk/geom/Box.h>
 #include <geodesk/geom/Centroid.h>
+#include <geodesk/geom/LabelPoint.h>
 #include <geodesk/geom/Length.h>
 #include <geodesk/geom/Mercator.h>
+#include <geodesk/geom/Simplifier.h>
 
 #ifdef GEODESK_WITH_GEOS
 #include <geos_c.h>
@@ -323,17 +325,42 @@ public:
     [[nodiscard]] Coordinate centroid() const
     {
         if (isNode()) return xy();
+        if (const DerivedAttributes::Record* derived = derivedAttributes())
+        {
+            return derived->centroid;
+        }
         if (isWay()) return Centroid::ofWay(WayPtr(feature_.ptr));
         assert(isRelation());
         return Centroid::ofRelation(store_.ptr(), RelationPtr(feature_.ptr));
     }
 
+    /// Calculates a point that is suitable for placing a label:
+    /// For areas, it always lies inside the area; for linestrings,
+    /// it is the point halfway along the line.
+    ///
+    /// @return the Feature's label point (in Mercator projection)
+    /// @throws QueryException if one or more tiles that contain
+    ///   the geometry of a Relation are missing
+    [[nodiscard]] Coordinate labelPoint() const
+    {
+        if (isNode()) return xy();
+        if (const DerivedAttributes::Record* derived = derivedAttributes())
+        {
+            return derived->labelPoint;
+        }
+        return LabelPoint::ofFeature(store(), ptr());
+    }
+
     /// @brief Measures the area of a feature
     ///
     /// @return area (in square meters), or `0` if the feature is not polygonal
     [[nodiscard]] double area() const
     {
         if(!isArea()) return 0;
+        if (const DerivedAttributes::Record* derived = derivedAttributes())
+        {
+            return derived->area;
+        }
         if(isWay()) return Area::ofWay(WayPtr(ptr()));
         assert(isRelation());
         return Area::ofRelation(store(), RelationPtr(ptr()));
@@ -344,11 +371,26 @@ public:
     /// @return length (in meters), or `0` if the feature is not lineal
     [[nodiscard]] double length() const
     {
+        if (const DerivedAttributes::Record* derived = derivedAttributes())
+        {
+            return derived->length;
+        }
         if(isWay()) return Length::ofWay(WayPtr(ptr()));
         if(isRelation()) return Length::ofRelation(store(), RelationPtr(ptr()));
         return 0;
     }
 
+    /// @brief Simplifies the geometry of a feature.
+    ///
+    /// @return the simplified coordinate sequences (in Mercator
+    ///   projection); see Simplifier::simplifyFeature()
+    [[nodiscard]] std::vector<std::vector<Coordinate>> simplified(
+        const Simplifier& simplifier) const
+    {
+        if (isNode()) return { { xy() } };
+        return simplifier.simplifyFeature(store(), ptr());
+    }
+
     #ifdef GEODESK_WITH_GEOS
     [[nodiscard]] GEOSGeometry* toGeometry(GEOSContextHandle_t geosContext) const;
     #endif
@@ -381,6 +423,15 @@ public:
     /// @}
 
 private:
+    /// Returns the precomputed measurements of this way or relation,
+    /// or `nullptr` if the store has no sidecar (or no record for it)
+    const DerivedAttributes::Record* derivedAttributes() const
+    {
+        if (isNode()) return nullptr;
+        const DerivedAttributes* derived = store()->derivedAttributes();
+        return derived ? derived->get(ptr()) : nullptr;
+    }
+
     enum class ExtendedFeatureType
     {
         NODE = 0,
@@ -10,10 +10,14 @@
 #include <clarisma/store/BlobStore.h>
 #include <clarisma/thread/ThreadPool.h>
 #include <geodesk/export.h>
+#include <geodesk/feature/DerivedAttributes.h>
 #include <geodesk/feature/Key.h>
 #include <geodesk/feature/StringTable.h>
+#include <geodesk/geom/index/MCIndexCache.h>
+#include <geodesk/geom/polygon/RingCache.h>
 #include <geodesk/match/Matcher.h>
 #include <geodesk/match/MatcherCompiler.h>
+#include <geodesk/query/TileKeySummaries.h>
 #include <geodesk/query/TileQueryTask.h>
 
 class PyFeatures;       // not namespaced for now
@@ -87,6 +91,63 @@ public:
 
     clarisma::ThreadPool<TileQueryTask>& executor() { return executor_; }
 
+    /**
+     * Enables per-leaf key summaries, which let queries for indexed
+     * keys skip index branches and leaves that contain no feature with
+     * any of the queried keys. Summaries are built lazily for each tile
+     * and kept in a memory-bounded LRU cache (see TileKeySummaries).
+     * May be called at any time; a budget of 0 disables them.
+     */
+    void enableKeySummaries(size_t maxBytes = TileKeySummaries::DEFAULT_MAX_BYTES)
+    {
+        keySummaries_.setMaxBytes(maxBytes);
+    }
+
+    TileKeySummaries& keySummaries() { return keySummaries_; }
+
+    /**
+     * The prepared indexes of features used by spatial filters
+     * (e.g. `within(feature)`), which are cached only once
+     * enableIndexCache() has been called.
+     */
+    MCIndexCache& indexCache() { return indexCache_; }
+
+    void enableIndexCache(size_t maxBytes = MCIndexCache::DEFAULT_MAX_BYTES)
+    {
+        indexCache_.setMaxBytes(maxBytes);
+    }
+
+    /**
+     * The assembled rings of area relations (see RingCache), which
+     * are cached only once enableRingCache() has been called.
+     */
+    RingCache& ringCache() { return ringCache_; }
+
+    void enableRingCache(size_t maxBytes = RingCache::DEFAULT_MAX_BYTES)
+    {
+        ringCache_.setMaxBytes(maxBytes);
+    }
+
+    /**
+     * Attaches a sidecar file with the precomputed area, length,
+     * centroid and label point of all ways and relations (see
+     * DerivedAttributes::build()). Must be called before the
+     * store is used by multiple threads.
+     */
+    void openDerivedAttributes(const char* fileName)
+    {
+        std::unique_ptr<DerivedAttributes> derived(new DerivedAttributes());
+        derived->open(this, fileName);
+        derivedAttributes_ = std::move(derived);
+    }
+
+    const DerivedAttributes* derivedAttributes() const
+    {
+        return derivedAttributes_.get();
+    }
+
+    const uint8_t* guid() const { return getRoot()->guid; }
+
     DataPtr fetchTile(Tip tip);
 
 protected:
@@ -127,6 +188,10 @@ private:
         // requires a FeatureStore
     #endif
     clarisma::ThreadPool<TileQueryTask> executor_;
+    TileKeySummaries keySummaries_;
+    MCIndexCache indexCache_;
+    RingCache ringCache_;
+    std::unique_ptr<DerivedAttributes> derivedAttributes_;
     uint32_t zoomLevels_;
 };
 
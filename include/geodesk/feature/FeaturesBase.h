@@ -4,6 +4,7 @@
 #pragma once
 
 #include <optional>
+#include <span>
 #include <geodesk/filter/Filters.h>
 #include <geodesk/feature/FeatureUtils.h>
 #include <geodesk/feature/QueryException.h>
@@ -194,6 +195,21 @@ public:
         return {view_.withFilter(Filters::maxMetersFrom(distance, xy))};
     }
 
+    /// @brief Only features whose closest point lies within
+    /// `distance` meters of the geometry of the given Feature
+    /// (features that intersect it have a distance of zero).
+    ///
+    /// @param distance the maximum distance (in meters)
+    /// @param feature the Feature to measure from
+    ///
+    /// @throws QueryException if one or more tiles that contain
+    ///   the geometry of a Relation are missing
+    ///
+    [[nodiscard]] FeaturesBase maxMetersFrom(double distance, const Feature& feature) const
+    {
+        return {view_.withFilter(Filters::maxMetersFrom(distance, feature))};
+    }
+
     /// @brief Only features whose closest point lies within
     /// `distance` meters of the given location.
     ///
@@ -207,6 +223,103 @@ public:
             Coordinate::ofLonLat(lon, lat)))};
     }
 
+    /// @brief Returns the `k` features that lie closest to `xy`,
+    /// ordered by distance.
+    ///
+    /// Features are only read as far as needed, so this is much
+    /// cheaper than retrieving all features within a guessed
+    /// radius and sorting them.
+    ///
+    /// @param xy the point to measure from
+    /// @param k the maximum number of features to return
+    /// @return pairs of feature and its distance (in meters) from `xy`,
+    ///   closest first (areas that contain `xy` have distance 0)
+    ///
+    [[nodiscard]] std::vector<std::pair<T,double>> nearest(Coordinate xy, size_t k) const;
+
+    /// @brief For each of the given points, finds the areas in this
+    /// set that contain it.
+    ///
+    /// This is much faster than calling containing() for each point,
+    /// as the geometry of each area is only prepared once, and the
+    /// points are resolved in parallel. For example, to assign
+    /// coordinates to admin areas, call this method on a set such as
+    /// `world("a[boundary=administrative][admin_level=2,4,6,8]")`.
+    ///
+    /// Areas are bucketed by their `admin_level` tag: for each point,
+    /// only the smallest containing area of each level is returned.
+    /// Areas without an `admin_level` are always returned.
+    ///
+    /// @param points the points to locate
+    /// @return for each point (in the same order), the areas that
+    ///   contain it (or whose boundary it lies on), one per admin
+    ///   level, from the largest area to the smallest
+    ///
+    [[nodiscard]] std::vector<std::vector<T>> locate(std::span<const Coordinate> points) const;
+
+    /// @brief Returns all pairs of features from this set and
+    /// `other` that intersect.
+    ///
+    /// Much faster than calling intersecting() for each feature
+    /// (see SpatialJoin).
+    ///
+    template<typename U>
+    [[nodiscard]] std::vector<std::pair<T,U>> joinIntersecting(
+        const FeaturesBase<U>& other) const;
+
+    /// @brief Returns all pairs of features where the feature from
+    /// this set lies within the feature from `other` (e.g. every
+    /// building along with the landuse area it lies in).
+    ///
+    template<typename U>
+    [[nodiscard]] std::vector<std::pair<T,U>> joinWithin(
+        const FeaturesBase<U>& other) const;
+
+    /// @brief Returns all pairs of features where the feature from
+    /// this set contains the feature from `other`.
+    ///
+    template<typename U>
+    [[nodiscard]] std::vector<std::pair<T,U>> joinContaining(
+        const FeaturesBase<U>& other) const;
+
+    /// @brief Returns all pairs of features that lie within the given
+    /// distance of each other (e.g. every shop within 50 meters of
+    /// a station).
+    ///
+    /// @param distance the maximum distance (in meters)
+    /// @param other the features to measure from
+    ///
+    template<typename U>
+    [[nodiscard]] std::vector<std::pair<T,U>> joinMaxMetersFrom(
+        double distance, const FeaturesBase<U>& other) const;
+
+    /// @}
+    /// @name Ordering
+    /// @{
+
+    /// @brief Returns the same features, ordered along the Hilbert
+    /// curve (by the center of their bounding box, or the location
+    /// of a node), so features that lie close to each other are
+    /// returned close together (e.g. for rendering tiles, or to keep
+    /// joins cache-friendly).
+    ///
+    /// The order is computed while the query runs: Tiles are searched
+    /// in order of the lowest Hilbert distance of any feature they
+    /// may contain, the results of each tile are sorted by the worker
+    /// threads, and the sorted results are merged as they are
+    /// iterated. A feature is returned as soon as no tile that is
+    /// still being searched can yield a feature ahead of it, so
+    /// iteration starts before the whole query has run, and only
+    /// the results of completed tiles are held in memory. Only
+    /// affects features retrieved by bounding box, type and tags
+    /// (the members of a relation and the nodes of a way keep
+    /// their order).
+    ///
+    [[nodiscard]] FeaturesBase sortedByHilbert() const
+    {
+        return { view_.sortedByHilbert() };
+    }
+
     /// @}
     /// @name Topological filters
     /// @{
@@ -285,6 +398,7 @@ protected:
     friend class FeatureBase<NodePtr>;
     friend class FeatureBase<WayPtr>;
     friend class FeatureBase<RelationPtr>;
+    template<typename> friend class FeaturesBase;
     friend class Features;
     friend class Nodes;
     friend class Ways;
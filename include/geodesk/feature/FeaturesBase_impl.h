@@ -5,6 +5,9 @@
 
 #include <geodesk/feature/FeaturesBase.h>
 #include <geodesk/feature/FeatureIterator.h>
+#include <geodesk/query/NearestQuery.h>
+#include <geodesk/query/PointLocator.h>
+#include <geodesk/query/SpatialJoin.h>
 
 // \cond
 
@@ -70,6 +73,89 @@ template<typename T>
     return total;
 }
 
+template<typename T>
+[[nodiscard]] std::vector<std::pair<T,double>> FeaturesBase<T>::nearest(
+    Coordinate xy, size_t k) const
+{
+    NearestQuery query(view_, xy);
+    std::vector<std::pair<Feature,double>> found = query.search(k);
+    std::vector<std::pair<T,double>> results;
+    results.reserve(found.size());
+    for(const auto& [feature, distance] : found)
+    {
+        results.emplace_back(T(feature), distance);
+    }
+    return results;
+}
+
+template<typename T>
+[[nodiscard]] std::vector<std::vector<T>> FeaturesBase<T>::locate(
+    std::span<const Coordinate> points) const
+{
+    PointLocator locator(view_);
+    std::vector<std::vector<uint32_t>> found = locator.locate(points);
+    const std::vector<Feature>& areas = locator.areas();
+    std::vector<std::vector<T>> results(found.size());
+    for(size_t i = 0; i < found.size(); i++)
+    {
+        results[i].reserve(found[i].size());
+        for(uint32_t n : found[i]) results[i].emplace_back(T(areas[n]));
+    }
+    return results;
+}
+
+namespace detail {
+
+template<typename T, typename U>
+std::vector<std::pair<T,U>> spatialJoin(const View& left, const View& right,
+    SpatialJoin::Predicate predicate, double meters = 0)
+{
+    SpatialJoin join(left, right, predicate, meters);
+    std::vector<std::pair<Feature,Feature>> found = join.run();
+    std::vector<std::pair<T,U>> results;
+    results.reserve(found.size());
+    for(const auto& [a, b] : found)
+    {
+        results.emplace_back(T(a), U(b));
+    }
+    return results;
+}
+
+} // namespace detail
+
+template<typename T>
+template<typename U>
+[[nodiscard]] std::vector<std::pair<T,U>> FeaturesBase<T>::joinIntersecting(
+    const FeaturesBase<U>& other) const
+{
+    return detail::spatialJoin<T,U>(view_, other.view_, SpatialJoin::Predicate::INTERSECTS);
+}
+
+template<typename T>
+template<typename U>
+[[nodiscard]] std::vector<std::pair<T,U>> FeaturesBase<T>::joinWithin(
+    const FeaturesBase<U>& other) const
+{
+    return detail::spatialJoin<T,U>(view_, other.view_, SpatialJoin::Predicate::WITHIN);
+}
+
+template<typename T>
+template<typename U>
+[[nodiscard]] std::vector<std::pair<T,U>> FeaturesBase<T>::joinContaining(
+    const FeaturesBase<U>& other) const
+{
+    return detail::spatialJoin<T,U>(view_, other.view_, SpatialJoin::Predicate::CONTAINS);
+}
+
+template<typename T>
+template<typename U>
+[[nodiscard]] std::vector<std::pair<T,U>> FeaturesBase<T>::joinMaxMetersFrom(
+    double distance, const FeaturesBase<U>& other) const
+{
+    return detail::spatialJoin<T,U>(view_, other.view_,
+        SpatialJoin::Predicate::MAX_DISTANCE, distance);
+}
+
 template<typename T>
 [[nodiscard]] FeaturesBase<T>::operator std::vector<T>() const
 {
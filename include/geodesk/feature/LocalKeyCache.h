@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <geodesk/export.h>
+#include <clarisma/util/ShortVarString.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * Speeds up repeated lookups of the same uncommon (local) key across
+ * many features, e.g. `name:de` or `addr:unit`.
+ *
+ * Local keys are stored as strings that are usually shared by all
+ * tag tables of the same tile, so most tag tables refer to the same
+ * few key-string addresses. LocalKeyCache remembers, for each key
+ * string it has seen, whether it equals the requested key; a repeated
+ * address is resolved with a single pointer comparison, without
+ * touching the key string at all.
+ *
+ * The cache stays correct even if a tile stores several copies of
+ * the same string (each copy is simply resolved once). It is not
+ * threadsafe; lookups via Tags, Feature or TagTablePtr::getKeyValue()
+ * use the caches of the calling thread (see forKey()).
+ */
+class GEODESK_API LocalKeyCache
+{
+public:
+    LocalKeyCache() : LocalKeyCache(std::string_view()) {}
+
+    explicit LocalKeyCache(std::string_view key) :
+        key_(key),
+        epoch_(epoch())
+    {
+        clear();
+    }
+
+    std::string_view key() const noexcept { return key_; }
+
+    /**
+     * Discards all memoized key strings. Must be called if the
+     * FeatureStore in which they reside is closed.
+     */
+    void clear() noexcept
+    {
+        memset(entries_, 0, sizeof(entries_));
+    }
+
+    bool matches(const clarisma::ShortVarString* keyString) noexcept
+    {
+        Entry& entry = entries_[slot(keyString)];
+        if (entry.keyString == keyString) return entry.matches;
+        entry.keyString = keyString;
+        entry.matches = keyString->equals(key_.data(), key_.size());
+        return entry.matches;
+    }
+
+    static size_t slot(const void* p) noexcept
+    {
+        // Fibonacci hashing of the address (strings are at least
+        // 2-byte aligned in practice, so we drop the lowest bit)
+        uint64_t h = (reinterpret_cast<uintptr_t>(p) >> 1) * 0x9E37'79B9'7F4A'7C15ULL;
+        return static_cast<size_t>(h >> (64 - SLOT_BITS));
+    }
+
+    /**
+     * Returns the calling thread's cache for the given key. Each thread
+     * keeps caches for its RECENT_KEYS most recently requested keys;
+     * the caches are cleared once any FeatureStore has been closed
+     * since they were last used.
+     */
+    static LocalKeyCache& forKey(std::string_view key);
+
+    /**
+     * Marks the key strings memoized by the per-thread caches as
+     * stale. Called whenever a FeatureStore is closed, as its memory
+     * may be reused by another store.
+     */
+    static void invalidateAll() noexcept
+    {
+        currentEpoch_.fetch_add(1, std::memory_order_release);
+    }
+
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int RECENT_KEYS = 4;
+
+private:
+    struct Entry
+    {
+        const clarisma::ShortVarString* keyString;
+        bool matches;
+    };
+
+    static uint64_t epoch() noexcept
+    {
+        return currentEpoch_.load(std::memory_order_acquire);
+    }
+
+    std::string key_;
+    uint64_t epoch_;        // the epoch in which entries_ were memoized
+    Entry entries_[1 << SLOT_BITS];
+
+    static std::atomic<uint64_t> currentEpoch_;
+};
+
+// \endcond
+
+} // namespace geodesk
@@ -64,6 +64,12 @@ public:
 		return currentRoleStr_;
 	}
 
+	/**
+	 * Returns the global-string code of the current member's role,
+	 * or -1 if the role is a local string.
+	 */
+	int currentRoleCode() const { return currentRoleCode_; }
+
 	#ifdef GEODESK_PYTHON
 	/**
 	 * Obtains a borrowed reference to the Python string object that
@@ -24,6 +24,8 @@ class PyTagIterator;
 
 namespace geodesk {
 
+class LocalKeyCache;
+
 /// \cond lowlevel
 
 /*
@@ -75,6 +77,7 @@ public:
 	TagBits getKeyValue(Key key) const;
 	TagBits getGlobalKeyValue(int keyCode) const;
 	TagBits getLocalKeyValue(const char* key, size_t len) const;
+	TagBits getLocalKeyValue(LocalKeyCache& key) const;
 	bool hasLocalKeys() const
 	{
 		return taggedPtr_.flags();
@@ -139,6 +142,9 @@ public:
 private:
 	explicit TagTablePtr(TaggedPtr<const uint8_t,1> taggedPtr) : taggedPtr_(taggedPtr) {}
 
+	template<typename Match>
+	TagBits findLocalKey(Match match) const;
+
 	static int valueType(TagBits value) noexcept
 	{
 		return static_cast<int>(value) & 3;
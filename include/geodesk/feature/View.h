@@ -42,6 +42,11 @@ class GEODESK_API View
         BOUNDS_ACTIVE = 2,
         USES_MATCHER = 4,
         USES_FILTER = 8,        // TODO: is this used?
+        /**
+         * Features are returned in Hilbert order (only applies to
+         * WORLD selection).
+         */
+        SORTED_BY_HILBERT = 16,
 
         // TODO: need flag to indicate if relatedFeature is in use
         // or does NOT USES_BOUNDS imply use of relatedFeature?
@@ -240,6 +245,11 @@ public:
         return flags_ & (USES_MATCHER | USES_FILTER);
     }
 
+    bool isSortedByHilbert() const noexcept
+    {
+        return flags_ & SORTED_BY_HILBERT;
+    }
+
     /* // TODO: bad?
     View& operator=(const View& other)
     {
@@ -400,6 +410,15 @@ public:
     }
 
 
+    View sortedByHilbert() const
+    {
+        store_->addref();
+        matcher_->addref();
+        if (filter_) filter_->addref();
+        return View(view_, flags_ | SORTED_BY_HILBERT, types_, store_,
+            context_, matcher_, filter_);
+    }
+
     View empty() const
     {
         store_->addref();
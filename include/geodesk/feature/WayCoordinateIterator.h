@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 #include <geodesk/feature/WayPtr.h>
 
 namespace geodesk {
@@ -25,6 +28,73 @@ public:
     void start(FeaturePtr way, int flags);
     Coordinate next();
 
+    /**
+     * Decodes up to `maxCount` of the remaining coordinates (including
+     * the duplicated first coordinate of an area) into `coords`, using
+     * CoordinateDecoder. Calls to nextBatch() and next() can be mixed.
+     *
+     * @return the number of coordinates written (0 once all
+     *   coordinates have been read)
+     */
+    int nextBatch(Coordinate* coords, int maxCount);
+
+    /**
+     * A suitable number of coordinates to request from nextBatch()
+     * at a time (small enough to fit a buffer on the stack)
+     */
+    static constexpr int BATCH_SIZE = 64;
+
+    /**
+     * Decodes the remaining coordinates in batches of up to BATCH_SIZE
+     * and calls `func(const Coordinate* coords, int count)` for each.
+     * Each batch starts with the last `Overlap` coordinates of the
+     * previous one (1 to process segments, 2 for vertex triples), so
+     * every segment is seen exactly once. Batches with no more than
+     * `Overlap` coordinates are skipped. If `func` returns a `bool`,
+     * `true` stops the iteration.
+     *
+     * @return true if `func` stopped the iteration
+     */
+    template<int Overlap = 1, typename Func>
+    bool forEachSegmentBatch(Func&& func)
+    {
+        return forEachSegmentBatch<Overlap>(
+            [this](Coordinate* coords, int maxCount)
+            {
+                return nextBatch(coords, maxCount);
+            },
+            std::forward<Func>(func));
+    }
+
+    /**
+     * Same as above, but obtains the coordinates from any source
+     * with the signature of nextBatch() (e.g. the coordinates of
+     * an assembled ring).
+     */
+    template<int Overlap = 1, typename NextBatch, typename Func>
+    static bool forEachSegmentBatch(NextBatch&& nextBatch, Func&& func)
+    {
+        static_assert(Overlap >= 1 && Overlap < BATCH_SIZE);
+        Coordinate coords[BATCH_SIZE];
+        int count = nextBatch(coords, BATCH_SIZE);
+        while (count > Overlap)
+        {
+            const Coordinate* batch = coords;
+            if constexpr (std::is_same_v<
+                std::invoke_result_t<Func&, const Coordinate*, int>, bool>)
+            {
+                if (func(batch, count)) return true;
+            }
+            else
+            {
+                func(batch, count);
+            }
+            std::copy(coords + count - Overlap, coords + count, coords);
+            count = nextBatch(coords + Overlap, BATCH_SIZE - Overlap) + Overlap;
+        }
+        return false;
+    }
+
     // does not include any duplicated last coordinate
     int storedCoordinatesRemaining() const { return remaining_; }
     // This one includes any duplicate last coordinate for areas, based on flags:
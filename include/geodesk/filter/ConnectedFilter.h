@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <vector>
 #include <geodesk/filter/SpatialFilter.h>
+#include <geodesk/geom/CoordinateSet.h>
 
 namespace geodesk {
 
@@ -13,6 +15,7 @@ public:
 	ConnectedFilter(FeatureStore* store, FeaturePtr feature);
 
 	bool accept(FeatureStore* store, FeaturePtr feature, FastFilterHint fast) const override;
+	int acceptTile(Tile tile) const override;
 
 protected:
 	bool acceptWay(WayPtr way) const override;
@@ -20,11 +23,18 @@ protected:
 	bool acceptAreaRelation(FeatureStore* store, RelationPtr relation) const override;
 
 private:
-	void collectWayPoints(WayPtr way);
-	void collectMemberPoints(FeatureStore* store, RelationPtr relation, RecursionGuard& guard);
+	void collectWayPoints(WayPtr way, std::vector<Coordinate>& points);
+	void collectMemberPoints(FeatureStore* store, RelationPtr relation,
+		RecursionGuard& guard, std::vector<Coordinate>& points);
+	void collectTiles(const std::vector<Coordinate>& points);
+
+	static constexpr int MAX_ZOOM = 12;
 
 	uint64_t self_;
-	std::unordered_set<Coordinate> points_;
+	CoordinateSet points_;
+	std::vector<uint32_t> tiles_;
+		// sorted; all tiles (at any zoom level) that contain
+		// at least one of the points
 };
 
 } // namespace geodesk
@@ -13,8 +13,9 @@ namespace geodesk {
 class CrossesFilter : public PreparedSpatialFilter
 {
 public:
-	CrossesFilter(FeatureTypes accepted, const Box& bounds, MCIndex&& index) :
-		PreparedSpatialFilter(bounds, std::move(index)) 
+	CrossesFilter(FeatureTypes accepted, const Box& bounds, SharedMCIndex index,
+		SharedTileClassifier tileClassifier) :
+		PreparedSpatialFilter(bounds, std::move(index), std::move(tileClassifier))
 	{
 		flags_ |= FilterFlags::FAST_TILE_FILTER;
 		acceptedTypes_ = accepted;
@@ -36,15 +37,19 @@ class CrossesFilterFactory : public PreparedFilterFactory
 public:
 	const Filter* forPolygonal() override
 	{ 
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
 		return new CrossesFilter(FeatureTypes::ALL & 
 			~FeatureTypes::AREAS & ~FeatureTypes::NODES,
-			bounds(), buildIndex()); 
+			bounds(), std::move(index), tileClassifier(TileClassifier::Mode::AREA));
 	}
 
 	const Filter* forLineal() override
 	{ 
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
 		return new CrossesFilter(FeatureTypes::ALL & ~FeatureTypes::NODES,
-			bounds(), buildIndex());
+			bounds(), std::move(index), tileClassifier(TileClassifier::Mode::AREA));
 	}
 
 	const Filter* forNonAreaRelation(FeatureStore* store, RelationPtr rel) override
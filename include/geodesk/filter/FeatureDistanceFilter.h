@@ -0,0 +1,117 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <vector>
+#include <geodesk/filter/PreparedSpatialFilter.h>
+#include <geodesk/filter/PreparedFilterFactory.h>
+#include <geodesk/filter/PointDistanceFilter.h>
+
+namespace geodesk {
+
+/**
+ * Accepts all features that are within the given distance from a
+ * linear or polygonal geometry (i.e. that intersect its buffer),
+ * without having to construct the buffer itself: The distance of a
+ * candidate is measured directly against the segments of the prepared
+ * geometry, using the bounding boxes of its monotone chains to skip
+ * all segments that lie too far away. A candidate that lies inside a
+ * polygonal geometry (or contains it) is at distance zero.
+ *
+ * Tiles that lie entirely outside of the corridor are skipped, and
+ * the nodes of tiles that lie entirely inside a polygonal geometry
+ * are turbo-accepted.
+ *
+ * The member nodes of a non-area relation (which aren't part of the
+ * shared index of its ways) are placed into a separate index of
+ * points, which is used as the main index if the relation only has
+ * node members.
+ *
+ * The distance is converted into Mercator units at the latitude of each
+ * candidate (or candidate segment), so it is accurate for geometries
+ * that span a wide range of latitudes. The bounds and the corridor of
+ * tiles are buffered using the scale at the poleward edge, which is
+ * the largest.
+ */
+class FeatureDistanceFilter : public PreparedSpatialFilter
+{
+public:
+	/**
+	 * @param index  the index of the geometry's segments (may be
+	 *               empty if `nodes` isn't)
+	 * @param nodes  any additional points (the member nodes of a
+	 *               non-area relation)
+	 */
+	FeatureDistanceFilter(double meters, const Box& bounds,
+		SharedMCIndex index, bool isArea,
+		const std::vector<Coordinate>& nodes = {});
+
+	bool accept(FeatureStore* store, FeaturePtr feature, FastFilterHint fast) const override;
+	int acceptTile(Tile tile) const override;
+
+protected:
+	bool acceptWay(WayPtr way) const override;
+	bool acceptNode(NodePtr node) const override;
+	bool acceptAreaRelation(FeatureStore* store, RelationPtr relation) const override;
+
+	bool isPointWithinDistance(Coordinate c) const;
+	bool isSegmentWithinDistance(Coordinate start, Coordinate end) const;
+	bool areSegmentsWithinDistance(WayPtr way, int areaFlag) const;
+	static SharedMCIndex indexPoints(const std::vector<Coordinate>& points);
+
+	/**
+	 * The member nodes, if the main index holds the member ways
+	 */
+	SharedMCIndex nodeIndex_;
+
+	/**
+	 * A vertex of the indexed segments, followed by the member nodes
+	 * (used to check whether the geometry lies within a candidate area)
+	 */
+	std::vector<Coordinate> anchors_;
+	double meters_;
+	int32_t distance_;		// the largest distance in Mercator units
+	bool isArea_;
+};
+
+
+class MaxDistanceFilterFactory : public PreparedFilterFactory
+{
+public:
+	MaxDistanceFilterFactory(double meters) : meters_(meters) {}
+
+	const Filter* forPolygonal() override
+	{
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
+		return new FeatureDistanceFilter(meters_, bounds(), std::move(index), true);
+	}
+
+	const Filter* forLineal() override
+	{
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
+		return new FeatureDistanceFilter(meters_, bounds(), std::move(index), false);
+	}
+
+	const Filter* forNonAreaRelation(FeatureStore* store, RelationPtr rel) override
+	{
+		// The index holds the relation's member ways; its member
+		// nodes aren't indexed, so the filter indexes them separately
+		std::vector<Coordinate> nodes = memberNodes(store, rel);
+		SharedMCIndex index = buildIndex();
+		if (!index && nodes.empty()) return nullptr;
+		return new FeatureDistanceFilter(meters_, bounds(), std::move(index), false, nodes);
+	}
+
+	const Filter* forCoordinate(Coordinate point) override
+	{
+		return new PointDistanceFilter(meters_, point);
+	}
+
+private:
+	double meters_;
+};
+
+} // namespace geodesk
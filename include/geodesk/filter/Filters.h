@@ -20,6 +20,7 @@ public:
     static const Filter* containsPoint(Coordinate xy);
     static const Filter* crossing(Feature feature);
     static const Filter* maxMetersFrom(double meters, Coordinate xy);
+    static const Filter* maxMetersFrom(double meters, Feature feature);
 };
 
 // \endcond
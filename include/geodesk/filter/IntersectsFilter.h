@@ -18,8 +18,9 @@ namespace geodesk {
 class IntersectsPolygonFilter : public PreparedSpatialFilter
 {
 public:
-	IntersectsPolygonFilter(const Box& bounds, MCIndex&& index) :
-		PreparedSpatialFilter(bounds, std::move(index))
+	IntersectsPolygonFilter(const Box& bounds, SharedMCIndex index,
+		SharedTileClassifier tileClassifier) :
+		PreparedSpatialFilter(bounds, std::move(index), std::move(tileClassifier))
 	{
 		flags_ |= FilterFlags::FAST_TILE_FILTER;
 	}
@@ -37,8 +38,9 @@ protected:
 class IntersectsLinealFilter : public PreparedSpatialFilter
 {
 public:
-	IntersectsLinealFilter(const Box& bounds, MCIndex&& index) :
-		PreparedSpatialFilter(bounds, std::move(index)) {}
+	IntersectsLinealFilter(const Box& bounds, SharedMCIndex index,
+		SharedTileClassifier tileClassifier) :
+		PreparedSpatialFilter(bounds, std::move(index), std::move(tileClassifier)) {}
 
 	bool accept(FeatureStore* store, FeaturePtr feature, FastFilterHint fast) const override;
 
@@ -54,12 +56,18 @@ class IntersectsFilterFactory : public PreparedFilterFactory
 public:
 	const Filter* forPolygonal() override
 	{ 
-		return new IntersectsPolygonFilter(bounds(), buildIndex()); 
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
+		return new IntersectsPolygonFilter(bounds(), std::move(index),
+			tileClassifier(TileClassifier::Mode::AREA));
 	}
 
 	const Filter* forLineal() override
 	{ 
-		return new IntersectsLinealFilter(bounds(), buildIndex());
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
+		return new IntersectsLinealFilter(bounds(), std::move(index),
+			tileClassifier(TileClassifier::Mode::AREA));
 	}
 
 	const Filter* forCoordinate(Coordinate point) override
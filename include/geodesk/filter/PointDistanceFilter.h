@@ -5,6 +5,7 @@
 
 #include <geodesk/filter/SpatialFilter.h>
 #include <geodesk/geom/Mercator.h>
+#include <geodesk/geom/PointDistance.h>
 #include <geodesk/match/Matcher.h>
 
 namespace geodesk {
@@ -18,15 +19,11 @@ public:
 	PointDistanceFilter(double meters, Coordinate point);
 
 	virtual bool accept(FeatureStore* store, FeaturePtr feature, FastFilterHint fast) const;
+	int acceptTile(Tile tile) const override;
 
 private:
-	bool segmentsWithinDistance(WayPtr way, int areaFlag) const;
-	bool isWithinDistance(WayPtr way) const;
-	bool isAreaWithinDistance(FeatureStore* store, RelationPtr relation) const;
-	bool areMembersWithinDistance(FeatureStore* store, RelationPtr relation, RecursionGuard& guard) const;
-
-	Coordinate point_;
 	double distanceSquared_;
+	PointDistance distance_;	// stops once within distanceSquared_
 };
 
 } // namespace geodesk
@@ -6,8 +6,10 @@
 #ifdef GEODESK_WITH_GEOS
 #include <geos_c.h>
 #endif
+#include <vector>
 #include <geodesk/feature/RelationPtr.h>
 #include <geodesk/geom/index/MCIndexBuilder.h>
+#include <geodesk/geom/index/MCIndexCache.h>
 
 namespace geodesk {
 
@@ -23,7 +25,29 @@ public:
 	virtual const Filter* forCoordinate(Coordinate point) { return nullptr; };
 
 	const Box& bounds() const { return bounds_; }
-	MCIndex buildIndex() { return indexBuilder_.build(bounds_); }
+
+	/**
+	 * Returns the index of the feature's segments (from the store's
+	 * cache, or built from the segments collected by forFeature()),
+	 * or an empty pointer if the feature has no segments (e.g. a
+	 * relation whose members are all nodes).
+	 */
+	SharedMCIndex buildIndex();
+
+	/**
+	 * Returns the TileClassifier (in AREA or LINEAL mode) for the
+	 * index returned by buildIndex(), which must have been called
+	 * first. The classifier is shared via the store's MCIndexCache
+	 * if the index is cached.
+	 */
+	SharedTileClassifier tileClassifier(TileClassifier::Mode mode) const;
+
+	/**
+	 * Returns the coordinates of the member nodes of a non-area
+	 * relation (including those of its sub-relations), which are
+	 * not part of the index.
+	 */
+	static std::vector<Coordinate> memberNodes(FeatureStore* store, RelationPtr rel);
 
 protected:
 	virtual const Filter* forPolygonal() { return nullptr; };
@@ -46,8 +70,15 @@ protected:
 	#endif
 
 private:
+	bool useCachedIndex(FeatureStore* store, FeaturePtr feature);
+	static void collectMemberNodes(FeatureStore* store, RelationPtr rel,
+		RecursionGuard& guard, std::vector<Coordinate>& nodes);
+
 	Box bounds_;
 	MCIndexBuilder indexBuilder_;
+	SharedMCIndex index_;		// cached or built
+	FeatureStore* cacheStore_ = nullptr;
+	uint64_t cacheKey_ = 0;
 };
 
 } // namespace geodesk
@@ -4,7 +4,8 @@
 #pragma once
 
 #include <geodesk/filter/SpatialFilter.h>
-#include <geodesk/geom/index/MCIndex.h>
+#include <geodesk/geom/index/MCIndexCache.h>
+#include <geodesk/geom/index/TileClassifier.h>
 
 namespace geodesk {
 
@@ -16,7 +17,24 @@ class PreparedSpatialFilter : public SpatialFilter
 public:
 	PreparedSpatialFilter(const Box& bounds, MCIndex&& index) :
 		SpatialFilter(bounds),
-		index_(std::move(index))
+		sharedIndex_(std::make_shared<const MCIndex>(std::move(index))),
+		index_(*sharedIndex_),
+		tileClassifier_(std::make_shared<const TileClassifier>(
+			TileClassifier::Mode::AREA, bounds))
+	{
+	}
+
+	/**
+	 * Creates a filter that uses an index (and the classifier of
+	 * its tiles) which may be shared with other filters (via the
+	 * feature store's MCIndexCache).
+	 */
+	PreparedSpatialFilter(const Box& bounds, SharedMCIndex index,
+		SharedTileClassifier tileClassifier) :
+		SpatialFilter(bounds),
+		sharedIndex_(std::move(index)),
+		index_(*sharedIndex_),
+		tileClassifier_(std::move(tileClassifier))
 	{
 	}
 
@@ -27,6 +45,16 @@ protected:
 	bool anySegmentsCross(WayPtr way) const;
 	bool wayIntersectsPolygon(WayPtr way) const;
 
-	MCIndex index_;
+	/**
+	 * Same as `index_.locateBox(tile.bounds())`, but cached.
+	 */
+	int locateTile(Tile tile) const
+	{
+		return tileClassifier_->locate(index_, tile);
+	}
+
+	SharedMCIndex sharedIndex_;
+	const MCIndex& index_;
+	SharedTileClassifier tileClassifier_;
 };
 } // namespace geodesk
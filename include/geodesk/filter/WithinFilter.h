@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <vector>
 #include <geodesk/feature/RelationPtr.h>
+#include <geodesk/geom/CoordinateSet.h>
 #include <geodesk/geom/index/MCIndexBuilder.h>
 #include <geodesk/filter/PreparedSpatialFilter.h>
 #include <geodesk/filter/PreparedFilterFactory.h>
@@ -14,8 +16,9 @@ namespace geodesk {
 class WithinPolygonFilter : public PreparedSpatialFilter
 {
 public:
-	WithinPolygonFilter(const Box& bounds, MCIndex&& index) :
-		PreparedSpatialFilter(bounds, std::move(index)) 
+	WithinPolygonFilter(const Box& bounds, SharedMCIndex index,
+		SharedTileClassifier tileClassifier) :
+		PreparedSpatialFilter(bounds, std::move(index), std::move(tileClassifier))
 	{
 		flags_ |= 
 			FilterFlags::FAST_TILE_FILTER |
@@ -45,25 +48,149 @@ protected:
 };
 
 
+/**
+ * Accepts features that lie within a linear geometry (a way or the
+ * members of a non-area relation): nodes that lie on the linework (or
+ * at one of the relation's member nodes), and linear ways whose
+ * segments are fully covered by the linework. Areas cannot lie within
+ * a linear geometry.
+ */
+class WithinLinealFilter : public PreparedSpatialFilter
+{
+public:
+	WithinLinealFilter(const Box& bounds, SharedMCIndex index,
+		SharedTileClassifier tileClassifier,
+		const std::vector<Coordinate>& nodes = {});
+
+	bool accept(FeatureStore* store, FeaturePtr feature, FastFilterHint) const override;
+	int acceptTile(Tile tile) const override;
+
+protected:
+	bool acceptWay(WayPtr way) const override;
+	bool acceptNode(NodePtr node) const override;
+	bool acceptAreaRelation(FeatureStore*, RelationPtr) const override;
+
+	bool isSegmentCovered(Coordinate start, Coordinate end) const;
+
+	CoordinateSet nodes_;
+	Box nodeBounds_;
+};
+
+
+/**
+ * Accepts nodes that lie at any of the given points (and non-area
+ * relations whose members are all such nodes); used for relations
+ * whose members are all nodes.
+ */
+class WithinPointsFilter : public SpatialFilter
+{
+public:
+	WithinPointsFilter(const Box& bounds, const std::vector<Coordinate>& points) :
+		SpatialFilter(bounds)
+	{
+		flags_ |=
+			FilterFlags::FAST_TILE_FILTER |
+			FilterFlags::MUST_ACCEPT_ALL_MEMBERS |
+			FilterFlags::STRICT_BBOX;
+		points_.build(points);
+	}
+
+	bool accept(FeatureStore* store, FeaturePtr feature, FastFilterHint) const override
+	{
+		return acceptFeature(store, feature);
+	}
+
+	int acceptTile(Tile tile) const override
+	{
+		return tile.bounds().intersects(bounds_) ? 0 : -1;
+	}
+
+protected:
+	bool acceptNode(NodePtr node) const override
+	{
+		return points_.contains(node.xy());
+	}
+
+private:
+	CoordinateSet points_;
+};
+
+
+/**
+ * Accepts nodes that lie at the given point (and non-area relations
+ * whose members are all such nodes).
+ */
+class WithinPointFilter : public SpatialFilter
+{
+public:
+	WithinPointFilter(Coordinate point) :
+		SpatialFilter(Box(point)),
+		point_(point)
+	{
+		flags_ |=
+			FilterFlags::FAST_TILE_FILTER |
+			FilterFlags::MUST_ACCEPT_ALL_MEMBERS |
+			FilterFlags::STRICT_BBOX;
+	}
+
+	bool accept(FeatureStore* store, FeaturePtr feature, FastFilterHint) const override
+	{
+		return acceptFeature(store, feature);
+	}
+
+	int acceptTile(Tile tile) const override
+	{
+		return tile.bounds().contains(point_) ? 0 : -1;
+	}
+
+protected:
+	bool acceptNode(NodePtr node) const override
+	{
+		return node.xy() == point_;
+	}
+
+private:
+	Coordinate point_;
+};
+
+
 class WithinFilterFactory : public PreparedFilterFactory
 {
 public:
 	const Filter* forPolygonal() override
 	{
-		return new WithinPolygonFilter(bounds(), buildIndex());
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
+		return new WithinPolygonFilter(bounds(), std::move(index),
+			tileClassifier(TileClassifier::Mode::AREA));
 	}
 
 	const Filter* forLineal() override
 	{
-		// return new WithinLinealFilter(bounds(), buildIndex());
-		// TODO
-		return nullptr;
+		SharedMCIndex index = buildIndex();
+		if (!index) return nullptr;
+		return new WithinLinealFilter(bounds(), std::move(index),
+			tileClassifier(TileClassifier::Mode::LINEAL));
+	}
+
+	const Filter* forNonAreaRelation(FeatureStore* store, RelationPtr rel) override
+	{
+		// The index holds the relation's member ways; its member
+		// nodes aren't indexed, so we test them separately
+		std::vector<Coordinate> nodes = memberNodes(store, rel);
+		SharedMCIndex index = buildIndex();
+		if (!index)
+		{
+			if (nodes.empty()) return nullptr;
+			return new WithinPointsFilter(bounds(), nodes);
+		}
+		return new WithinLinealFilter(bounds(), std::move(index),
+			tileClassifier(TileClassifier::Mode::LINEAL), nodes);
 	}
 
 	const Filter* forCoordinate(Coordinate point) override
 	{
-		// TODO
-		return nullptr;
+		return new WithinPointFilter(point);
 	}
 };
 
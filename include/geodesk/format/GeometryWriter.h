@@ -10,12 +10,14 @@
 #include <geodesk/feature/WayPtr.h>
 #include <geodesk/feature/RelationPtr.h>
 #include <geodesk/geom/Coordinate.h>
+#include <geodesk/geom/Simplifier.h>
+#include <geodesk/geom/polygon/RingCache.h>
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 namespace geodesk {
 
-class Polygonizer;
-
 ///
 /// \cond lowlevel
 ///
@@ -31,27 +33,51 @@ public:
 		precision_ = precision;
 	}
 
+	/**
+	 * Simplifies the geometries of ways and area relations as they
+	 * are written (e.g. `Simplifier::ofZoom(12)` for the tiles of
+	 * zoom level 12). Geometries of collection relations and GEOS
+	 * geometries are written unchanged.
+	 */
+	void simplify(const Simplifier& simplifier)
+	{
+		simplifier_ = simplifier;
+	}
+
 protected:
 	void writeCoordinate(Coordinate c);
 	
 	template<typename Iter>
 	void writeCoordinates(Iter& iter)
 	{
+		// Collect the coordinates in batches, so they can be
+		// converted to lon/lat in bulk
+		Coordinate coords[COORDINATE_BATCH_SIZE];
 		bool isFirst = true;
 		writeByte(coordGroupStartChar_);
-		for (int count = iter.coordinatesRemaining(); count > 0; count--)
+		int remaining = iter.coordinatesRemaining();
+		while (remaining > 0)
 		{
-			Coordinate c = iter.next();
-			if (!isFirst) writeByte(',');  // TODO: always comma for all formats?
+			int count = std::min(remaining, COORDINATE_BATCH_SIZE);
+			for (int i = 0; i < count; i++) coords[i] = iter.next();
+			writeCoordinateSegment(isFirst, coords, count);
 			isFirst = false;
-			writeCoordinate(c);
+			remaining -= count;
 		}
 		writeByte(coordGroupEndChar_);
 	}
 
+	/**
+	 * Writes `count` coordinates, separated by commas (and preceded
+	 * by a comma unless `isFirst`). The coordinates are converted
+	 * via CoordinateTransform; for a precision of up to 7 decimal
+	 * places, they are written as fixed-point numbers without
+	 * any floating-point formatting.
+	 */
+	void writeCoordinateSegment(bool isFirst, const Coordinate* coords, size_t count);
+
 	// ==== GEOS Geometries ====
 
-	void writeCoordinateSegment(bool isFirst, const Coordinate* coords, size_t count);
 	#ifdef GEODESK_WITH_GEOS
 	void writeCoordSequence(GEOSContextHandle_t context, const GEOSCoordSequence* coords);
 	void writePointCoordinates(GEOSContextHandle_t context, const GEOSGeometry* point);
@@ -78,8 +104,18 @@ protected:
 
 	// ==== Feature Geometries ====
 
+	/**
+	 * Returns the assembled rings of an area relation (from the
+	 * store's RingCache, unless the geometries are simplified, in
+	 * which case the member ways are simplified before assembly).
+	 */
+	SharedPolygonizer rings(FeatureStore* store, RelationPtr relation) const;
+
 	void writeWayCoordinates(WayPtr way, bool group);
 	void writePolygonizedCoordinates(const Polygonizer& polygonizer);
+	void writeRingCoordinates(const Polygonizer::Ring* ring);
+
+	static constexpr int COORDINATE_BATCH_SIZE = 64;
 
 	int precision_ = 7;
 	bool latitudeFirst_ = false;
@@ -88,6 +124,8 @@ protected:
 	char coordEndChar_ = ']';
 	char coordGroupStartChar_ = '[';
 	char coordGroupEndChar_ = ']';
+	Simplifier simplifier_;
+	std::vector<Coordinate> simplified_;
 };
 
 // \endcond
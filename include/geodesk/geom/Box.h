@@ -226,6 +226,22 @@ public:
 		}
 	}
 
+	/**
+	 * Expands the box by `b` (which must not be negative) on all
+	 * sides, but unlike buffer(), clamps the x-coordinates instead of
+	 * wrapping them around the Antimeridian, so a simple box stays
+	 * simple.
+	 */
+	inline void bufferSimple(int32_t b)
+	{
+		assert(b >= 0);
+		if (isEmpty()) return;
+		m_minX = trimmedSubtract(m_minX, b);
+		m_minY = trimmedSubtract(m_minY, b);
+		m_maxX = trimmedAdd(m_maxX, b);
+		m_maxY = trimmedAdd(m_maxY, b);
+	}
+
 	Coordinate center() const
 	{
 		return Coordinate(
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * An immutable set of coordinates, optimized for fast lookups.
+ *
+ * Coordinates are packed into 64-bit values and stored in a flat
+ * open-addressing table (linear probing), which is preceded by a small
+ * Bloom filter: Most lookups in typical use (probing the vertices
+ * of candidate features) fail, and the Bloom filter rejects the
+ * majority of these without touching the much larger table.
+ *
+ * The table has a power-of-two number of slots, at least twice the
+ * number of coordinates (i.e. 2 to 4 slots per coordinate). The Bloom
+ * filter has 8 bits per slot (1/8 the size of the table, or 16 to 32
+ * bits per coordinate); it is blocked: both bits set for a coordinate
+ * lie in the same 64-bit word, so a lookup reads only a single word.
+ *
+ * The null coordinate (0,0) is used to mark empty slots; it is
+ * never a member of the set.
+ */
+class CoordinateSet
+{
+public:
+	CoordinateSet() : slotMask_(0), bloomMask_(0), count_(0) {}
+
+	/**
+	 * Fills the set with the given coordinates (duplicates and null
+	 * coordinates are ignored). Replaces any previous contents.
+	 */
+	void build(const std::vector<Coordinate>& coords);
+
+	size_t size() const { return count_; }
+	bool isEmpty() const { return count_ == 0; }
+
+	bool contains(Coordinate c) const
+	{
+		uint64_t key = static_cast<uint64_t>(static_cast<int64_t>(c));
+		if (key == 0 || count_ == 0) return false;
+		uint64_t h = hash(key);
+		uint64_t bloomBits = (1ULL << (h & 63)) | (1ULL << ((h >> 6) & 63));
+		if ((bloom_[(h >> 12) & bloomMask_] & bloomBits) != bloomBits) return false;
+		for (uint64_t slot = (h >> 32) & slotMask_; ; slot = (slot + 1) & slotMask_)
+		{
+			uint64_t v = slots_[slot];
+			if (v == key) return true;
+			if (v == 0) return false;
+		}
+	}
+
+private:
+	static uint64_t hash(uint64_t key)
+	{
+		key ^= key >> 33;
+		key *= 0xff51'afd7'ed55'8ccdULL;
+		key ^= key >> 33;
+		return key;
+	}
+
+	std::unique_ptr<uint64_t[]> slots_;
+	std::unique_ptr<uint64_t[]> bloom_;
+	uint64_t slotMask_;
+	uint64_t bloomMask_;
+	size_t count_;
+};
+
+// \endcond
+
+} // namespace geodesk
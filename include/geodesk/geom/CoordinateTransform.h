@@ -0,0 +1,99 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * Bulk conversion between Mercator coordinates and WGS-84 longitude
+ * and latitude, for arrays of coordinates (e.g. the batches decoded by
+ * WayCoordinateIterator::nextBatch()). Like MeasureKernels, there is a
+ * scalar implementation and an AVX2 implementation (on x86-64) that
+ * converts 4 coordinates at once, and both evaluate the same
+ * polynomial approximations of exp() and atan(), so results do not
+ * depend on the CPU. Latitudes match Mercator::latFromY() to within
+ * a few units in the last place; longitudes are exact.
+ *
+ * toScaledLonLat() is a fast path for output formats that write a
+ * limited number of decimal places: it returns the degrees already
+ * scaled by 10^precision and rounded (half away from zero, like
+ * std::round()) to integers, which can be written without any
+ * further floating-point work (see BufferWriter::formatFixed()).
+ */
+class CoordinateTransform
+{
+public:
+	enum class Implementation
+	{
+		SCALAR,
+		AVX2
+	};
+
+	/**
+	 * The highest precision supported by toScaledLonLat()
+	 * (7 decimal places is the resolution of OSM coordinates).
+	 */
+	static constexpr int MAX_SCALED_PRECISION = 7;
+
+	/**
+	 * Converts `count` coordinates to longitude and latitude (in degrees).
+	 */
+	static void toLonLat(const Coordinate* coords, size_t count,
+		double* lon, double* lat)
+	{
+		dispatch().toLonLat(coords, count, lon, lat);
+	}
+
+	/**
+	 * Converts `count` coordinates to longitude and latitude, in
+	 * units of 10^-precision degrees (e.g. 100-nanodegree units for
+	 * a precision of 7).
+	 *
+	 * @param precision the number of decimal places (0 to MAX_SCALED_PRECISION)
+	 */
+	static void toScaledLonLat(const Coordinate* coords, size_t count,
+		int precision, int64_t* lon, int64_t* lat)
+	{
+		dispatch().toScaledLonLat(coords, count, precision, lon, lat);
+	}
+
+	/**
+	 * Converts `count` pairs of longitude and latitude (in degrees)
+	 * to Mercator coordinates (same as Mercator::xFromLon() and
+	 * Mercator::yFromLat()).
+	 */
+	static void fromLonLat(const double* lon, const double* lat, size_t count,
+		Coordinate* coords);
+
+	static Implementation implementation() { return dispatch().implementation; }
+	static const char* implementationName();
+
+	/**
+	 * Forces the use of the given implementation (if the CPU supports
+	 * it), for benchmarking and testing. Not thread-safe.
+	 *
+	 * @return true if the implementation is supported
+	 */
+	static bool select(Implementation impl);
+
+private:
+	struct Dispatch
+	{
+		void (*toLonLat)(const Coordinate*, size_t, double*, double*);
+		void (*toScaledLonLat)(const Coordinate*, size_t, int, int64_t*, int64_t*);
+		Implementation implementation;
+	};
+
+	static Dispatch& dispatch();
+};
+
+// \endcond
+
+} // namespace geodesk
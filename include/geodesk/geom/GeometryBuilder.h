@@ -5,6 +5,7 @@
 
 #ifdef GEODESK_WITH_GEOS
 
+#include <vector>
 #include <geos_c.h>
 #include <geodesk/feature/RelationPtr.h>
 #include <geodesk/feature/WayPtr.h>
@@ -24,6 +25,22 @@ public:
 	static GEOSGeometry* buildRelationGeometry(FeatureStore *store, RelationPtr relation, GEOSContextHandle_t geosContext);
 	static GEOSGeometry* buildPointGeometry(int32_t x, int32_t y, GEOSContextHandle_t geosContext);
 	static GEOSGeometry* buildBoxGeometry(const Box& box, GEOSContextHandle_t geosContext);
+
+	/**
+	 * Creates a 2D coordinate sequence from the given coordinates.
+	 * With GEOS 3.10 or above, the sequence is copied in a single call
+	 * from a buffer of doubles; older versions of GEOS require a call
+	 * per coordinate.
+	 */
+	static GEOSCoordSequence* buildCoordSequence(const Coordinate* coords,
+		size_t count, GEOSContextHandle_t geosContext);
+
+	/**
+	 * A scratch buffer for coordinates, which is reused by all calls
+	 * on the same thread (hence must not be held across calls that
+	 * build another geometry).
+	 */
+	static std::vector<Coordinate>& coordinateBuffer();
 };
 
 
@@ -34,11 +51,21 @@ public:
 	GEOSGeometry* build();
 
 private:
+	/**
+	 * Relations with at least this many members have the geometries
+	 * of their members built in parallel
+	 */
+	static const size_t MIN_PARALLEL_MEMBERS = 256;
+	static const size_t MIN_MEMBERS_PER_THREAD = 64;
+
 	void gatherMembers(RelationPtr relation);
+	GEOSGeometry* buildMemberGeometry(FeaturePtr member, GEOSContextHandle_t context) const;
+	void buildMemberGeometries();
 
 	FeatureStore* store_;
 	GEOSContextHandle_t context_;
 	RecursionGuard guard_;
+	std::vector<FeaturePtr> members_;
 	std::vector< GEOSGeometry*> geoms_;
 };
 
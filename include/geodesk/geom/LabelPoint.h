@@ -0,0 +1,34 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <geodesk/geom/Coordinate.h>
+#include <geodesk/feature/WayPtr.h>
+#include <geodesk/feature/RelationPtr.h>
+
+namespace geodesk {
+
+/// Functions for calculating a feature's representative point
+/// (a point that is suitable for placing a label)
+///
+/// @ingroup lowlevel
+/// \cond lowlevel
+///
+/// Unlike the centroid, the label point of an area always lies inside
+/// of it: it is the midpoint of the widest interior span along the
+/// horizontal line that passes through the centroid. The label point
+/// of a linestring is the point halfway along its length. For all
+/// other features, the label point is the centroid.
+///
+class GEODESK_API LabelPoint
+{
+public:
+	static Coordinate ofWay(WayPtr way);
+	static Coordinate ofRelation(FeatureStore* store, RelationPtr relation);
+	static Coordinate ofFeature(FeatureStore* store, FeaturePtr feature);
+};
+
+// \endcond
+
+} // namespace geodesk
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <geodesk/geom/Coordinate.h>
 
 namespace geodesk {
@@ -38,6 +39,37 @@ public:
         return orientation(start.x, start.y, end.x, end.y, pt.x, pt.y);
     }
 
+    /**
+     * Returns the sign of the cross product of (end - start) and
+     * (p - start): positive if p lies to the left of the line through
+     * start and end, negative if it lies to the right, 0 if the three
+     * points are collinear.
+     *
+     * Unlike orientation(), the result is exact: The deltas take up
+     * to 33 bits, so their products need more than 64 bits (and can't
+     * be represented exactly as a double), which would misclassify
+     * nearly collinear points. We therefore use 128-bit integer math.
+     */
+    static int side(Coordinate start, Coordinate end, Coordinate p)
+    {
+        int64_t dx = static_cast<int64_t>(end.x) - start.x;
+        int64_t dy = static_cast<int64_t>(end.y) - start.y;
+        int64_t px = static_cast<int64_t>(p.x) - start.x;
+        int64_t py = static_cast<int64_t>(p.y) - start.y;
+        #ifdef __SIZEOF_INT128__
+        __int128 cross = static_cast<__int128>(dx) * py - static_cast<__int128>(dy) * px;
+        return (cross > 0) - (cross < 0);
+        #else
+        return signOfDifference(dx, py, dy, px);
+        #endif
+    }
+
+    /**
+     * Returns the sign of a * b - c * d, computed exactly (for operands
+     * whose products fit into 127 bits).
+     */
+    static int signOfDifference(int64_t a, int64_t b, int64_t c, int64_t d);
+
     static bool linesIntersect(double x1, double y1, double x2, double y2,
         double x3, double y3, double x4, double y4);
     static bool linesIntersect(Coordinate start1, Coordinate end1, Coordinate start2, Coordinate end2)
@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * Batch kernels for measuring lengths and areas, which operate on
+ * arrays of decoded coordinates (see WayCoordinateIterator::nextBatch()).
+ * Each kernel has a scalar implementation and an AVX2 implementation
+ * (on x86-64) that processes 4 coordinates at once; the best
+ * implementation supported by the CPU is selected at runtime.
+ *
+ * Instead of calling the trigonometric functions of the C library,
+ * both implementations evaluate the same polynomial approximations:
+ *
+ * - exp(t) is reduced to 2^n * exp(r) with |r| <= ln(2)/2, and exp(r)
+ *   is evaluated as a degree-12 Taylor polynomial (relative error
+ *   below 5e-16 for |t| <= 700)
+ *
+ * - atan(x) uses the range reduction and the degree-4/5 rational
+ *   approximation of the Cephes library (relative error below 3e-16)
+ *
+ * The remaining functions follow from the identities of the Mercator
+ * projection: with t = y * 2 * pi / MAP_WIDTH, the latitude is
+ * 2 * atan(exp(t)) - pi/2, and cos(lat) = 1 / cosh(t) =
+ * 2 * exp(t) / (exp(2t) + 1), so no sine or cosine has to be computed.
+ * Results therefore match the scalar code (which uses the C library)
+ * to within a few units in the last place.
+ */
+class MeasureKernels
+{
+public:
+	enum class Implementation
+	{
+		SCALAR,
+		AVX2
+	};
+
+	/**
+	 * Returns the length (in meters) of the linestring formed by
+	 * `count` coordinates; each segment is scaled at the Y-coordinate
+	 * of its midpoint (the same as Distance::metersBetween()).
+	 */
+	static double length(const Coordinate* coords, size_t count)
+	{
+		return dispatch().length(coords, count);
+	}
+
+	/**
+	 * Projects `count` coordinates to a sinusoidal projection (in
+	 * meters), as used by LambertArea.
+	 */
+	static void projectSinusoidal(const Coordinate* coords, size_t count,
+		double* x, double* y)
+	{
+		dispatch().projectSinusoidal(coords, count, x, y);
+	}
+
+	/**
+	 * Returns twice the signed area of a portion of a ring, as the
+	 * sum of `(x[i] - x0) * (y[i-1] - y[i+1])` for all coordinates
+	 * except the first and last. Summing the results for consecutive
+	 * (overlapping by two coordinates) portions of a closed ring
+	 * yields twice its signed area.
+	 */
+	static double shoelace(const Coordinate* coords, size_t count, double x0)
+	{
+		return dispatch().shoelace(coords, count, x0);
+	}
+
+	/**
+	 * Same as above, for projected coordinates.
+	 */
+	static double shoelace(const double* x, const double* y, size_t count, double x0)
+	{
+		return dispatch().shoelaceProjected(x, y, count, x0);
+	}
+
+	static Implementation implementation() { return dispatch().implementation; }
+	static const char* implementationName();
+
+	/**
+	 * Forces the use of the given implementation (if the CPU supports
+	 * it), for benchmarking and testing. Not thread-safe.
+	 *
+	 * @return true if the implementation is supported
+	 */
+	static bool select(Implementation impl);
+
+	// Scalar versions of the approximations (exposed for testing)
+	static double exp(double t);
+	static double atan(double x);
+
+private:
+	struct Dispatch
+	{
+		double (*length)(const Coordinate*, size_t);
+		void (*projectSinusoidal)(const Coordinate*, size_t, double*, double*);
+		double (*shoelace)(const Coordinate*, size_t, double);
+		double (*shoelaceProjected)(const double*, const double*, size_t, double);
+		Implementation implementation;
+	};
+
+	static Dispatch& dispatch();
+};
+
+// \endcond
+
+} // namespace geodesk
@@ -0,0 +1,62 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <geodesk/feature/NodePtr.h>
+#include <geodesk/feature/RelationPtr.h>
+#include <geodesk/feature/WayPtr.h>
+#include <geodesk/geom/Box.h>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+class FeatureStore;
+
+/// \cond lowlevel
+
+/**
+ * Measures the distance between a point and the geometry of features
+ * (in Mercator units, squared). The distance of an area that contains
+ * the point is zero. Used by PointDistanceFilter and NearestQuery.
+ *
+ * If a `stopSquared` is given, measuring stops as soon as any part of
+ * the geometry is found to be closer than it: the result is then
+ * below `stopSquared`, but not necessarily the smallest distance. This
+ * turns the measurement into a cheap "within distance" test.
+ */
+class PointDistance
+{
+public:
+    explicit PointDistance(Coordinate xy, double stopSquared = 0) :
+        xy_(xy), stopSquared_(stopSquared) {}
+
+    double toFeatureSquared(FeatureStore* store, FeaturePtr feature) const;
+    double toNodeSquared(NodePtr node) const;
+    double toWaySquared(WayPtr way) const;
+
+    /**
+     * Returns the squared distance between the point and the closest
+     * point of the given box (0 if the box contains the point).
+     */
+    double toBoxSquared(const Box& box) const;
+
+    /**
+     * Returns the squared distance between the point and the corner
+     * of the given box that lies farthest from it.
+     */
+    double toFarthestCornerSquared(const Box& box) const;
+
+private:
+    double segmentsSquared(WayPtr way, int areaFlag) const;
+    double areaRelationSquared(FeatureStore* store, RelationPtr relation) const;
+    double membersSquared(FeatureStore* store, RelationPtr relation,
+        RecursionGuard& guard) const;
+
+    Coordinate xy_;
+    double stopSquared_;
+};
+
+// \endcond
+
+} // namespace geodesk
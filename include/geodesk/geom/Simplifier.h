@@ -0,0 +1,152 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <geodesk/feature/FeaturePtr.h>
+#include <geodesk/feature/WayPtr.h>
+#include <geodesk/feature/RelationPtr.h>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+///
+/// \cond lowlevel
+///
+
+/**
+ * Reduces the number of vertexes of linestrings and rings, using
+ * either the Douglas-Peucker or the Visvalingam-Whyatt algorithm.
+ *
+ * - Douglas-Peucker drops every vertex that lies within `tolerance`
+ *   of the line between the vertexes that are kept on either side
+ *
+ * - Visvalingam-Whyatt repeatedly drops the vertex that forms the
+ *   triangle with the smallest area with its neighbors, as long as
+ *   that area is smaller than `tolerance` squared
+ *
+ * The unit of simplification is the way: Each way is simplified on
+ * its own, in its stored order, with its endpoints pinned and with a
+ * tolerance based on the latitude of its endpoints, so it yields the
+ * same vertexes wherever it is used. The member ways of an area
+ * relation are simplified *before* the Polygonizer assembles them
+ * into rings (the Polygonizer may split ways where rings touch, which
+ * would otherwise pin different vertexes in each ring). As a result,
+ * an edge shared by two polygons (or by a polygon and a standalone
+ * way) is simplified the same way in each, and adjacent polygons
+ * remain gap-free.
+ *
+ * To keep rings from collapsing, a way with three or more vertexes
+ * always keeps at least one interior vertex, and a closed way that
+ * would end up with fewer than four vertexes is left unsimplified.
+ *
+ * The tolerance can be a fixed distance in Mercator units (e.g. the
+ * size of a pixel at a given zoom level), or a distance in meters
+ * that is converted to units at the latitude of the simplified way.
+ */
+class GEODESK_API Simplifier
+{
+public:
+    enum class Method
+    {
+        DOUGLAS_PEUCKER,
+        VISVALINGAM
+    };
+
+    /**
+     * Creates a Simplifier that leaves all geometries unchanged.
+     */
+    Simplifier() : method_(Method::DOUGLAS_PEUCKER), units_(0), meters_(0) {}
+
+    /**
+     * Creates a Simplifier with a fixed tolerance.
+     *
+     * @param tolerance the tolerance in Mercator units
+     */
+    explicit Simplifier(double tolerance, Method method = Method::DOUGLAS_PEUCKER) :
+        method_(method), units_(tolerance), meters_(0) {}
+
+    static Simplifier ofMeters(double meters, Method method = Method::DOUGLAS_PEUCKER)
+    {
+        Simplifier s(0, method);
+        s.meters_ = meters;
+        return s;
+    }
+
+    /**
+     * Creates a Simplifier whose tolerance is the size of a pixel
+     * of a 256x256 tile at the given zoom level.
+     */
+    static Simplifier ofZoom(int zoom, Method method = Method::DOUGLAS_PEUCKER)
+    {
+        return Simplifier(unitsPerPixel(zoom), method);
+    }
+
+    static double unitsPerPixel(int zoom);
+
+    bool isEnabled() const { return units_ > 0 || meters_ > 0; }
+    Method method() const { return method_; }
+
+    /**
+     * Returns the tolerance (in Mercator units) to use for a
+     * geometry located at the given Y-coordinate.
+     */
+    double toleranceAt(int32_t y) const;
+
+    /**
+     * Simplifies a linestring (or a ring, if the first and last
+     * coordinate are the same) in place.
+     *
+     * @return the number of coordinates that remain
+     */
+    size_t simplify(Coordinate* coords, size_t count, double tolerance) const;
+
+    static size_t douglasPeucker(Coordinate* coords, size_t count, double tolerance);
+    static size_t visvalingam(Coordinate* coords, size_t count, double tolerance);
+
+    /**
+     * Simplifies the coordinates of a way (in their stored order)
+     * in place, as described above.
+     *
+     * @return the number of coordinates that remain
+     */
+    size_t simplifyWay(Coordinate* coords, size_t count) const;
+
+    /**
+     * Appends the simplified coordinates of a way to `out`
+     * (including the closing coordinate if the way is an area).
+     */
+    void simplifyWay(WayPtr way, std::vector<Coordinate>& out) const;
+
+    /**
+     * Returns the simplified geometry of a feature as a list of
+     * coordinate sequences:
+     *
+     * - a node yields its location
+     * - a way yields its coordinates (closed, if it is an area)
+     * - an area relation yields its rings (each outer ring is
+     *   followed by its holes); a relation whose rings can't be
+     *   assembled yields nothing
+     * - any other relation yields the sequences of its members
+     *   (sub-relations that are referenced more than once are only
+     *   included once)
+     */
+    std::vector<std::vector<Coordinate>> simplifyFeature(
+        FeatureStore* store, FeaturePtr feature) const;
+
+private:
+    void simplifyFeature(FeatureStore* store, FeaturePtr feature,
+        RecursionGuard* guard, std::vector<std::vector<Coordinate>>& parts) const;
+    void simplifyAreaRelation(FeatureStore* store, RelationPtr relation,
+        std::vector<std::vector<Coordinate>>& parts) const;
+
+    Method method_;
+    double units_;
+    double meters_;
+};
+
+// \endcond
+
+} // namespace geodesk
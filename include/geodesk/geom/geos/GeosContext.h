@@ -0,0 +1,33 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#ifdef GEODESK_WITH_GEOS
+
+#include <geos_c.h>
+
+namespace geodesk {
+
+/**
+ * Owns a GEOS context handle, which is released when the object goes
+ * out of scope. Used by worker threads, which must not share the
+ * context of their caller.
+ */
+class GeosContext
+{
+public:
+	GeosContext() : handle_(GEOS_init_r()) {}
+	~GeosContext() { GEOS_finish_r(handle_); }
+	GeosContext(const GeosContext&) = delete;
+	GeosContext& operator=(const GeosContext&) = delete;
+
+	GEOSContextHandle_t handle() const { return handle_; }
+
+private:
+	GEOSContextHandle_t handle_;
+};
+
+} // namespace geodesk
+
+#endif
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <geodesk/geom/Coordinate.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * Batch kernels for the two tests at the heart of the point-in-polygon
+ * and segment-crossing checks of MCIndex and the prepared spatial
+ * filters. Each kernel has a scalar implementation, as well as SSE2
+ * and AVX2 implementations (on x86-64) that process 2 or 4 segments
+ * at once; the best implementation supported by the CPU is selected
+ * at runtime.
+ *
+ * The vector implementations evaluate the same floating-point
+ * expressions as LineSegment::orientation(), and fall back to the
+ * scalar code for any segment whose cross product is zero (the
+ * collinear case), hence all implementations produce identical results.
+ */
+class ChainKernels
+{
+public:
+	enum class Implementation
+	{
+		SCALAR,
+		SSE2,
+		AVX2
+	};
+
+	/**
+	 * A batch of segment pairs, stored as separate arrays of
+	 * coordinate components so they can be loaded straight
+	 * into vector registers.
+	 */
+	struct SegmentPairs
+	{
+		static constexpr int CAPACITY = 16;
+
+		void add(Coordinate start1, Coordinate end1, Coordinate start2, Coordinate end2)
+		{
+			x1[count] = start1.x;
+			y1[count] = start1.y;
+			x2[count] = end1.x;
+			y2[count] = end1.y;
+			x3[count] = start2.x;
+			y3[count] = start2.y;
+			x4[count] = end2.x;
+			y4[count] = end2.y;
+			count++;
+		}
+
+		bool isFull() const { return count == CAPACITY; }
+
+		int count = 0;
+		int32_t x1[CAPACITY];
+		int32_t y1[CAPACITY];
+		int32_t x2[CAPACITY];
+		int32_t y2[CAPACITY];
+		int32_t x3[CAPACITY];
+		int32_t y3[CAPACITY];
+		int32_t x4[CAPACITY];
+		int32_t y4[CAPACITY];
+	};
+
+	/**
+	 * Casts a ray from `pt` and adds the number of times it crosses
+	 * the linestring formed by `count` coordinates to `crossings`
+	 * (using the convention of PointInPolygon: +2 for a proper
+	 * crossing, +1 for a crossing through a vertex).
+	 *
+	 * @return true if `pt` lies on the linestring (in which case
+	 *   `crossings` is undefined)
+	 */
+	static bool countCrossings(const Coordinate* coords, size_t count,
+		Coordinate pt, uint32_t& crossings)
+	{
+		return dispatch().countCrossings(coords, count, pt, crossings);
+	}
+
+	/**
+	 * Checks whether any of the segment pairs intersect, according
+	 * to LineSegment::linesIntersect().
+	 */
+	static bool anyIntersect(const SegmentPairs& pairs)
+	{
+		return dispatch().anyIntersect(pairs);
+	}
+
+	static Implementation implementation() { return dispatch().implementation; }
+	static const char* implementationName();
+
+	/**
+	 * Forces the use of the given implementation (if the CPU supports
+	 * it), for benchmarking and testing. Not thread-safe.
+	 *
+	 * @return true if the implementation is supported
+	 */
+	static bool select(Implementation impl);
+
+private:
+	struct Dispatch
+	{
+		bool (*countCrossings)(const Coordinate*, size_t, Coordinate, uint32_t&);
+		bool (*anyIntersect)(const SegmentPairs&);
+		Implementation implementation;
+	};
+
+	static Dispatch& dispatch();
+};
+
+// \endcond
+
+} // namespace geodesk
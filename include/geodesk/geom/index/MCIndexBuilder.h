@@ -6,6 +6,8 @@
 #ifdef GEODESK_WITH_GEOS
 #include <geos_c.h>
 #endif
+#include <memory>
+#include <vector>
 #include <geodesk/geom/index/MonotoneChain.h>
 #include <geodesk/geom/index/MCIndex.h>
 #include <geodesk/feature/WayPtr.h>
@@ -20,6 +22,7 @@ public:
 	MCIndexBuilder();
 	void addLineSegment(Coordinate start, Coordinate end);
 	void segmentizeWay(WayPtr way);
+	void segmentizeWays(const std::vector<WayPtr>& ways);
 	#ifdef GEODESK_WITH_GEOS
 	void segmentizeCoords(GEOSContextHandle_t context, const GEOSCoordSequence* coords);
 	void segmentizePolygon(GEOSContextHandle_t context, const GEOSGeometry* polygon);
@@ -27,6 +30,17 @@ public:
 	void segmentizeAreaRelation(FeatureStore* store, RelationPtr rel);
 	void segmentizeMembers(FeatureStore* store, RelationPtr rel, RecursionGuard& guard);
 	MCIndex build(Box bounds);
+
+	bool isEmpty() const { return chainCount_ == 0; }
+
+	/**
+	 * The approximate number of bytes used by the index that
+	 * build() will create.
+	 */
+	size_t estimatedIndexSize() const
+	{
+		return totalChainSize_ + chainCount_ * sizeof(RTree<const MonotoneChain>::Node) * 2;
+	}
 	static MCIndex buildFromAreaRelation(FeatureStore* store, RelationPtr rel)
 	{
 		MCIndexBuilder builder;
@@ -38,6 +52,12 @@ private:
 	// static const size_t CHUNK_SIZE = 32 * 1024;
 	static const int MAX_VERTEX_COUNT = 256;
 
+	/**
+	 * segmentizeWays() slices the ways in parallel if they have
+	 * at least this many vertexes in total
+	 */
+	static const size_t MIN_PARALLEL_VERTEXES = 200'000;
+
 	class MCHolder 
 	{
 	public:
@@ -52,10 +72,18 @@ private:
 		MonotoneChain chain;
 	};
 
+	void addChain(MCHolder* holder);
+	static void collectMemberWays(FeatureStore* store, RelationPtr rel,
+		RecursionGuard& guard, std::vector<WayPtr>& ways);
+
 	size_t chainCount_;
 	size_t totalChainSize_;
 	const MCHolder* first_;
+	MCHolder* last_;
 	clarisma::Arena arena_;
+	std::vector<std::unique_ptr<MCIndexBuilder>> parts_;
+		// builders used by segmentizeWays(); their chains are
+		// linked into our own list, so we must keep them alive
 };
 
 } // namespace geodesk
@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <geodesk/geom/index/MCIndex.h>
+#include <geodesk/geom/index/TileClassifier.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+using SharedMCIndex = std::shared_ptr<const MCIndex>;
+
+/**
+ * A memory-bounded LRU cache of the prepared MCIndexes of features,
+ * keyed by typed ID. Each FeatureStore has one, so that repeated
+ * spatial filters based on the same feature (e.g. `within(germany)`)
+ * only need to build its index once.
+ *
+ * The cache is opt-in: its budget is zero (disabled) by default; use
+ * FeatureStore::enableIndexCache() or setMaxBytes() to turn it on.
+ * Each cached index also holds the TileClassifiers (in AREA and LINEAL
+ * mode) that filters create for it, so their tile classifications are
+ * shared as well.
+ *
+ * Indexes are shared: evicting an index from the cache does not
+ * affect any filter that is still using it.
+ *
+ * Thread-safe.
+ */
+class MCIndexCache
+{
+public:
+	static constexpr size_t DEFAULT_MAX_BYTES = 128 * 1024 * 1024;
+
+	explicit MCIndexCache(size_t maxBytes = 0) :
+		maxBytes_(maxBytes),
+		totalBytes_(0)
+	{
+	}
+
+	bool isEnabled() const { return maxBytes_ > 0; }
+
+	/**
+	 * Returns the index for the given feature, or an empty pointer
+	 * if the index isn't cached (or the cache is disabled).
+	 */
+	SharedMCIndex get(uint64_t typedId);
+
+	/**
+	 * Adds an index to the cache (replacing any existing index for
+	 * the same feature), then evicts the least-recently used indexes
+	 * until the cache fits into its budget. An index larger than the
+	 * budget is not cached at all.
+	 *
+	 * @param size the approximate memory used by the index (in bytes)
+	 */
+	void put(uint64_t typedId, SharedMCIndex index, size_t size);
+
+	/**
+	 * Returns the TileClassifier for the given index (in AREA or LINEAL
+	 * mode). If the index is the one cached for the feature, the
+	 * classifier is kept alongside it (and created on first request);
+	 * otherwise, the caller receives a new classifier of its own.
+	 *
+	 * @param bounds  the bounding box of the feature
+	 */
+	SharedTileClassifier tileClassifier(uint64_t typedId, const MCIndex* index,
+		TileClassifier::Mode mode, const Box& bounds);
+
+	void setMaxBytes(size_t maxBytes);
+	void clear();
+
+private:
+	struct Entry
+	{
+		uint64_t typedId;
+		SharedMCIndex index;
+		size_t size;
+		SharedTileClassifier classifiers[2];		// AREA, LINEAL
+	};
+
+	void evict();		// must hold lock
+
+	std::mutex mutex_;
+	std::list<Entry> entries_;	// most recently used first
+	std::unordered_map<uint64_t, std::list<Entry>::iterator> map_;
+	std::atomic<size_t> maxBytes_;
+	size_t totalBytes_;
+};
+
+// \endcond
+
+} // namespace geodesk
@@ -58,6 +58,7 @@ public:
         return Box::normalizedSimple(coords[0], coords[coordCount - 1]);
     }
 
+    Coordinate vertex(int n) const { return coords[n]; }
     Coordinate first() const { return coords[0]; }
     Coordinate last() const  { return coords[coordCount-1]; }
 
@@ -0,0 +1,123 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <geodesk/geom/Box.h>
+#include <geodesk/geom/Tile.h>
+#include <geodesk/geom/index/MCIndex.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * A quadtree that records where each tile (down to MAX_ZOOM) lies in
+ * respect to the polygon of an MCIndex: fully inside, fully outside,
+ * or on the boundary (as defined by MCIndex::locateBox()).
+ *
+ * The quadtree is built lazily, as tiles are located: A boundary tile
+ * is only subdivided once a tile below it is requested, and only its
+ * four children are then tested against the index (the children of an
+ * inside or outside tile are inside or outside as well). Tiles that
+ * don't intersect the given bounds are outside without having to
+ * consult the index. Once a tile's branch has been built, locating
+ * it requires no more than one table lookup per zoom level.
+ *
+ * For an index of linear features (Mode::LINEAL), there is no "inside":
+ * tiles are classified as either outside (-1) or as interacting with
+ * the linework (0).
+ *
+ * In CORRIDOR mode, tiles are classified in respect to the region that
+ * lies within a given distance of the indexed geometry: a tile is
+ * outside if no chain passes through the tile buffered by the distance
+ * (and, for a polygon, the tile doesn't lie inside it), and inside
+ * only if it lies inside the polygon.
+ *
+ * A classifier is always used with the same index; classifiers in AREA
+ * and LINEAL mode are shared via the MCIndexCache, alongside their index.
+ *
+ * Thread-safe.
+ */
+class TileClassifier
+{
+public:
+	static constexpr int MAX_ZOOM = 12;
+
+	enum class Mode
+	{
+		AREA,
+		LINEAL,
+		CORRIDOR
+	};
+
+	/**
+	 * Creates a classifier in AREA or LINEAL mode.
+	 *
+	 * @param bounds  the bounding box of the indexed geometry
+	 */
+	TileClassifier(Mode mode, const Box& bounds) :
+		bounds_(bounds),
+		mode_(mode)
+	{
+	}
+
+	/**
+	 * Creates a classifier in CORRIDOR mode.
+	 *
+	 * @param bounds    the bounding box of the indexed geometry,
+	 *                  buffered by the distance
+	 * @param distance  the width of the corridor (in Mercator units)
+	 * @param isArea    true if the index represents a polygon
+	 */
+	TileClassifier(const Box& bounds, int32_t distance, bool isArea) :
+		bounds_(bounds),
+		mode_(Mode::CORRIDOR),
+		corridorIsArea_(isArea),
+		corridorDistance_(distance)
+	{
+	}
+
+	/**
+	 * Returns -1 if the tile lies fully outside the polygon, 1 if it
+	 * lies fully inside, or 0 if it interacts with the boundary.
+	 * The result is the same as `index.locateBox(tile.bounds())`
+	 * (the index must be the same for each call), except that the
+	 * root tile (zoom 0) is always reported as 0. In LINEAL mode,
+	 * the result is 0 if `index.intersectsBoxBoundary(tile.bounds())`,
+	 * otherwise -1.
+	 */
+	int locate(const MCIndex& index, Tile tile) const;
+
+private:
+	/**
+	 * Entries are -1 (outside), 0 (boundary, at MAX_ZOOM), 1 (inside)
+	 * or PARTIAL (boundary, not yet subdivided); any higher value
+	 * refers to the node whose index is `entry - FIRST_NODE`, which
+	 * holds the entries of the four child tiles.
+	 */
+	static constexpr int32_t PARTIAL = 2;
+	static constexpr int32_t FIRST_NODE = 3;
+
+	int32_t subdivide(const MCIndex& index, Tile tile) const;	// must hold lock
+	int32_t classify(const MCIndex& index, Tile tile) const;
+
+	Box bounds_;
+	Mode mode_;
+	bool corridorIsArea_ = false;
+	int32_t corridorDistance_ = 0;
+	mutable std::mutex mutex_;
+	mutable int32_t root_ = PARTIAL;
+	mutable std::vector<std::array<int32_t,4>> nodes_;
+};
+
+using SharedTileClassifier = std::shared_ptr<const TileClassifier>;
+
+// \endcond
+
+} // namespace geodesk
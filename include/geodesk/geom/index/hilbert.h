@@ -105,5 +105,68 @@ inline uint32_t calculateHilbertDistance(Coordinate c, const Box& bounds)
     return hilbert::calculateHilbertDistance(hilbertX, hilbertY);
 }
 
+/**
+ * Returns the lowest distance along the Hilbert Curve of any coordinate
+ * within `box` (which must lie within the reference bounds).
+ *
+ * The curve visits each aligned block of 2^k by 2^k cells in one
+ * contiguous run of 4^k distances, so instead of testing every cell,
+ * we descend the quadtree: At each level, we pick the quadrant (among
+ * those that intersect the box) whose run starts first; if it lies
+ * entirely within the box, the start of its run is the answer.
+ */
+inline uint32_t lowestHilbertDistance(const Box& box, const Box& bounds)
+{
+    assert(bounds.containsSimple(box));
+    auto gridX = [&bounds](int32_t x)
+    {
+        uint64_t relX = static_cast<int64_t>(x) - bounds.minX();
+        return static_cast<uint32_t>((relX * MAX_COORDINATE) / bounds.widthSimple());
+    };
+    auto gridY = [&bounds](int32_t y)
+    {
+        uint64_t relY = static_cast<int64_t>(y) - bounds.minY();
+        return static_cast<uint32_t>((relY * MAX_COORDINATE) / bounds.height());
+    };
+    uint32_t minX = gridX(box.minX());
+    uint32_t minY = gridY(box.minY());
+    uint32_t maxX = gridX(box.maxX());
+    uint32_t maxY = gridY(box.maxY());
+
+    uint32_t blockX = 0;
+    uint32_t blockY = 0;
+    for (int level = 15; ; level--)
+    {
+        uint32_t size = 1u << level;
+        uint32_t runMask = ~((1u << (level * 2)) - 1);
+        uint32_t lowest = UINT32_MAX;
+        uint32_t lowestX = 0;
+        uint32_t lowestY = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            uint32_t x = blockX + (i & 1) * size;
+            uint32_t y = blockY + (i >> 1) * size;
+            if (x > maxX || x + size - 1 < minX || y > maxY || y + size - 1 < minY)
+            {
+                continue;
+            }
+            uint32_t runStart = calculateHilbertDistance(x, y) & runMask;
+            if (runStart < lowest)
+            {
+                lowest = runStart;
+                lowestX = x;
+                lowestY = y;
+            }
+        }
+        if (lowestX >= minX && lowestX + size - 1 <= maxX &&
+            lowestY >= minY && lowestY + size - 1 <= maxY)
+        {
+            return lowest;      // always the case for single cells (level 0)
+        }
+        blockX = lowestX;
+        blockY = lowestY;
+    }
+}
+
 
 } // namespace geodesk::hilbert
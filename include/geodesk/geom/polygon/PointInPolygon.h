@@ -6,6 +6,7 @@
 #include <geodesk/feature/FastMemberIterator.h>
 #include <geodesk/feature/WayCoordinateIterator.h>
 #include <geodesk/geom/LineSegment.h>
+#include <geodesk/geom/index/ChainKernels.h>
 
 namespace geodesk {
 
@@ -45,30 +46,14 @@ public:
 			// no intersection is possible.
 			return false;
 		}
+		// Decode the coordinates in batches, which we hand to the
+		// vectorized kernel
+
 		WayCoordinateIterator iter(way);
-		Coordinate prev = iter.next();
-		for (;;)
+		return iter.forEachSegmentBatch([this](const Coordinate* coords, int count)
 		{
-			Coordinate next = iter.next();
-			if (next.isNull()) break;
-
-			// we normalize the vector so it always points upwards
-			Coordinate start = prev.y < next.y ? prev : next;
-			Coordinate end = prev.y < next.y ? next : prev;
-			
-			if (point_.y >= start.y && point_.y <= end.y)
-			{
-				// TODO: this could be more efficient
-
-				int orientation = LineSegment::orientation(start, end, point_);
-				if (orientation == 0) return true;
-				crossingCount_ += orientation > 0 ?
-					((point_.y == start.y || point_.y == end.y) ? 1 : 2) : 0;
-				// We count a ray crossing through a vertex as one-half
-			}
-			prev = next;
-		}
-		return false;
+			return ChainKernels::countCrossings(coords, count, point_, crossingCount_);
+		});
 	}
 
 	bool testAgainstRelation(FeatureStore* store, const RelationPtr relation)
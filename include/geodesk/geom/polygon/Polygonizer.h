@@ -12,6 +12,8 @@
 
 namespace geodesk {
 
+class Simplifier;
+
 /// @brief Utility class for creating polygon rings from Relation members.
 /// In OpenStreetMap, polygons with holes and multi-polygons are represented
 /// as relations. Member ways with role `outer` and `inner` form the linework.
@@ -55,18 +57,66 @@ public:
     /// whose edges touch. (This is sufficient for many operations
     /// such as area or centroid computation)
     ///
-    /// @param store    the FeatureStore
-    /// @param relation pointer to the stored Relation
+    /// If a Simplifier is given, the member ways are simplified
+    /// (see Simplifier::simplifyWay()) before they are assembled,
+    /// so a way shared with other rings or features is simplified
+    /// the same way in each.
+    ///
+    /// @param store      the FeatureStore
+    /// @param relation   pointer to the stored Relation
+    /// @param simplifier the Simplifier to apply, or `nullptr`
+    ///
+    void createRings(FeatureStore* store, RelationPtr relation,
+        const Simplifier* simplifier = nullptr);
+
+    /// @brief Adds a ring given by its coordinates (whose first
+    /// and last coordinate must be the same), e.g. a ring that
+    /// doesn't come from a stored Relation. Call this before
+    /// assignAndMergeHoles() and validate().
+    ///
+    /// @param coords  the coordinates of the ring
+    /// @param count   the number of coordinates (at most 65535)
+    /// @param isOuter true for an outer ring, false for a hole
     ///
-    void createRings(FeatureStore* store, RelationPtr relation);
+    void addRing(const Coordinate* coords, int count, bool isOuter);
 
     /// @brief Assigns inner rings to outer, and merges any inner
     /// rings whose edges touch. The createRings() method must
     /// have been called.
     ///
     void assignAndMergeHoles();
+
+    /// @brief Checks the assembled rings for edges that cross or
+    /// overlap, and normalizes their orientation (outer rings
+    /// counter-clockwise, inner rings clockwise, as required by
+    /// GeoJSON). Should be called after assignAndMergeHoles(), so that
+    /// each outer ring is checked together with its holes (unassigned
+    /// rings are checked individually). Rings that merely touch at
+    /// a vertex are accepted.
+    ///
+    /// Polygons that fail the check are marked as invalid (see
+    /// Ring::isValid()); createPolygonal() only hands geometries
+    /// with invalid polygons to GEOS for repair (MakeValid, or a
+    /// zero-width buffer for GEOS versions before 3.8).
+    ///
+    /// @return the number of invalid polygons
+    ///
+    int validate();
+
+    /// @brief Returns `false` if the last call to validate()
+    /// found any invalid polygons.
+    ///
+    bool isValid() const { return invalidCount_ == 0; }
+
+    /// @brief Calls `f(ring, isOuter)` for each outer and inner ring,
+    /// regardless of whether the inner rings have already been
+    /// assigned to their outer rings. (Defined in Ring.h)
+    ///
+    template <typename F>
+    void forEachRing(F&& f) const;
+
     #ifdef GEODESK_WITH_GEOS
-    GEOSGeometry* createPolygonal(GEOSContextHandle_t context);
+    GEOSGeometry* createPolygonal(GEOSContextHandle_t context) const;
     #endif
 
 private:
@@ -74,16 +124,31 @@ private:
     class RingBuilder;
     class RingAssigner;
     class RingMerger;
+    class RingValidator;
 
     Segment* createSegment(WayPtr way, Segment* next);
+    static void decodeSegment(Segment* seg, const Simplifier* simplifier);
+    void decodeSegments(Segment* outerSegments, Segment* innerSegments,
+        const Simplifier* simplifier);
     Ring* buildRings(int segmentCount, Segment* firstSegment);
+    #ifdef GEODESK_WITH_GEOS
+    GEOSGeometry* buildPolygonal(GEOSContextHandle_t context) const;
+    #endif
 
     static Ring* createRing(int vertexCount, Segment* firstSegment, 
         Ring* next, clarisma::Arena& arena);
+
+    /**
+     * Multipolygons with at least this many vertexes have their
+     * segments decoded (and the polygons of their outer rings
+     * created) in parallel
+     */
+    static const size_t MIN_PARALLEL_VERTEXES = 200'000;
     
     clarisma::Arena arena_;
     Ring* outerRings_;
     Ring* innerRings_;
+    int invalidCount_;
 
     friend class RingCoordinateIterator;
 };
@@ -0,0 +1,128 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <geodesk/geom/polygon/Polygonizer.h>
+
+namespace geodesk {
+
+class FeatureStore;
+
+/// \cond lowlevel
+
+using SharedPolygonizer = std::shared_ptr<const Polygonizer>;
+
+/**
+ * A memory-bounded LRU cache of the assembled rings of area relations,
+ * keyed by relation ID. Each FeatureStore has one, which is shared by
+ * the measurement functions (area and centroid), the GeoJSON and WKT
+ * writers and the GeometryBuilder, so that popular relations (e.g.
+ * countries or cities) only need to be polygonized once.
+ *
+ * The cache is opt-in: its budget is zero (disabled) by default; use
+ * FeatureStore::enableRingCache() or setMaxBytes() to turn it on.
+ * Cached rings always have their holes assigned and merged, and have
+ * been checked by Polygonizer::validate(). They are shared: evicting
+ * an entry does not affect any caller that is still using it.
+ *
+ * Thread-safe.
+ */
+class RingCache
+{
+public:
+	static constexpr size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+
+	struct Stats
+	{
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;
+		size_t entryCount;
+		size_t totalBytes;
+
+		double hitRate() const
+		{
+			uint64_t lookups = hits + misses;
+			return lookups ? static_cast<double>(hits) / lookups : 0;
+		}
+	};
+
+	explicit RingCache(size_t maxBytes = 0) :
+		maxBytes_(maxBytes),
+		totalBytes_(0),
+		hits_(0),
+		misses_(0),
+		evictions_(0)
+	{
+	}
+
+	bool isEnabled() const { return maxBytes_ > 0; }
+
+	/**
+	 * Returns the assembled rings of the given area relation, from the
+	 * cache if possible. If the cache is disabled, the rings are
+	 * assembled without being cached; in that case, their holes are
+	 * only assigned if `assignHoles` is true (Callers that don't need
+	 * the holes assigned should use forEachRing() to visit the rings).
+	 * Only cached rings are checked by Polygonizer::validate(), so
+	 * callers that don't enable the cache don't pay for validation.
+	 */
+	SharedPolygonizer rings(FeatureStore* store, RelationPtr relation,
+		bool assignHoles = true);
+
+	/**
+	 * Returns the rings of the given relation, or an empty pointer
+	 * if they aren't cached.
+	 */
+	SharedPolygonizer get(uint64_t relationId);
+
+	/**
+	 * Adds rings to the cache (replacing any existing entry for
+	 * the same relation), then evicts the least-recently used entries
+	 * until the cache fits into its budget. Rings larger than the
+	 * budget are not cached at all.
+	 *
+	 * @param size the approximate memory used by the rings (in bytes)
+	 */
+	void put(uint64_t relationId, SharedPolygonizer rings, size_t size);
+
+	void setMaxBytes(size_t maxBytes);
+	void clear();
+	Stats stats();
+
+	/**
+	 * Returns the approximate memory used by the assembled rings
+	 * (their segments and coordinates) of a Polygonizer.
+	 */
+	static size_t estimatedSize(const Polygonizer& polygonizer);
+
+private:
+	struct Entry
+	{
+		uint64_t relationId;
+		SharedPolygonizer rings;
+		size_t size;
+	};
+
+	void evict();		// must hold lock
+
+	std::mutex mutex_;
+	std::list<Entry> entries_;	// most recently used first
+	std::unordered_map<uint64_t, std::list<Entry>::iterator> map_;
+	std::atomic<size_t> maxBytes_;
+	size_t totalBytes_;
+	uint64_t hits_;
+	uint64_t misses_;
+	uint64_t evictions_;
+};
+
+// \endcond
+
+} // namespace geodesk
@@ -3,9 +3,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <geodesk/feature/types.h>
+#include <clarisma/util/prefetch.h>
 #include <geodesk/feature/FeaturePtr.h>
 
 namespace geodesk {
@@ -18,6 +20,7 @@ class RoleMatcher;
 /// \cond lowlevel
 
 typedef bool (*MatcherMethod)(const Matcher*, FeaturePtr);
+typedef uint64_t (*MatcherBatchMethod)(const Matcher*, const FeaturePtr*, int);
 typedef const Matcher* (*RoleMatcherMethod)(const RoleMatcher*, FeaturePtr);
 
 // MatcherHolder is a variable-length structure that bundles one or more Matchers,
@@ -41,7 +44,16 @@ typedef const Matcher* (*RoleMatcherMethod)(const RoleMatcher*, FeaturePtr);
 class Matcher
 {
 public:
-    Matcher(MatcherMethod func, FeatureStore* store) : function_(func), store_(store) {}
+    /**
+     * The maximum number of candidates that can be passed to
+     * acceptBatch() (results are returned as a 64-bit mask).
+     */
+    static constexpr int MAX_BATCH_SIZE = 64;
+
+    Matcher(MatcherMethod func, FeatureStore* store) :
+        Matcher(func, acceptEach, store) {}
+    Matcher(MatcherMethod func, MatcherBatchMethod batchFunc, FeatureStore* store) :
+        function_(func), batchFunction_(batchFunc), store_(store) {}
 
     // TODO: Can this throw?
     bool accept(FeaturePtr feature) const
@@ -49,10 +61,85 @@ public:
         return function_(this, feature);
     }
 
+    /**
+     * Tests up to MAX_BATCH_SIZE features (typically the candidates
+     * of a single index leaf) in one call.
+     *
+     * @return a bitmask in which bit `i` is set if `features[i]`
+     *   is accepted
+     */
+    uint64_t acceptBatch(const FeaturePtr* features, int count) const
+    {
+        assert(count >= 0 && count <= MAX_BATCH_SIZE);
+        return batchFunction_(this, features, count);
+    }
+
     FeatureStore* store() const { return store_; }
+    MatcherMethod method() const { return function_; }
+
+    /**
+     * Prefetches the tag table of the given feature. The feature
+     * header itself is usually already in cache (it sits inside the
+     * index leaf), but its tag table may live anywhere in the tile.
+     */
+    static void prefetchTags(FeaturePtr feature)
+    {
+        DataPtr ppTags = feature.ptr() + 8;
+        clarisma::prefetchRead(ppTags.ptr() + (ppTags.getInt() & ~1));
+    }
+
+    /**
+     * Default batch method: calls the single-feature method for each
+     * candidate, prefetching tag tables a few candidates ahead so
+     * their cache misses overlap with the evaluation of earlier ones.
+     */
+    static uint64_t acceptEach(const Matcher* matcher,
+        const FeaturePtr* features, int count)
+    {
+        MatcherMethod func = matcher->function_;
+        return acceptPrefetched(features, count,
+            [matcher, func](FeaturePtr f) { return func(matcher, f); });
+    }
+
+    /**
+     * Same as acceptEach(), but with a fixed single-feature method
+     * that the compiler can inline into the loop. (`Method` may
+     * return `int` instead of `bool`; any non-zero value is a match.)
+     */
+    template<auto Method>
+    static uint64_t acceptEachWith(const Matcher* matcher,
+        const FeaturePtr* features, int count)
+    {
+        return acceptPrefetched(features, count,
+            [matcher](FeaturePtr f) { return Method(matcher, f) != 0; });
+    }
+
+    /**
+     * Calls `func` for each feature (returning the results as a bitmask),
+     * prefetching tag tables a few features ahead.
+     */
+    template<typename Func>
+    static uint64_t acceptPrefetched(const FeaturePtr* features, int count, Func func)
+    {
+        int prefetchCount = std::min(count, PREFETCH_DISTANCE);
+        for (int i = 0; i < prefetchCount; i++) prefetchTags(features[i]);
+        uint64_t accepted = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (i + PREFETCH_DISTANCE < count)
+            {
+                prefetchTags(features[i + PREFETCH_DISTANCE]);
+            }
+            accepted |= static_cast<uint64_t>(func(features[i])) << i;
+        }
+        return accepted;
+    }
 
 private:
+    static constexpr int PREFETCH_DISTANCE = 4;
+
     MatcherMethod function_;
+    MatcherBatchMethod batchFunction_;
     FeatureStore* store_;           // not refcounted
 };
 
@@ -72,6 +159,20 @@ private:
 };
 
 
+/**
+ * A simple test of a global-key tag, used to create specialized
+ * matchers via MatcherHolder::createMatchGlobalTags(). The key must be
+ * present, and its value must be the global string `valueCode`
+ * (or, if `notEqual` is set, anything other than that string --
+ * [k] is expressed as k != "no").
+ */
+struct GlobalTagTest
+{
+    int keyCode;
+    int valueCode;
+    bool notEqual;
+};
+
 struct IndexMask
 {
     uint32_t keyMask;
@@ -91,6 +192,24 @@ public:
     static const MatcherHolder* createMatchKeyValue(FeatureTypes types,
         uint32_t indexBits, int keyCode, int valueCode);
 
+    /**
+     * The maximum number of tests supported by createMatchGlobalTags().
+     */
+    static constexpr int MAX_GLOBAL_TAG_TESTS = 4;
+
+    /**
+     * Creates a matcher that requires all of the given global-key
+     * tests to pass, using a function specialized for the number of
+     * tests instead of the bytecode interpreter. Since every test
+     * requires its key, a feature must have all of `indexBits` to
+     * be accepted.
+     *
+     * @param tests an array of 1 to MAX_GLOBAL_TAG_TESTS tests
+     *   (each for a different key)
+     */
+    static const MatcherHolder* createMatchGlobalTags(FeatureTypes types,
+        uint32_t indexBits, const GlobalTagTest* tests, int count);
+
     /**
      * Returns a matcher that must match both a and b.
      * (This function steals the references to a and b, which means
@@ -113,10 +232,28 @@ public:
         return ((keys & mask.keyMask) >= mask.keyMin);
     }
 
+    /**
+     * Returns true if this matcher only accepts features that have
+     * at least one indexed key, i.e. acceptIndex() can be used to
+     * skip parts of the spatial index.
+     */
+    bool usesIndexedKeys() const
+    {
+        for (const IndexMask& mask : indexMasks_)
+        {
+            if (mask.keyMin != 0) return true;
+        }
+        return false;
+    }
+
 private:
     static const Matcher* defaultRoleMethod(const RoleMatcher* matcher, FeaturePtr);
     static bool matchAllMethod(const Matcher*, FeaturePtr);
+    static uint64_t matchAllBatchMethod(const Matcher*, const FeaturePtr*, int count);
     static uint8_t* alloc(size_t size) { return new uint8_t[size]; };
+    template<int N>
+    static const MatcherHolder* createGlobalTagsMatcher(FeatureTypes types,
+        uint32_t indexBits, const GlobalTagTest* tests);
 
     mutable std::atomic_uint_fast32_t refcount_;
     FeatureTypes acceptedTypes_;
@@ -133,6 +270,7 @@ private:
 
     friend class MatcherCompiler;
     friend class ComboMatcher;
+    friend class MatcherProfile;
 };
 
 // \endcond
@@ -12,6 +12,7 @@ namespace geodesk {
 class FeatureStore;
 class MatcherHolder;
 class OpGraph;
+struct GlobalTagTest;
 struct Selector;
 
 /// \cond lowlevel
@@ -29,6 +30,7 @@ public:
 
 private:
 	const MatcherHolder* compileMatcher(OpGraph& graph, Selector* firstSel, uint32_t indexBits);
+	static int globalTagTests(const Selector* sel, int codeNo, GlobalTagTest* tests);
 
 	FeatureStore* store_;
 	// asmjit::JitRuntime runtime_;
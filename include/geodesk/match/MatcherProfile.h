@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <geodesk/export.h>
+
+namespace geodesk {
+
+class Matcher;
+class MatcherHolder;
+
+/// \cond lowlevel
+
+/**
+ * Per-instruction execution statistics of a compiled matcher.
+ *
+ * Profiles are only collected if the library is built with
+ * `GEODESK_MATCHER_PROFILING` (CMake option of the same name), since
+ * the bookkeeping slows down the matcher considerably. In a profiling
+ * build, every matcher compiled by MatcherCompiler (i.e. any matcher
+ * not handled by one of the specialized single-tag matchers) gets a
+ * profile, which records for each instruction (each OpNode of the
+ * compiled program):
+ *
+ * - how often it was executed
+ * - how often its condition was true (after applying negation)
+ * - the cumulative number of cycles spent in it (TSC ticks on x86,
+ *   otherwise nanoseconds)
+ *
+ * Use report() to obtain the decoded program annotated with these
+ * counts.
+ */
+class GEODESK_API MatcherProfile
+{
+public:
+    struct Counters
+    {
+        std::atomic_uint64_t executed;
+        std::atomic_uint64_t matched;
+        std::atomic_uint64_t cycles;
+    };
+
+    explicit MatcherProfile(size_t codeWords);
+
+    /**
+     * Returns true if the library was built with matcher profiling.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns the profile of the given matcher, or `nullptr` if it
+     * has none (not a profiling build, or not a compiled matcher).
+     */
+    static MatcherProfile* of(const MatcherHolder* matcher);
+    static MatcherProfile* of(const Matcher* matcher);
+
+    /**
+     * Returns the decoded program of the matcher, with each instruction
+     * prefixed by its execution count, match count and cycles.
+     */
+    static std::string report(const MatcherHolder* matcher);
+
+    Counters& counters(size_t instructionWord) { return counters_[instructionWord]; }
+    void reset();
+
+    static uint64_t timestamp();
+
+private:
+    size_t codeWords_;
+    std::unique_ptr<Counters[]> counters_;
+};
+
+// \endcond
+
+} // namespace geodesk
@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <queue>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <geodesk/feature/FeatureBase.h>
+#include <geodesk/feature/View.h>
+#include <geodesk/geom/Coordinate.h>
+#include <geodesk/geom/PointDistance.h>
+#include <geodesk/geom/Tile.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * Finds the features of a View that lie closest to a given point.
+ *
+ * For world views, this is a best-first search: Tiles are placed into
+ * a priority queue, ordered by their distance to the point. A tile is
+ * only opened once it reaches the front of the queue, at which point
+ * its index roots, branches and leaves are queued in turn (based on the
+ * distance of their bounding boxes). Candidates that pass the type
+ * check and the matcher are queued by the distance of their bounding
+ * box, and are only measured exactly (and run through the filter) once
+ * they reach the front. A measured feature that reaches the front of
+ * the queue is closer than anything that remains, so the search ends as
+ * soon as `k` features have been found.
+ *
+ * Tiles are discovered ring by ring: the search starts with the tiles
+ * within a small square around the point, and queues a marker at the
+ * distance of the square's edge (any tile not yet queued lies farther
+ * away). Only once the marker reaches the front of the queue is the
+ * square doubled in size, so tiles (and branches) beyond the k-th
+ * distance are never visited.
+ *
+ * Other views (members, nodes, parents) are small, so their features
+ * are simply measured one by one.
+ */
+class GEODESK_API NearestQuery
+{
+public:
+    NearestQuery(const View& view, Coordinate xy);
+
+    /**
+     * Returns up to `k` features, closest first, along with their
+     * distance in meters (0 for areas that contain the point).
+     */
+    std::vector<std::pair<Feature,double>> search(size_t k);
+
+private:
+    enum EntryType : uint8_t
+    {
+        EXPAND,
+        TILE,
+        ROOT,
+        BRANCH,
+        LEAF,
+        CANDIDATE,
+        MEASURED
+    };
+
+    struct Entry
+    {
+        double distanceSquared;
+        const uint8_t* p;
+        Tile tile;
+        Tip tip;
+        uint32_t turboFlags;
+        EntryType type;
+        FeatureIndexType indexType;
+
+        bool operator>(const Entry& other) const
+        {
+            return distanceSquared > other.distanceSquared;
+        }
+    };
+
+    void searchWorld(size_t k, std::vector<std::pair<Feature,double>>& results);
+    void searchGeneric(size_t k, std::vector<std::pair<Feature,double>>& results);
+    void queueTiles();
+    void openTile(const Entry& entry);
+    void queueRoots(DataPtr pTile, const Entry& tileEntry, FeatureIndexType indexType);
+    void queueChild(DataPtr ppChild, const Entry& parent);
+    void openBranch(const Entry& entry);
+    void openLeaf(const Entry& entry);
+    void openNodeLeaf(const Entry& entry);
+    void queueCandidate(FeaturePtr feature, double distanceSquared, const Entry& parent);
+    double metersFromSquared(double distanceSquared) const;
+
+    const View& view_;
+    /**
+     * The half-width of the first square of tiles (about the size
+     * of a tile at zoom level 12)
+     */
+    static constexpr int64_t INITIAL_RADIUS = 1 << 20;
+
+    Coordinate xy_;
+    Box bounds_;
+    PointDistance distance_;
+    int64_t radius_;
+    std::unordered_set<uint32_t> queuedTiles_;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue_;
+    std::unordered_set<uint64_t> seen_;
+        // typed IDs of ways and relations already queued
+};
+
+// \endcond
+} // namespace geodesk
@@ -0,0 +1,85 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <span>
+#include <vector>
+#include <clarisma/alloc/Arena.h>
+#include <geodesk/feature/FeatureBase.h>
+#include <geodesk/feature/View.h>
+#include <geodesk/geom/Coordinate.h>
+#include <geodesk/geom/index/MCIndexCache.h>
+#include <geodesk/geom/index/RTree.h>
+
+namespace geodesk {
+
+/// \cond lowlevel
+
+/**
+ * Determines which areas of a View contain each of a large number
+ * of points (e.g. to assign coordinates to admin areas).
+ *
+ * The prepared MCIndex of each area is built once (or taken from
+ * the store's MCIndexCache, if enabled), and the bounding boxes of the areas are
+ * placed into an R-tree. The points are then sorted by their distance
+ * along the Hilbert curve, so that points resolved in sequence (and
+ * hence by the same thread) tend to hit the same areas and index nodes;
+ * ranges of sorted points are resolved in parallel.
+ *
+ * Areas are bucketed by their `admin_level` tag: for each point, only
+ * the smallest containing area of each admin level is reported (so
+ * overlapping or duplicate boundaries of the same level, such as a
+ * country's land and maritime boundaries, yield a single result).
+ * Areas without a numeric `admin_level` (from 1 to 63) are all
+ * reported.
+ *
+ * Features that aren't areas are ignored.
+ */
+class GEODESK_API PointLocator
+{
+public:
+    explicit PointLocator(const View& view);
+
+    /**
+     * Returns, for each point, the indexes (into areas()) of the
+     * areas that contain it (including points on their boundary),
+     * one per admin level, ordered from the largest area to the
+     * smallest.
+     *
+     * If resolving the points on any thread fails, the exception
+     * is rethrown on the calling thread.
+     */
+    std::vector<std::vector<uint32_t>> locate(std::span<const Coordinate> points) const;
+
+    const std::vector<Feature>& areas() const { return areas_; }
+
+private:
+    struct Area
+    {
+        SharedMCIndex index;
+        uint32_t number;
+        int adminLevel;         // 0 if none
+    };
+
+    struct PointQuery
+    {
+        Coordinate point;
+        std::vector<uint32_t>* found;
+    };
+
+    static const size_t MIN_POINTS_PER_THREAD = 1024;
+
+    void buildIndexes();
+    void buildTree();
+    static bool containsPoint(const RTree<const Area>::Node* node, PointQuery* query);
+    void keepSmallestPerLevel(std::vector<uint32_t>& found) const;
+
+    std::vector<Feature> areas_;    // sorted by decreasing size
+    std::vector<Area> indexes_;
+    clarisma::Arena arena_;
+    RTree<const Area> tree_;
+};
+
+// \endcond
+} // namespace geodesk
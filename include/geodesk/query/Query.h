@@ -6,6 +6,7 @@
 #include "AbstractQuery.h"
 #include <condition_variable>
 #include <unordered_set>
+#include <vector>
 #include <geodesk/query/QueryResults.h>
 #include <geodesk/query/TileIndexWalker.h>
 #include <geodesk/feature/FeatureStore.h>
@@ -20,15 +21,27 @@ class Filter;
 class Query : public AbstractQuery
 {
 public:
+    /**
+     * If `hilbertOrdered` is set, features are returned in order of
+     * the distance along the Hilbert curve of their centers (for nodes,
+     * their location). The tiles are requested in order of the lowest
+     * distance of any feature they may contain, the worker threads sort
+     * the results of each tile, and next() merges these sorted runs as
+     * tiles complete: A feature is returned as soon as no tile that is
+     * still being searched can yield a feature with a lower distance.
+     */
     Query(FeatureStore* store, const Box& box, FeatureTypes types, 
-        const MatcherHolder* matcher, const Filter* filter); 
+        const MatcherHolder* matcher, const Filter* filter,
+        bool hilbertOrdered = false);
     ~Query();
     const Box& bounds() const { return tileIndexWalker_.bounds(); }
     FeatureTypes types() const { return types_; }
     const MatcherHolder* matcher() const { return matcher_; }
     const Filter* filter() const { return filter_; }
     FeatureStore* store() const { return store_; }
+    bool isHilbertOrdered() const { return hilbertOrdered_; }
     void offer(QueryResults* results);
+    void offerSorted(SortedQueryResults&& results);
     void cancel();
 
     FeaturePtr next();
@@ -36,8 +49,43 @@ public:
     static constexpr uint32_t REQUIRES_DEDUP = 0x8000'0000;
 
 private:
+    /**
+     * A position within the sorted results of a tile, while
+     * merging the results of all tiles.
+     */
+    struct MergeCursor
+    {
+        std::vector<uint64_t> entries;
+        size_t pos;
+        DataPtr pTile;
+
+        uint64_t current() const { return entries[pos]; }
+
+        // Reversed, because the STL heap functions build a max-heap
+        bool operator<(const MergeCursor& other) const
+        {
+            return current() > other.current();
+        }
+    };
+
+    /**
+     * A tile to be searched by a query in Hilbert order, along with
+     * the lowest distance along the Hilbert curve of any feature it
+     * may return.
+     */
+    struct HilbertTile
+    {
+        uint32_t lowestDistance;
+        uint32_t tipAndFlags;
+        FastFilterHint fastFilterHint;
+    };
+
     const QueryResults* take();
     void requestTiles();
+    FeaturePtr nextInHilbertOrder();
+    void collectHilbertTiles();
+    void takeSorted();
+    uint64_t lowestPendingDistance() const;
     static void deleteResults(const QueryResults* res);
 
     // FeatureStore* store_;  // moved to AbstractQuery
@@ -48,6 +96,12 @@ private:
     const QueryResults* currentResults_;
     int32_t currentPos_;
     bool allTilesRequested_;
+    bool hilbertOrdered_;
+    std::vector<MergeCursor> mergeHeap_;
+    std::vector<HilbertTile> hilbertTiles_;     // by ascending lowestDistance
+    std::vector<bool> tilesCompleted_;
+    size_t nextHilbertTile_;            // the next tile to request
+    size_t firstIncompleteTile_;        // all tiles before it have completed
     std::unordered_set<uint64_t> potentialDupes_;
     TileIndexWalker tileIndexWalker_;
 
@@ -60,6 +114,7 @@ private:
     std::condition_variable resultsReady_;  // requires mutex_
     QueryResults* queuedResults_;           // requires mutex_
     int32_t completedTiles_;                // requires mutex_
+    std::vector<SortedQueryResults> sortedResults_;  // requires mutex_
     // bool isCancelled_;                      // requires mutex_
 };
 
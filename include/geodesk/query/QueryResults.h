@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include <clarisma/util/DataPtr.h>
 
 namespace geodesk {
@@ -35,6 +36,21 @@ struct QueryResults : public QueryResultsHeader
     uint32_t items[DEFAULT_BUCKET_SIZE];
 };
 
+/**
+ * The results of a single tile, sorted by the distance along the
+ * Hilbert curve of each feature (used by queries in Hilbert order).
+ * Each entry holds the distance in its upper 32 bits and the item
+ * (as in QueryResults) in its lower 32 bits, so entries can be
+ * compared directly. `tileNumber` is the position of the tile in
+ * the order in which the query requested its tiles.
+ */
+struct SortedQueryResults
+{
+    clarisma::DataPtr pTile;
+    uint32_t tileNumber;
+    std::vector<uint64_t> entries;
+};
+
 // \endcond
 
 } // namespace geodesk
@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <clarisma/alloc/Arena.h>
+#include <geodesk/feature/FeatureBase.h>
+#include <geodesk/feature/View.h>
+#include <geodesk/geom/index/RTree.h>
+
+namespace geodesk {
+
+class Filter;
+
+/// \cond lowlevel
+
+/**
+ * Finds all pairs of features from two Views that satisfy a spatial
+ * predicate, e.g. every building along with the landuse area it lies
+ * within, or every shop within 50 meters of a station.
+ *
+ * The features on the right side are placed into a Hilbert-packed
+ * R-tree (their bounding boxes are enlarged by the distance for
+ * MAX_DISTANCE). The features on the left side are sorted along the
+ * Hilbert curve (by the centers of their bounding boxes) and split into
+ * contiguous ranges, which are spatially compact like tiles; these are
+ * probed against the R-tree in parallel.
+ *
+ * The prepared filter of each right-side feature (as used by
+ * `within()`, `intersecting()` or `maxMetersFrom()`) is built at most
+ * once, the first time a left-side feature needs to be tested against
+ * it, and is then shared by all threads. For MAX_DISTANCE, this means
+ * the segments of the right-side feature are indexed (see
+ * FeatureDistanceFilter), and a left-side feature lies within the
+ * distance if it is closer than `meters` (as with maxMetersFrom()).
+ *
+ * If probing fails on any thread, the exception is rethrown by run().
+ *
+ * Anonymous nodes are ignored.
+ */
+class GEODESK_API SpatialJoin
+{
+public:
+    enum class Predicate
+    {
+        INTERSECTS,     // left intersects right
+        WITHIN,         // left lies within right
+        CONTAINS,       // left contains right
+        MAX_DISTANCE    // left lies within `meters` of right
+    };
+
+    SpatialJoin(const View& left, const View& right,
+        Predicate predicate, double meters = 0);
+    ~SpatialJoin();
+
+    /**
+     * Returns all pairs of (left, right) features for which the
+     * predicate holds.
+     */
+    std::vector<std::pair<Feature,Feature>> run();
+
+private:
+    struct Candidate
+    {
+        uint32_t number;
+    };
+
+    /**
+     * Releases a prepared filter when its owning pointer goes away.
+     */
+    struct FilterRelease
+    {
+        void operator()(const Filter* filter) const;
+    };
+
+    using FilterPtr = std::unique_ptr<const Filter, FilterRelease>;
+
+    struct Probe
+    {
+        SpatialJoin* join;
+        const Feature* left;
+        Box bounds;
+        FilterPtr leftFilter;
+        std::vector<std::pair<Feature,Feature>>* results;
+    };
+
+    static const size_t MIN_FEATURES_PER_THREAD = 256;
+
+    static std::vector<Feature> collect(const View& view);
+    void buildTree();
+    void probe(const Feature& left, std::vector<std::pair<Feature,Feature>>& results);
+    static bool acceptCandidate(const RTree<const Candidate>::Node* node, Probe* probe);
+    const Filter* rightFilter(uint32_t n);
+    const Filter* prepareFilter(const Feature& feature) const;
+
+    const View& left_;
+    const View& right_;
+    Predicate predicate_;
+    double meters_;
+    std::vector<Feature> rightFeatures_;
+    std::vector<Candidate> candidates_;
+    std::unique_ptr<std::once_flag[]> filtersPrepared_;
+    std::unique_ptr<FilterPtr[]> filters_;
+    clarisma::Arena arena_;
+    RTree<const Candidate> tree_;
+};
+
+// \endcond
+} // namespace geodesk
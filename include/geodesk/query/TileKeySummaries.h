@@ -0,0 +1,121 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <clarisma/util/DataPtr.h>
+#include <geodesk/feature/Tip.h>
+
+namespace geodesk {
+
+using clarisma::DataPtr;
+
+/// \cond lowlevel
+
+/**
+ * For a single tile, the indexed-key categories (as IndexBits) that
+ * occur among the features of each branch and leaf of its spatial
+ * indexes. A query can skip any branch or leaf whose bits don't
+ * satisfy MatcherHolder::acceptIndex(), the same way it already
+ * skips entire index roots.
+ *
+ * Entries are keyed by the offset of the branch/leaf relative to
+ * the tile (sorted, so they can be found by binary search);
+ * branches or leaves without an entry must be searched.
+ */
+class TileKeySummary
+{
+public:
+    uint32_t keysOf(DataPtr pTile, DataPtr pChild) const;
+
+    size_t size() const
+    {
+        return sizeof(TileKeySummary) + entries_.capacity() * sizeof(Entry);
+    }
+
+private:
+    using Entry = std::pair<uint32_t,uint32_t>;     // offset, keys
+
+    std::vector<Entry> entries_;
+
+    friend class TileKeySummaries;
+};
+
+using SharedTileKeySummary = std::shared_ptr<const TileKeySummary>;
+
+/**
+ * A memory-bounded LRU cache of per-tile key summaries, built lazily
+ * (in memory) the first time a tile is searched with a query that
+ * uses indexed keys. Building a tile's summary costs about as much
+ * as one full scan of the tile, so this pays off for stores that
+ * serve many sparse-tag queries (e.g. `na[shop=bakery]`) over the
+ * same area.
+ *
+ * Summaries are opt-in: the budget is zero (disabled) by default;
+ * use FeatureStore::enableKeySummaries() to turn them on. The budget
+ * may be changed at any time, even while queries are running.
+ * Summaries are shared: evicting a summary does not affect a query
+ * that is still using it.
+ *
+ * Thread-safe.
+ */
+class TileKeySummaries
+{
+public:
+    static constexpr size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+
+    using IndexedKeyMap = std::unordered_map<uint16_t, uint16_t>;
+
+    TileKeySummaries() : maxBytes_(0), totalBytes_(0) {}
+
+    /**
+     * Sets the key categories of the store's indexed keys.
+     * Must be called before the summaries are enabled.
+     */
+    void setIndexedKeys(const IndexedKeyMap& keysToCategories);
+
+    bool isEnabled() const { return maxBytes_ > 0; }
+
+    /**
+     * Returns the summary for the given tile, building it if needed.
+     */
+    SharedTileKeySummary get(Tip tip, DataPtr pTile);
+
+    void setMaxBytes(size_t maxBytes);
+    void clear();
+
+private:
+    struct Entry
+    {
+        Tip tip;
+        SharedTileKeySummary summary;
+        size_t size;
+    };
+
+    uint32_t summarizeTree(DataPtr pTile, DataPtr p, bool isLeaf,
+        bool isNodeTree, TileKeySummary* summary) const;
+    void summarizeIndex(DataPtr pTile, DataPtr ppRoot, bool isNodeTree,
+        TileKeySummary* summary) const;
+    void summarizeRoot(DataPtr pTile, DataPtr ppRoot, bool isNodeTree,
+        TileKeySummary* summary) const;
+    uint32_t keysOfFeature(DataPtr pFeature) const;
+    void evict();       // must hold lock
+
+    std::vector<uint32_t> keyBits_;     // IndexBits for each global-key code
+    std::mutex mutex_;
+    std::list<Entry> entries_;          // most recently used first
+    std::unordered_map<uint32_t, std::list<Entry>::iterator> map_;
+    std::atomic<size_t> maxBytes_;
+    size_t totalBytes_;
+};
+
+// \endcond
+
+} // namespace geodesk
@@ -8,6 +8,7 @@
 #include <geodesk/feature/types.h>
 #include <geodesk/filter/Filter.h>
 #include <geodesk/match/Matcher.h>
+#include <geodesk/query/TileKeySummaries.h>
 
 namespace geodesk {
 
@@ -18,11 +19,14 @@ class Query;
 class TileQueryTask
 {
 public:
-    TileQueryTask(Query* query, uint32_t tipAndFlags, FastFilterHint fastFilterHint) :
+    TileQueryTask(Query* query, uint32_t tipAndFlags, FastFilterHint fastFilterHint,
+        uint32_t tileNumber = 0) :
         query_(query),
         tipAndFlags_(tipAndFlags),
+        tileNumber_(tileNumber),
         fastFilterHint_(fastFilterHint),     
-        results_(QueryResults::EMPTY)
+        results_(QueryResults::EMPTY),
+        indexType_(FeatureIndexType::NODES)
     {
     }
 
@@ -40,13 +44,20 @@ private:
     void searchRoot(DataPtr ppRoot);
     void searchBranch(DataPtr p);
     void searchLeaf(DataPtr p);
+    void acceptCandidates(const FeaturePtr* candidates,
+        const uint32_t* dupeFlags, int count);
     void addResult(uint32_t item);
+    SortedQueryResults sortResults();
+    bool acceptKeys(DataPtr pChild) const;
 
     Query* query_;
     uint32_t tipAndFlags_;
+    uint32_t tileNumber_;       // (only used for queries in Hilbert order)
     FastFilterHint fastFilterHint_;
     DataPtr pTile_;
     QueryResults* results_;
+    SharedTileKeySummary keySummary_;
+    FeatureIndexType indexType_;
 };
 
 // \endcond
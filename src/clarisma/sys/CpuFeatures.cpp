@@ -0,0 +1,29 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <clarisma/sys/CpuFeatures.h>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace clarisma {
+
+bool CpuFeatures::hasAvx2()
+{
+	#if defined(_MSC_VER) && defined(_M_X64)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuid(info, 1);
+	bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6);
+	__cpuidex(info, 7, 0);
+	return osSavesYmm && (info[1] & (1 << 5));
+	#elif defined(__x86_64__)
+	return __builtin_cpu_supports("avx2");
+	#else
+	return false;
+	#endif
+}
+
+} // namespace clarisma
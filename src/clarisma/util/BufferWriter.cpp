@@ -31,6 +31,22 @@ void BufferWriter::formatDouble(double d, int precision, bool zeroFill)
 	writeBytes(start, end - start);
 }
 
+void BufferWriter::formatFixed(int64_t scaled, int precision, bool zeroFill)
+{
+	assert(precision >= 0 && precision <= 15);
+	char buf[64];
+	int64_t multiplier = static_cast<int64_t>(Math::POWERS_OF_10[precision]);
+	int64_t intPart = scaled / multiplier;
+	int64_t fracPart = scaled - intPart * multiplier;
+	char* end = buf + sizeof(buf);
+	char* start = formatFractionalReverse(
+		static_cast<unsigned long long>(fracPart < 0 ? -fracPart : fracPart),
+		&end, precision, zeroFill);
+	if (start != end) *(--start) = '.';
+	start = formatLongReverse(intPart, start, scaled < 0);
+	writeBytes(start, end - start);
+}
+
 // rename to formatLong
 void BufferWriter::formatInt(int64_t d)
 {
@@ -0,0 +1,219 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/feature/CoordinateDecoder.h>
+#include <clarisma/util/varint.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GEODESK_COORDINATE_DECODER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GEODESK_TARGET_SSSE3
+#else
+#define GEODESK_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+namespace geodesk {
+
+using namespace clarisma;
+
+// ==================================================================
+//  Scalar
+// ==================================================================
+
+static inline const uint8_t* decodeTail(const uint8_t* p, size_t count,
+    int32_t x, int32_t y, Coordinate* out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        x += readSignedVarint32(p);
+        y += readSignedVarint32(p);
+        out[i] = Coordinate(x, y);
+    }
+    return p;
+}
+
+static const uint8_t* decodeScalar(const uint8_t* p, size_t count,
+    Coordinate prev, Coordinate* out)
+{
+    return decodeTail(p, count, prev.x, prev.y, out);
+}
+
+#ifdef GEODESK_COORDINATE_DECODER_X86
+
+// ==================================================================
+//  SSSE3
+// ==================================================================
+
+/**
+ * For each combination of the continuation bits of 12 bytes, the
+ * shuffle pattern that places the first four varints (each at most
+ * 3 bytes long) into the low bytes of four 32-bit lanes, along with
+ * the number of bytes occupied by these varints (0 if they don't
+ * fit the pattern).
+ */
+struct ShuffleTable
+{
+    static constexpr int MASK_BITS = 12;
+    static constexpr int MAX_VARINT_LENGTH = 3;
+
+    ShuffleTable()
+    {
+        for (uint32_t mask = 0; mask < (1 << MASK_BITS); mask++)
+        {
+            uint8_t* shuffle = patterns[mask];
+            int pos = 0;
+            for (int lane = 0; lane < 4; lane++)
+            {
+                int len = 1;
+                while (pos + len <= MASK_BITS && (mask & (1 << (pos + len - 1))))
+                {
+                    len++;
+                }
+                if (len > MAX_VARINT_LENGTH || pos + len > MASK_BITS)
+                {
+                    pos = 0;
+                    break;
+                }
+                for (int i = 0; i < 4; i++)
+                {
+                    shuffle[lane * 4 + i] = i < len ?
+                        static_cast<uint8_t>(pos + i) : 0x80;
+                }
+                pos += len;
+            }
+            lengths[mask] = static_cast<uint8_t>(pos);
+        }
+    }
+
+    alignas(16) uint8_t patterns[1 << MASK_BITS][16];
+    uint8_t lengths[1 << MASK_BITS];
+};
+
+static const ShuffleTable& shuffleTable()
+{
+    static const ShuffleTable table;
+    return table;
+}
+
+
+GEODESK_TARGET_SSSE3
+static const uint8_t* decodeSsse3(const uint8_t* p, size_t count,
+    Coordinate prev, Coordinate* out)
+{
+    const ShuffleTable& table = shuffleTable();
+    const __m128i lowBits = _mm_set1_epi32(0x007f7f7f);
+    const __m128i group0 = _mm_set1_epi32(0x7f);
+    const __m128i group1 = _mm_set1_epi32(0x7f << 7);
+    const __m128i group2 = _mm_set1_epi32(0x7f << 14);
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i base = _mm_set_epi32(prev.y, prev.x, prev.y, prev.x);
+
+    // Every coordinate takes at least 2 bytes, so as long as 8 or more
+    // coordinates remain to be decoded, we can safely load 16 bytes
+    size_t i = 0;
+    while (count - i >= 8)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(bytes)) &
+            ((1 << ShuffleTable::MASK_BITS) - 1);
+        int length = table.lengths[mask];
+        if (length == 0)
+        {
+            // At least one of the next four varints is longer than 3 bytes
+            int32_t x = _mm_cvtsi128_si32(base);
+            int32_t y = _mm_cvtsi128_si32(_mm_srli_si128(base, 4));
+            p = decodeTail(p, 2, x, y, out + i);
+            base = _mm_set_epi32(out[i + 1].y, out[i + 1].x,
+                out[i + 1].y, out[i + 1].x);
+            i += 2;
+            continue;
+        }
+        __m128i v = _mm_shuffle_epi8(bytes, _mm_load_si128(
+            reinterpret_cast<const __m128i*>(table.patterns[mask])));
+        v = _mm_and_si128(v, lowBits);
+        v = _mm_or_si128(_mm_or_si128(
+            _mm_and_si128(v, group0),
+            _mm_and_si128(_mm_srli_epi32(v, 1), group1)),
+            _mm_and_si128(_mm_srli_epi32(v, 2), group2));
+
+        // Zigzag-decode: (v >> 1) ^ -(v & 1)
+        v = _mm_xor_si128(_mm_srli_epi32(v, 1),
+            _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, one)));
+
+        // [dx0 dy0 dx1 dy1] --> [x0 y0 x1 y1]
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, base);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+        base = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 2, 3, 2));
+        p += length;
+        i += 2;
+    }
+    int32_t x = _mm_cvtsi128_si32(base);
+    int32_t y = _mm_cvtsi128_si32(_mm_srli_si128(base, 4));
+    return decodeTail(p, count - i, x, y, out + i);
+}
+
+
+static bool cpuSupportsSsse3()
+{
+    #ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+    #else
+    return __builtin_cpu_supports("ssse3");
+    #endif
+}
+
+#endif // GEODESK_COORDINATE_DECODER_X86
+
+// ==================================================================
+//  Dispatch
+// ==================================================================
+
+CoordinateDecoder::Dispatch& CoordinateDecoder::dispatch()
+{
+    static Dispatch dispatch = []()
+    {
+        Dispatch d{ decodeScalar, Implementation::SCALAR };
+        #ifdef GEODESK_COORDINATE_DECODER_X86
+        if (cpuSupportsSsse3())
+        {
+            d = { decodeSsse3, Implementation::SSSE3 };
+        }
+        #endif
+        return d;
+    }();
+    return dispatch;
+}
+
+
+bool CoordinateDecoder::select(Implementation impl)
+{
+    Dispatch& d = dispatch();
+    switch (impl)
+    {
+    case Implementation::SCALAR:
+        d = { decodeScalar, impl };
+        return true;
+    #ifdef GEODESK_COORDINATE_DECODER_X86
+    case Implementation::SSSE3:
+        if (!cpuSupportsSsse3()) return false;
+        d = { decodeSsse3, impl };
+        return true;
+    #endif
+    default:
+        return false;
+    }
+}
+
+
+const char* CoordinateDecoder::implementationName()
+{
+    return implementation() == Implementation::SSSE3 ? "SSSE3" : "scalar";
+}
+
+} // namespace geodesk
@@ -0,0 +1,142 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/feature/DerivedAttributes.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <clarisma/io/IOException.h>
+#include <clarisma/thread/Threads.h>
+#include <geodesk/geodesk.h>
+#include <geodesk/geom/Area.h>
+#include <geodesk/geom/Centroid.h>
+#include <geodesk/geom/LabelPoint.h>
+#include <geodesk/geom/Length.h>
+
+namespace geodesk {
+
+using namespace clarisma;
+
+DerivedAttributes::~DerivedAttributes()
+{
+	unmapSegments();
+}
+
+
+void DerivedAttributes::open(FeatureStore* store, const char* fileName)
+{
+	ExpandableMappedFile::open(fileName, OpenMode::READ);
+	const Header* header = reinterpret_cast<const Header*>(mainMapping());
+	if (size() < RECORDS_OFS || header->magic != MAGIC || header->version != VERSION)
+	{
+		throw IOException("%s: Not a derived-attributes file", fileName);
+	}
+	if (memcmp(header->guid, store->guid(), sizeof(header->guid)) != 0)
+	{
+		throw IOException("%s: Built for a different GOL", fileName);
+	}
+	wayCount_ = header->wayCount;
+	relationCount_ = header->relationCount;
+	if (size() < RECORDS_OFS + (wayCount_ + relationCount_) * sizeof(Record))
+	{
+		throw IOException("%s: File is truncated", fileName);
+	}
+}
+
+
+static void measure(FeatureStore* store, FeaturePtr feature, DerivedAttributes::Record* rec)
+{
+	try
+	{
+		if (feature.isWay())
+		{
+			WayPtr way(feature);
+			rec->area = way.isArea() ? Area::ofWay(way) : 0;
+			rec->length = Length::ofWay(way);
+		}
+		else
+		{
+			RelationPtr relation(feature);
+			rec->area = relation.isArea() ? Area::ofRelation(store, relation) : 0;
+			rec->length = Length::ofRelation(store, relation);
+		}
+		rec->centroid = Centroid::ofFeature(store, feature);
+		rec->labelPoint = LabelPoint::ofFeature(store, feature);
+	}
+	catch (const std::exception&)
+	{
+		// Leave the record empty (e.g. if tiles are missing); the
+		// accessors will compute the values on demand
+		*rec = {};
+	}
+}
+
+
+void DerivedAttributes::build(const Features& features, const char* fileName)
+{
+	FeatureStore* store = features.store();
+
+	// First, determine the extent of the two arrays
+	uint64_t wayCount = 0;
+	uint64_t relationCount = 0;
+	for (Feature f : features.ways())
+	{
+		wayCount = std::max(wayCount, static_cast<uint64_t>(f.id()) + 1);
+	}
+	for (Feature f : features.relations())
+	{
+		relationCount = std::max(relationCount, static_cast<uint64_t>(f.id()) + 1);
+	}
+
+	DerivedAttributes file;
+	file.ExpandableMappedFile::open(fileName,
+		OpenMode::READ | OpenMode::WRITE | OpenMode::CREATE | OpenMode::REPLACE_EXISTING);
+
+	const int threadCount = std::max(1u, std::thread::hardware_concurrency());
+	static constexpr size_t BATCH_SIZE = 64 * 1024;
+	std::vector<FeaturePtr> batch;
+	batch.reserve(BATCH_SIZE);
+
+	// Any exception that measure() doesn't handle is rethrown here,
+	// which abandons the build (the header is never written)
+	auto measureBatch = [&]()
+	{
+		Threads::runInParallel(threadCount, [&](size_t part)
+		{
+			for (size_t i = part; i < batch.size(); i += threadCount)
+			{
+				FeaturePtr feature = batch[i];
+				uint64_t index = feature.isWay() ? feature.id() : (wayCount + feature.id());
+				Record* rec = reinterpret_cast<Record*>(
+					file.translate(RECORDS_OFS + index * sizeof(Record)));
+				measure(store, feature, rec);
+			}
+		});
+		batch.clear();
+	};
+
+	for (const Features& type : { Features(features.ways()), Features(features.relations()) })
+	{
+		for (Feature f : type)
+		{
+			batch.push_back(f.ptr());
+			if (batch.size() == BATCH_SIZE) measureBatch();
+		}
+	}
+	if (!batch.empty()) measureBatch();
+
+	// Write the header last, so an incomplete file is never mistaken
+	// for a valid sidecar
+	Header* header = reinterpret_cast<Header*>(file.translate(0));
+	memcpy(header->guid, store->guid(), sizeof(header->guid));
+	header->wayCount = wayCount;
+	header->relationCount = relationCount;
+	header->version = VERSION;
+	header->magic = MAGIC;
+
+	file.unmapSegments();
+	file.truncate(RECORDS_OFS + (wayCount + relationCount) * sizeof(Record));
+}
+
+} // namespace geodesk
@@ -30,7 +30,8 @@ FeatureIteratorBase::FeatureIteratorBase(const View& view) :
     case View::WORLD:
         type_ = WORLD;
         new (&storage_.worldQuery) Query(view.store(), view.bounds(),
-            view.types(), view.matcher(), view.filter());
+            view.types(), view.matcher(), view.filter(),
+            view.isSortedByHilbert());
         break;
     case View::MEMBERS:
         type_ = RELATION_MEMBERS;
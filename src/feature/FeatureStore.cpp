@@ -3,6 +3,7 @@
 
 #include <geodesk/feature/FeatureStore.h>
 #include <filesystem>
+#include <geodesk/feature/LocalKeyCache.h>
 #include <clarisma/util/log.h>
 #include <clarisma/util/PbfDecoder.h>
 #ifdef GEODESK_PYTHON
@@ -82,6 +83,7 @@ void FeatureStore::initialize()
 	strings_.create(getPointer(STRING_TABLE_PTR_OFS));
 	zoomLevels_ = DataPtr(mainMapping() + ZOOM_LEVELS_OFS).getUnsignedInt();
 	readIndexSchema();
+	keySummaries_.setIndexedKeys(keysToCategories_);
 }
 
 FeatureStore::~FeatureStore()
@@ -93,6 +95,10 @@ FeatureStore::~FeatureStore()
 	#endif
 	LOG("Destroyed FeatureStore.");
 
+	// The key strings memoized by the threads' LocalKeyCaches
+	// may refer to this store's memory
+	LocalKeyCache::invalidateAll();
+
 	std::lock_guard lock(getOpenStoresMutex());
 	auto openStores = getOpenStores();
 	openStores.erase(fileName());
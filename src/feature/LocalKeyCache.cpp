@@ -0,0 +1,38 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/feature/LocalKeyCache.h>
+
+namespace geodesk {
+
+std::atomic<uint64_t> LocalKeyCache::currentEpoch_(0);
+
+LocalKeyCache& LocalKeyCache::forKey(std::string_view key)
+{
+    thread_local LocalKeyCache caches[RECENT_KEYS];
+    thread_local int next = 0;
+
+    uint64_t currentEpoch = epoch();
+    for (LocalKeyCache& cache : caches)
+    {
+        if (cache.key_ != key) continue;
+        if (cache.epoch_ != currentEpoch)
+        {
+            // A FeatureStore has been closed since this cache was
+            // last used, so its key strings may have been unmapped
+            cache.clear();
+            cache.epoch_ = currentEpoch;
+        }
+        return cache;
+    }
+
+    // Replace the cache of the least recently added key
+    LocalKeyCache& cache = caches[next];
+    next = (next + 1) % RECENT_KEYS;
+    cache.key_ = key;
+    cache.epoch_ = currentEpoch;
+    cache.clear();
+    return cache;
+}
+
+} // namespace geodesk
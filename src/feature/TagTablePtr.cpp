@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/feature/TagTablePtr.h>
+#include <geodesk/feature/LocalKeyCache.h>
 #include <clarisma/util/ShortVarString.h>
 #include <clarisma/util/StringBuilder.h>
 
@@ -35,7 +36,9 @@ int64_t TagTablePtr::getKeyValue(PyObject* key, const StringTable& strings) cons
   const char* str;
   Py_ssize_t len;
   str = PyUnicode_AsUTF8AndSize(key, &len);
-  return getLocalKeyValue(str, static_cast<int>(len));
+  if (!hasLocalKeys()) return 0;
+  return getLocalKeyValue(LocalKeyCache::forKey(
+    std::string_view(str, static_cast<size_t>(len))));
 }
 
 #endif
@@ -48,7 +51,8 @@ TagBits TagTablePtr::getKeyValue(const char* key, size_t len,
   {
     return getGlobalKeyValue(code);
   }
-  return getLocalKeyValue(key, len);
+  if (!hasLocalKeys()) return 0;
+  return getLocalKeyValue(LocalKeyCache::forKey(std::string_view(key, len)));
 }
 
 TagBits TagTablePtr::getKeyValue(Key key) const
@@ -58,12 +62,17 @@ TagBits TagTablePtr::getKeyValue(Key key) const
     assert(key.code() <= TagValues::MAX_COMMON_KEY);
     return getGlobalKeyValue(key.code());
   }
-  return getLocalKeyValue(key.data(), key.size());
+  if (!hasLocalKeys()) return 0;
+  return getLocalKeyValue(LocalKeyCache::forKey(key));
 }
 
-TagBits TagTablePtr::getLocalKeyValue(const char* key, size_t len) const
+/**
+ * Walks the uncommon keys of this tag table and returns the value of
+ * the first key whose string is accepted by `match`.
+ */
+template<typename Match>
+TagBits TagTablePtr::findLocalKey(Match match) const
 {
-  if (!hasLocalKeys() || !len) return 0;
   DataPtr p = ptr();
   DataPtr origin = alignedBasePtr();
   p -= 6;
@@ -75,7 +84,7 @@ TagBits TagTablePtr::getLocalKeyValue(const char* key, size_t len) const
     // uncommon keys are relative to the 4-byte-aligned tagtable address
     const ShortVarString* keyString = reinterpret_cast<const ShortVarString*>
       (origin.ptr() + ((rawPointer ^ flags) >> 1));
-    if (keyString->equals(key, len))
+    if (match(keyString))
     {
       return (static_cast<TagBits>(pointerOffset(p) - 2) << 32) |
         ((tag & 0xffff) << 16) | flags;
@@ -85,6 +94,29 @@ TagBits TagTablePtr::getLocalKeyValue(const char* key, size_t len) const
   }
 }
 
+TagBits TagTablePtr::getLocalKeyValue(const char* key, size_t len) const
+{
+  if (!hasLocalKeys() || !len) return 0;
+  return findLocalKey([key, len](const ShortVarString* keyString)
+  {
+    return keyString->equals(key, len);
+  });
+}
+
+/**
+ * Same as getLocalKeyValue(const char*,size_t), but resolves key strings
+ * via the given cache, which avoids comparing the same key string
+ * more than once (see LocalKeyCache).
+ */
+TagBits TagTablePtr::getLocalKeyValue(LocalKeyCache& key) const
+{
+  if (!hasLocalKeys() || key.key().empty()) return 0;
+  return findLocalKey([&key](const ShortVarString* keyString)
+  {
+    return key.matches(keyString);
+  });
+}
+
 TagBits TagTablePtr::getGlobalKeyValue(int key) const
 {
   uint16_t keyBits = key << 2;
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/feature/WayCoordinateIterator.h>
+#include <algorithm>
+#include <geodesk/feature/CoordinateDecoder.h>
 
 namespace geodesk {
 
@@ -51,4 +53,36 @@ Coordinate WayCoordinateIterator::next()
     return c;
 }
 
+int WayCoordinateIterator::nextBatch(Coordinate* coords, int maxCount)
+{
+    int count = 0;
+    if (remaining_ > 0)
+    {
+        // The coordinate in x_/y_ has already been decoded
+        count = std::min(remaining_, maxCount);
+        coords[0] = Coordinate(x_, y_);
+        p_ = CoordinateDecoder::decode(p_, count - 1, coords[0], coords + 1);
+        remaining_ -= count;
+        if (remaining_ > 0)
+        {
+            x_ = coords[count - 1].x + readSignedVarint32(p_);
+            y_ = coords[count - 1].y + readSignedVarint32(p_);
+            return count;
+        }
+        x_ = firstX_;
+        y_ = firstY_;
+        firstX_ = 0;
+        firstY_ = 0;
+        if (count == maxCount) return count;
+    }
+    if (x_ != 0 || y_ != 0)
+    {
+        // the duplicated first coordinate of an area
+        coords[count++] = Coordinate(x_, y_);
+        x_ = 0;
+        y_ = 0;
+    }
+    return count;
+}
+
 } // namespace geodesk
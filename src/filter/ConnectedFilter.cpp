@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/filter/ConnectedFilter.h>
+#include <algorithm>
 #include <geodesk/feature/FastMemberIterator.h>
 #include <geodesk/feature/WayCoordinateIterator.h>
 
@@ -9,13 +10,15 @@ namespace geodesk {
 
 ConnectedFilter::ConnectedFilter(FeatureStore* store, FeaturePtr feature)
 {
+	flags_ |= FilterFlags::FAST_TILE_FILTER;
 	self_ = feature.idBits();
+	std::vector<Coordinate> points;
 	if (feature.isWay())
 	{
 		WayPtr way(feature);
 		if (!way.isPlaceholder())
 		{
-			collectWayPoints(way);
+			collectWayPoints(way, points);
 			bounds_ = way.bounds();
 		}
 	}
@@ -25,7 +28,7 @@ ConnectedFilter::ConnectedFilter(FeatureStore* store, FeaturePtr feature)
 		if (!node.isPlaceholder())
 		{
 			Coordinate c = node.xy();
-			points_.insert(c);
+			points.push_back(c);
 			bounds_ = Box(c);
 		}
 	}
@@ -34,13 +37,59 @@ ConnectedFilter::ConnectedFilter(FeatureStore* store, FeaturePtr feature)
 		assert(feature.isRelation());
 		RelationPtr relation(feature);
 		RecursionGuard guard(relation);
-		collectMemberPoints(store, relation, guard);
+		collectMemberPoints(store, relation, guard, points);
 		bounds_ = relation.bounds();
 	}
+	points_.build(points);
+	collectTiles(points);
 }
 
 
-void ConnectedFilter::collectWayPoints(WayPtr way)
+/**
+ * Records the tiles that contain the points, at every zoom level.
+ * A feature that shares a point with the reference feature must
+ * have a bounding box that intersects the tile containing that
+ * point, hence it is indexed in that tile (or in the tile's
+ * ancestor at the feature's level). Other tiles can be skipped.
+ */
+void ConnectedFilter::collectTiles(const std::vector<Coordinate>& points)
+{
+	std::vector<uint32_t> maxZoomTiles;
+	uint32_t prevTile = 0xffff'ffff;
+	for (Coordinate c : points)
+	{
+		uint32_t tile = static_cast<uint32_t>(Tile::fromColumnRowZoom(
+			Tile::columnFromXZ(c.x, MAX_ZOOM), Tile::rowFromYZ(c.y, MAX_ZOOM), MAX_ZOOM));
+		// Consecutive vertices are usually in the same tile
+		if (tile != prevTile) maxZoomTiles.push_back(tile);
+		prevTile = tile;
+	}
+	std::sort(maxZoomTiles.begin(), maxZoomTiles.end());
+	maxZoomTiles.erase(std::unique(maxZoomTiles.begin(), maxZoomTiles.end()),
+		maxZoomTiles.end());
+
+	tiles_.reserve(maxZoomTiles.size() * 2);
+	for (uint32_t t : maxZoomTiles)
+	{
+		Tile tile(t);
+		for (int zoom = 0; zoom <= MAX_ZOOM; zoom++)
+		{
+			tiles_.push_back(static_cast<uint32_t>(tile.zoomedOut(zoom)));
+		}
+	}
+	std::sort(tiles_.begin(), tiles_.end());
+	tiles_.erase(std::unique(tiles_.begin(), tiles_.end()), tiles_.end());
+}
+
+
+int ConnectedFilter::acceptTile(Tile tile) const
+{
+	return std::binary_search(tiles_.begin(), tiles_.end(),
+		static_cast<uint32_t>(tile)) ? 0 : -1;
+}
+
+
+void ConnectedFilter::collectWayPoints(WayPtr way, std::vector<Coordinate>& points)
 {
 	WayCoordinateIterator iter;
 	iter.start(way, 0);
@@ -48,12 +97,13 @@ void ConnectedFilter::collectWayPoints(WayPtr way)
 	{
 		Coordinate c = iter.next();
 		if (c.isNull()) break;
-		points_.insert(c);
+		points.push_back(c);
 	}
 }
 
 
-void ConnectedFilter::collectMemberPoints(FeatureStore* store, RelationPtr relation, RecursionGuard& guard)
+void ConnectedFilter::collectMemberPoints(FeatureStore* store, RelationPtr relation,
+	RecursionGuard& guard, std::vector<Coordinate>& points)
 {
 	FastMemberIterator iter(store, relation);
 	for (;;)
@@ -65,19 +115,19 @@ void ConnectedFilter::collectMemberPoints(FeatureStore* store, RelationPtr relat
 		{
 			WayPtr memberWay(member);
 			if (memberWay.isPlaceholder()) continue;
-			collectWayPoints(memberWay);
+			collectWayPoints(memberWay, points);
 		}
 		else if (memberType == 0)
 		{
 			NodePtr memberNode(member);
 			if (memberNode.isPlaceholder()) continue;
-			points_.insert(memberNode.xy());
+			points.push_back(memberNode.xy());
 		}
 		else
 		{
 			RelationPtr childRel(member);
 			if (childRel.isPlaceholder() || !guard.checkAndAdd(childRel)) continue;
-			collectMemberPoints(store, childRel, guard);
+			collectMemberPoints(store, childRel, guard, points);
 		}
 	}
 }
@@ -91,14 +141,14 @@ bool ConnectedFilter::acceptWay(WayPtr way) const
 	{
 		Coordinate c = iter.next();
 		if (c.isNull()) break;
-		if (points_.find(c) != points_.end()) return true;
+		if (points_.contains(c)) return true;
 	}
 	return false;
 }
 
 bool ConnectedFilter::acceptNode(NodePtr node) const
 {
-	return points_.find(node.xy()) != points_.end();
+	return points_.contains(node.xy());
 }
 
 bool ConnectedFilter::acceptAreaRelation(FeatureStore* store, RelationPtr relation) const
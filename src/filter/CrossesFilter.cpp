@@ -9,7 +9,7 @@ namespace geodesk {
 
 int CrossesFilter::acceptTile(Tile tile) const
 {
-	return index_.locateBox(tile.bounds()) == 0 ? 0 : -1;
+	return locateTile(tile) == 0 ? 0 : -1;
 }
 
 bool CrossesFilter::acceptWay(WayPtr way) const
@@ -0,0 +1,249 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/filter/FeatureDistanceFilter.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <geodesk/feature/FastMemberIterator.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+#include <geodesk/geom/Distance.h>
+#include <geodesk/geom/LineSegment.h>
+#include <geodesk/geom/Mercator.h>
+#include <geodesk/geom/index/MCIndexBuilder.h>
+#include <geodesk/geom/index/MonotoneChain.h>
+#include <geodesk/geom/polygon/PointInPolygon.h>
+
+namespace geodesk {
+
+static bool findAnyVertex(const RTree<const MonotoneChain>::Node* node, Coordinate* vertex)
+{
+	*vertex = node->item()->first();
+	return true;
+}
+
+
+SharedMCIndex FeatureDistanceFilter::indexPoints(const std::vector<Coordinate>& points)
+{
+	assert(!points.empty());
+	MCIndexBuilder builder;
+	Box bounds;
+	for (Coordinate c : points)
+	{
+		builder.addLineSegment(c, c);
+		bounds.expandToInclude(c);
+	}
+	return std::make_shared<const MCIndex>(builder.build(bounds));
+}
+
+
+FeatureDistanceFilter::FeatureDistanceFilter(double meters, const Box& bounds,
+	SharedMCIndex index, bool isArea, const std::vector<Coordinate>& nodes) :
+	PreparedSpatialFilter(bounds, index ? index : indexPoints(nodes), nullptr),
+	meters_(meters),
+	isArea_(isArea)
+{
+	flags_ |= FilterFlags::FAST_TILE_FILTER;
+
+	// Buffer the bounds (and classify tiles) using the scale at the
+	// edge closest to the pole, so the buffer covers the distance
+	// everywhere. A candidate near that edge lies even closer to the
+	// pole, so we apply the scale at the edge of the buffer instead
+	double maxY = std::numeric_limits<int32_t>::max();
+	double edgeY = std::max(std::abs(static_cast<double>(bounds.minY())),
+		std::abs(static_cast<double>(bounds.maxY())));
+	double d = Mercator::unitsFromMeters(meters, edgeY);
+	d = Mercator::unitsFromMeters(meters, std::min(edgeY + d, maxY));
+	distance_ = static_cast<int32_t>(std::min(std::ceil(d), maxY));
+	bounds_.bufferSimple(distance_);
+	if (index)
+	{
+		Coordinate anyVertex;
+		index_.findChains(Box::ofWorld(), findAnyVertex, &anyVertex);
+		anchors_.push_back(anyVertex);
+		if (!nodes.empty()) nodeIndex_ = indexPoints(nodes);
+	}
+	anchors_.insert(anchors_.end(), nodes.begin(), nodes.end());
+	tileClassifier_ = std::make_shared<const TileClassifier>(bounds_, distance_, isArea);
+}
+
+
+/**
+ * Skips tiles that lie entirely outside of the corridor, and
+ * turbo-accepts the tiles that lie entirely inside the polygon.
+ */
+int FeatureDistanceFilter::acceptTile(Tile tile) const
+{
+	int loc = locateTile(tile);
+	if (loc < 0 && nodeIndex_)
+	{
+		// The tile may still lie within distance of a member node
+		Box bounds = tile.bounds();
+		bounds.bufferSimple(distance_);
+		if (nodeIndex_->intersectsBoxBoundary(bounds)) loc = 0;
+	}
+	return loc;
+}
+
+
+bool FeatureDistanceFilter::accept(FeatureStore* store, FeaturePtr feature, FastFilterHint fast) const
+{
+	if (fast.turboFlags)
+	{
+		// The tile lies inside the polygon, hence so does any
+		// feature that lies completely within the tile
+		if (feature.isNode()) return true;
+		if ((feature.flags() &
+			(FeatureFlags::MULTITILE_NORTH | FeatureFlags::MULTITILE_WEST)) == 0)
+		{
+			if (feature.minY() >= fast.tile.bottomY() &&
+				feature.maxX() <= fast.tile.rightX())
+			{
+				return true;
+			}
+		}
+	}
+	return acceptFeature(store, feature);
+}
+
+
+struct SegmentDistanceQuery
+{
+	Coordinate start;
+	Coordinate end;
+	double distanceSquared;
+};
+
+/**
+ * Squared distance between two segments (zero if they intersect).
+ */
+static double segmentsDistanceSquared(Coordinate a1, Coordinate a2,
+	Coordinate b1, Coordinate b2)
+{
+	if (LineSegment::linesIntersect(a1, a2, b1, b2)) return 0;
+	return std::min(
+		std::min(
+			Distance::pointSegmentSquared(b1.x, b1.y, b2.x, b2.y, a1.x, a1.y),
+			Distance::pointSegmentSquared(b1.x, b1.y, b2.x, b2.y, a2.x, a2.y)),
+		std::min(
+			Distance::pointSegmentSquared(a1.x, a1.y, a2.x, a2.y, b1.x, b1.y),
+			Distance::pointSegmentSquared(a1.x, a1.y, a2.x, a2.y, b2.x, b2.y)));
+}
+
+/**
+ * Checks whether any segment of a chain lies within distance of
+ * the query segment (or point, if start and end are the same).
+ */
+static bool isChainWithinDistance(const RTree<const MonotoneChain>::Node* node,
+	const SegmentDistanceQuery* query)
+{
+	const MonotoneChain* chain = node->item();
+	Coordinate a = query->start;
+	Coordinate b = query->end;
+	Coordinate prev = chain->first();
+	for (int i = 1; i < chain->vertexCount(); i++)
+	{
+		Coordinate next = chain->vertex(i);
+		double d = (a == b) ?
+			Distance::pointSegmentSquared(prev.x, prev.y, next.x, next.y, a.x, a.y) :
+			segmentsDistanceSquared(a, b, prev, next);
+		if (d < query->distanceSquared) return true;
+		prev = next;
+	}
+	return false;
+}
+
+
+bool FeatureDistanceFilter::isSegmentWithinDistance(Coordinate start, Coordinate end) const
+{
+	// Only chains whose bounding boxes lie within distance of the
+	// segment's bounding box can contain a segment that is close enough
+	Box box = Box::normalizedSimple(start, end);
+	box.bufferSimple(distance_);
+
+	// The exact comparison uses the scale at the candidate's latitude
+	double d = Mercator::unitsFromMeters(meters_,
+		(static_cast<double>(start.y) + end.y) / 2);
+	const SegmentDistanceQuery query{ start, end, d * d };
+	if (index_.findChains(box, isChainWithinDistance, &query)) return true;
+	return nodeIndex_ && nodeIndex_->findChains(box, isChainWithinDistance, &query);
+}
+
+
+bool FeatureDistanceFilter::isPointWithinDistance(Coordinate c) const
+{
+	if (isArea_ && index_.containsPoint(c)) return true;
+	return isSegmentWithinDistance(c, c);
+}
+
+
+bool FeatureDistanceFilter::areSegmentsWithinDistance(WayPtr way, int areaFlag) const
+{
+	WayCoordinateIterator iter;
+	iter.start(way, areaFlag);
+	Coordinate start = iter.next();
+	if (isPointWithinDistance(start)) return true;
+	for (;;)
+	{
+		Coordinate end = iter.next();
+		if (end.isNull()) break;
+		if (isSegmentWithinDistance(start, end)) return true;
+		start = end;
+	}
+	return false;
+}
+
+
+bool FeatureDistanceFilter::acceptNode(NodePtr node) const
+{
+	return isPointWithinDistance(node.xy());
+}
+
+
+bool FeatureDistanceFilter::acceptWay(WayPtr way) const
+{
+	int areaFlag = way.flags() & FeatureFlags::AREA;
+	if (areSegmentsWithinDistance(way, areaFlag)) return true;
+
+	// If the candidate is an area, the geometry (or one of the member
+	// nodes) may lie entirely inside of it (without any of the edges
+	// being close enough)
+	if (!areaFlag) return false;
+	for (Coordinate anchor : anchors_)
+	{
+		if (!way.bounds().contains(anchor)) continue;
+		PointInPolygon pip(anchor);
+		pip.testAgainstWay(way);
+		if (pip.isInside()) return true;
+	}
+	return false;
+}
+
+
+bool FeatureDistanceFilter::acceptAreaRelation(FeatureStore* store, RelationPtr relation) const
+{
+	std::vector<PointInPolygon> pips;
+	for (Coordinate anchor : anchors_)
+	{
+		if (relation.bounds().contains(anchor)) pips.emplace_back(anchor);
+	}
+	FastMemberIterator iter(store, relation);
+	for (;;)
+	{
+		FeaturePtr member = iter.next();
+		if (member.isNull()) break;
+		if (!member.isWay()) continue;
+		WayPtr memberWay(member);
+		if (memberWay.isPlaceholder()) continue;
+		if (areSegmentsWithinDistance(memberWay, member.flags())) return true;
+		for (PointInPolygon& pip : pips) pip.testAgainstWay(memberWay);
+	}
+	for (const PointInPolygon& pip : pips)
+	{
+		if (pip.isInside()) return true;
+	}
+	return false;
+}
+
+} // namespace geodesk
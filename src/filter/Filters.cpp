@@ -5,6 +5,7 @@
 #include <geodesk/feature/FeatureBase.h>
 #include <geodesk/feature/QueryException.h>
 #include <geodesk/filter/CrossesFilter.h>
+#include <geodesk/filter/FeatureDistanceFilter.h>
 #include <geodesk/filter/IntersectsFilter.h>
 #include <geodesk/filter/PointDistanceFilter.h>
 #include <geodesk/filter/WithinFilter.h>
@@ -55,4 +56,9 @@ const Filter* Filters::maxMetersFrom(double meters, Coordinate xy)
     return new PointDistanceFilter(meters, xy);
 }
 
+const Filter* Filters::maxMetersFrom(double meters, Feature feature)
+{
+    return filter(MaxDistanceFilterFactory(meters), feature);
+}
+
 } // namespace geodesk
@@ -83,8 +83,7 @@ bool IntersectsPolygonFilter::accept(FeatureStore* store, FeaturePtr feature, Fa
 
 int IntersectsPolygonFilter::acceptTile(Tile tile) const
 {
-	Box tileBounds = tile.bounds();
-	int loc = index_.locateBox(tileBounds);
+	int loc = locateTile(tile);
 	if (loc > 0) return 1;
 	// TODO: Don't use 1 to indicate tile acceleration, use enum constant
 	return loc;
@@ -2,168 +2,54 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/filter/PointDistanceFilter.h>
+#include <cmath>
 #include <geodesk/feature/FeatureStore.h>
-#include <geodesk/feature/FastMemberIterator.h>
-#include <geodesk/feature/WayPtr.h>
-#include <geodesk/geom/polygon/PointInPolygon.h>
-#include <geodesk/geom/Distance.h>
 
 namespace geodesk {
 
-// TODO: Conditionally accelerate if distance is far enough that
-// some tiles could lie outside the circle
-
-PointDistanceFilter::PointDistanceFilter(double meters, Coordinate point)
-	: point_(point)
+PointDistanceFilter::PointDistanceFilter(double meters, Coordinate point) :
+	distance_(point)
 {
+	flags_ |= FilterFlags::FAST_TILE_FILTER;
 	double d = Mercator::unitsFromMeters(meters, point.y);
 	bounds_ = Box::unitsAroundXY((int32_t)std::ceil(d), point);
 	distanceSquared_ = d * d;
+	distance_ = PointDistance(point, distanceSquared_);
 }
 
 
-bool PointDistanceFilter::segmentsWithinDistance(WayPtr way, int areaFlag) const
-{
-    WayCoordinateIterator iter;
-    iter.start(way, areaFlag);
-    Coordinate c = iter.next();
-    double x1 = c.x;
-    double y1 = c.y;
-    for(;;)
-    {
-        c = iter.next();
-        if (c.isNull()) break;
-        double x2 = c.x;
-        double y2 = c.y;
-        if (Distance::pointSegmentSquared(x1, y1, x2, y2,
-            point_.x, point_.y) < distanceSquared_)
-        {
-            return true;
-        }
-        x1 = x2;
-        y1 = y2;
-    }
-    return false;
-}
-
-
-bool PointDistanceFilter::isWithinDistance(WayPtr way) const
-{
-    if (way.isArea())
-    {
-        if (segmentsWithinDistance(way, FeatureFlags::AREA)) return true;
-        // The distance of a point that lies within a polygon is zero;
-        // we need to perform p-in-p check because the edges themselves
-        // may be far away from the comparison point
-        // TODO: check bbox first?
-        Box bounds = way.bounds();
-        if (!bounds.contains(point_)) return false;
-        PointInPolygon pip(point_);
-        pip.testAgainstWay(way);
-        return pip.isInside();
-        /*
-        if (point_.y >= bounds.minY() && point_.y <= bounds.maxY())
-        {
-            return way.containsPointFast(point_.x, point_.y);
-        }
-        */
-    }
-    return segmentsWithinDistance(way, 0);
-}
-
-
-bool PointDistanceFilter::isAreaWithinDistance(FeatureStore* store, RelationPtr relation) const
+/**
+ * Skips tiles that lie entirely outside of the circle, and turbo-accepts
+ * the nodes of tiles that lie entirely within it. Only tiles that
+ * straddle the circle's boundary need to be filtered feature by feature.
+ */
+int PointDistanceFilter::acceptTile(Tile tile) const
 {
-    // measure distance to the ways that define shell and holes, and
-    // also perform point in polygon test
-    int odd = 0;
-    PointInPolygon pip(point_);
-    FastMemberIterator iter(store, relation);
-    for (;;)
-    {
-        FeaturePtr member = iter.next();
-        if (member.isNull()) break;
-        if (!member.isWay()) continue;
-        WayPtr memberWay(member);
-        if (memberWay.isPlaceholder()) continue;
-        int memberFlags = member.flags();
-        if (segmentsWithinDistance(memberWay, memberFlags)) return true;
-        /*
-        Box bounds = memberWay.bounds();
-        if (point_.y >= bounds.minY() && point_.y <= bounds.maxY())
-        {
-            odd ^= memberWay.containsPointFast(point_.x, point_.y);
-            LOG("odd = %d", odd);
-        }
-        */
-        // No bbox check needed, testAgainstWay() does it
-        pip.testAgainstWay(memberWay);
-    }
-    // LOG("final odd = %d", odd);
-    // return odd != 0;
-    return pip.isInside();
+    Box tileBounds = tile.bounds();
+    if (distance_.toBoxSquared(tileBounds) >= distanceSquared_) return -1;
+    if (distance_.toFarthestCornerSquared(tileBounds) < distanceSquared_) return 1;
+    return 0;
 }
 
 
 bool PointDistanceFilter::accept(FeatureStore* store, FeaturePtr feature, FastFilterHint fast) const
 {
-    FeatureType type = feature.type();
-    if (type == FeatureType::WAY)
-    {
-        WayPtr way(feature);
-        return isWithinDistance(way);
-    }
-    if (type == FeatureType::NODE)
-    {
-        NodePtr node(feature);
-        return Distance::pointsSquared(node.x(), node.y(), 
-            point_.x, point_.y) < distanceSquared_;
-    }
-    assert(type == FeatureType::RELATION);
-    if (feature.isArea())
+    if (feature.isNode())
     {
-        return isAreaWithinDistance(store, RelationPtr(feature));
+        // A node in a tile that lies entirely within the circle
+        // is always within distance
+        if (fast.turboFlags) return true;
+        return distance_.toNodeSquared(NodePtr(feature)) < distanceSquared_;
     }
-    RelationPtr relation(feature);
-    RecursionGuard guard(relation);
-    return areMembersWithinDistance(store, relation, guard);
-}
-
 
-bool PointDistanceFilter::areMembersWithinDistance(FeatureStore* store, RelationPtr relation, RecursionGuard& guard) const
-{
-    FastMemberIterator iter(store, relation);
-    for (;;)
-    {
-        FeaturePtr member = iter.next();
-        if (member.isNull()) break;
-        int typeCode = member.typeCode();
-        if (typeCode == 1)
-        {
-            WayPtr memberWay(member);
-            if (!memberWay.isPlaceholder() && isWithinDistance(memberWay)) return true;
-        }
-        else if (typeCode == 0)
-        {
-            NodePtr memberNode(member);
-            if (!memberNode.isPlaceholder() && Distance::pointsSquared(
-                memberNode.x(), memberNode.y(), point_.x, point_.y) < distanceSquared_)
-            {
-                return true;
-            }
-        }
-        else
-        {
-            assert(member.isRelation());
-            RelationPtr memberRel(member);
-            if (!memberRel.isPlaceholder() && guard.checkAndAdd(memberRel) &&
-                areMembersWithinDistance(store, memberRel, guard))
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    // Any geometry within a bounding box that lies entirely inside
+    // the circle is within distance; if the box lies entirely outside,
+    // so does the geometry (a point inside an area is inside its
+    // bounding box, hence this also holds for areas)
+    Box bounds = feature.bounds();
+    if (distance_.toFarthestCornerSquared(bounds) < distanceSquared_) return true;
+    if (distance_.toBoxSquared(bounds) >= distanceSquared_) return false;
+    return distance_.toFeatureSquared(store, feature) < distanceSquared_;
 }
 
 } // namespace geodesk
@@ -2,24 +2,103 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/filter/PreparedFilterFactory.h>
+#include <cassert>
+#include <geodesk/feature/FastMemberIterator.h>
+#include <geodesk/feature/FeatureStore.h>
 #include <geodesk/geom/geos/Geos.h>
 
 namespace geodesk {
 
+/**
+ * Checks whether the store has already built an index for the given
+ * way or relation. If so, buildIndex() will return this index, and
+ * the feature doesn't need to be segmentized. If not, the index
+ * created by buildIndex() will be added to the store's cache.
+ */
+bool PreparedFilterFactory::useCachedIndex(FeatureStore* store, FeaturePtr feature)
+{
+	cacheStore_ = store;
+	cacheKey_ = feature.typedId();
+	index_ = store->indexCache().get(cacheKey_);
+	return index_ != nullptr;
+}
+
+
+SharedMCIndex PreparedFilterFactory::buildIndex()
+{
+	if (index_) return index_;
+	if (indexBuilder_.isEmpty()) return {};
+	size_t size = indexBuilder_.estimatedIndexSize();
+	index_ = std::make_shared<const MCIndex>(indexBuilder_.build(bounds_));
+	if (cacheStore_) cacheStore_->indexCache().put(cacheKey_, index_, size);
+	return index_;
+}
+
+
+SharedTileClassifier PreparedFilterFactory::tileClassifier(TileClassifier::Mode mode) const
+{
+	assert(index_);
+	if (cacheStore_)
+	{
+		return cacheStore_->indexCache().tileClassifier(
+			cacheKey_, index_.get(), mode, bounds_);
+	}
+	return std::make_shared<const TileClassifier>(mode, bounds_);
+}
+
+
+std::vector<Coordinate> PreparedFilterFactory::memberNodes(FeatureStore* store, RelationPtr rel)
+{
+	std::vector<Coordinate> nodes;
+	RecursionGuard guard(rel);
+	collectMemberNodes(store, rel, guard, nodes);
+	return nodes;
+}
+
+
+// Visits the same members as MCIndexBuilder::segmentizeMembers()
+void PreparedFilterFactory::collectMemberNodes(FeatureStore* store, RelationPtr rel,
+	RecursionGuard& guard, std::vector<Coordinate>& nodes)
+{
+	FastMemberIterator iter(store, rel);
+	for (;;)
+	{
+		FeaturePtr member = iter.next();
+		if (member.isNull()) break;
+		int memberType = member.typeCode();
+		if (memberType == 0)
+		{
+			NodePtr memberNode(member);
+			if (memberNode.isPlaceholder()) continue;
+			nodes.push_back(memberNode.xy());
+		}
+		else if (memberType == 2)
+		{
+			RelationPtr childRel(member);
+			if (childRel.isPlaceholder() || !guard.checkAndAdd(childRel)) continue;
+			collectMemberNodes(store, childRel, guard, nodes);
+		}
+	}
+}
+
+
 const Filter* PreparedFilterFactory::forFeature(FeatureStore* store, FeaturePtr feature)
 {
 	if (feature.isType(FeatureTypes::RELATIONS & FeatureTypes::AREAS))
 	{
 		RelationPtr relation(feature);
 		bounds_ = relation.bounds();
-		indexBuilder_.segmentizeAreaRelation(store, relation);
+		if (!useCachedIndex(store, feature))
+		{
+			indexBuilder_.segmentizeAreaRelation(store, relation);
+		}
 		return forPolygonal();
 	}
 	if (feature.isType(FeatureTypes::WAYS & FeatureTypes::AREAS))
 	{
 		WayPtr way(feature);
 		bounds_ = way.bounds();
-		indexBuilder_.segmentizeWay(way);
+		if (!useCachedIndex(store, feature)) indexBuilder_.segmentizeWay(way);
 		return forPolygonal();
 	}
 	if (feature.isNode())
@@ -32,13 +111,16 @@ const Filter* PreparedFilterFactory::forFeature(FeatureStore* store, FeaturePtr
 		RelationPtr relation(feature);
 		RecursionGuard guard(relation);
 		bounds_ = relation.bounds();
-		indexBuilder_.segmentizeMembers(store, relation, guard);
+		if (!useCachedIndex(store, feature))
+		{
+			indexBuilder_.segmentizeMembers(store, relation, guard);
+		}
 		return forNonAreaRelation(store, relation);
 	}
 	assert(feature.isWay());
 	WayPtr way(feature);
 	bounds_ = way.bounds();
-	indexBuilder_.segmentizeWay(way);
+	if (!useCachedIndex(store, feature)) indexBuilder_.segmentizeWay(way);
 	return forLineal();
 }
 
@@ -2,7 +2,11 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/filter/WithinFilter.h>
+#include <algorithm>
+#include <vector>
 #include <geodesk/feature/FastMemberIterator.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+#include <geodesk/geom/LineSegment.h>
 #include <geodesk/geom/Mercator.h>
 #include <geodesk/geom/polygon/PointInPolygon.h>
 #include <geodesk/geom/Centroid.h>
@@ -163,13 +167,145 @@ bool WithinPolygonFilter::accept(FeatureStore* store, FeaturePtr feature, FastFi
 
 int WithinPolygonFilter::acceptTile(Tile tile) const
 {
-	Box tileBounds = tile.bounds();
-	int loc = index_.locateBox(tileBounds);
+	int loc = locateTile(tile);
 	if (loc > 0) return 1; 
 		// TODO: Don't use 1 to indicate tile acceleration, use enum constant
 	return loc; 
 }
 
+
+WithinLinealFilter::WithinLinealFilter(const Box& bounds, SharedMCIndex index,
+	SharedTileClassifier tileClassifier, const std::vector<Coordinate>& nodes) :
+	PreparedSpatialFilter(bounds, std::move(index), std::move(tileClassifier))
+{
+	flags_ |=
+		FilterFlags::FAST_TILE_FILTER |
+		FilterFlags::MUST_ACCEPT_ALL_MEMBERS |
+		FilterFlags::STRICT_BBOX;
+	nodes_.build(nodes);
+	for (Coordinate c : nodes) nodeBounds_.expandToInclude(c);
+}
+
+
+bool WithinLinealFilter::accept(FeatureStore* store, FeaturePtr feature, FastFilterHint) const
+{
+	return acceptFeature(store, feature);
+}
+
+
+int WithinLinealFilter::acceptTile(Tile tile) const
+{
+	// A feature can only lie within the linework if the linework
+	// passes through the tile (or a member node lies in it); there
+	// are never any tiles whose features are all accepted
+	int loc = locateTile(tile);
+	if (loc < 0 && !nodes_.isEmpty() && tile.bounds().intersects(nodeBounds_))
+	{
+		loc = 0;
+	}
+	return loc;
+}
+
+
+bool WithinLinealFilter::acceptNode(NodePtr node) const
+{
+	return index_.pointOnBoundary(node.xy()) || nodes_.contains(node.xy());
+}
+
+
+bool WithinLinealFilter::acceptWay(WayPtr way) const
+{
+	if (way.isArea()) return false;
+	if (!index_.intersectsBoxBoundary(way.bounds())) return false;
+	WayCoordinateIterator iter(way);
+	Coordinate start = iter.next();
+	for (;;)
+	{
+		Coordinate end = iter.next();
+		if (end.isNull()) break;
+		if (!isSegmentCovered(start, end)) return false;
+		start = end;
+	}
+	return true;
+}
+
+
+bool WithinLinealFilter::acceptAreaRelation(FeatureStore*, RelationPtr) const
+{
+	return false;
+}
+
+
+struct SegmentCoverage
+{
+	Coordinate start;
+	Coordinate end;
+	double dx;
+	double dy;
+	double lengthSquared;
+	std::vector<std::pair<double,double>> intervals;
+};
+
+/**
+ * Collects the portions of the candidate segment that are covered by the
+ * segments of a chain, as intervals along the candidate (0 = start, 1 = end).
+ * A chain segment covers part of the candidate if both of its vertexes
+ * lie on the line through the candidate (which we check exactly, as
+ * the cross products of long segments can't be represented as doubles).
+ */
+static bool collectCoveredIntervals(
+	const RTree<const MonotoneChain>::Node* node, SegmentCoverage* coverage)
+{
+	const MonotoneChain* chain = node->item();
+	double startX = coverage->start.x;
+	double startY = coverage->start.y;
+	for (int i = 1; i < chain->vertexCount(); i++)
+	{
+		Coordinate a = chain->vertex(i - 1);
+		Coordinate b = chain->vertex(i);
+		if (LineSegment::side(coverage->start, coverage->end, a) != 0) continue;
+		if (LineSegment::side(coverage->start, coverage->end, b) != 0) continue;
+		double ax = a.x - startX;
+		double ay = a.y - startY;
+		double bx = b.x - startX;
+		double by = b.y - startY;
+		double ta = (ax * coverage->dx + ay * coverage->dy) / coverage->lengthSquared;
+		double tb = (bx * coverage->dx + by * coverage->dy) / coverage->lengthSquared;
+		double lo = std::max(std::min(ta, tb), 0.0);
+		double hi = std::min(std::max(ta, tb), 1.0);
+		if (lo <= hi) coverage->intervals.emplace_back(lo, hi);
+	}
+	return false;	// keep going
+}
+
+
+/**
+ * Checks whether the given segment lies fully on the linework (it may
+ * span multiple collinear segments of the indexed geometry).
+ */
+bool WithinLinealFilter::isSegmentCovered(Coordinate start, Coordinate end) const
+{
+	if (start == end) return index_.pointOnBoundary(start);
+	SegmentCoverage coverage;
+	coverage.start = start;
+	coverage.end = end;
+	coverage.dx = static_cast<double>(end.x) - start.x;
+	coverage.dy = static_cast<double>(end.y) - start.y;
+	coverage.lengthSquared = coverage.dx * coverage.dx + coverage.dy * coverage.dy;
+	index_.findChains(Box::normalizedSimple(start, end),
+		collectCoveredIntervals, &coverage);
+
+	std::sort(coverage.intervals.begin(), coverage.intervals.end());
+	double covered = 0;
+	for (const auto& [lo, hi] : coverage.intervals)
+	{
+		if (lo > covered) return false;		// gap
+		covered = std::max(covered, hi);
+		if (covered >= 1) return true;
+	}
+	return false;
+}
+
 /*
 bool WithinPolygonFilter::accept(FeatureStore* store, FeatureRef feature, FastFilterHint fast) const
 {
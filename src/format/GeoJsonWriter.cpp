@@ -165,10 +165,8 @@ void GeoJsonWriter::writeWayGeometry(WayPtr way)
 
 void GeoJsonWriter::writeAreaRelationGeometry(FeatureStore* store, RelationPtr relation)
 {
-	Polygonizer polygonizer;
-	polygonizer.createRings(store, relation);
-	polygonizer.assignAndMergeHoles();
-	const Polygonizer::Ring* ring = polygonizer.outerRings();
+	SharedPolygonizer polygonizer = rings(store, relation);
+	const Polygonizer::Ring* ring = polygonizer->outerRings();
 	int count = ring ? (ring->next() ? 2 : 1) : 0;
 	if (count > 1)
 	{
@@ -198,7 +196,7 @@ void GeoJsonWriter::writeAreaRelationGeometry(FeatureStore* store, RelationPtr r
 	}
 	else
 	{
-		writePolygonizedCoordinates(polygonizer);
+		writePolygonizedCoordinates(*polygonizer);
 	}
 	writeByte('}');
 }
@@ -2,35 +2,61 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/format/GeometryWriter.h>
+#include <geodesk/feature/FeatureStore.h>
 #include <geodesk/geom/polygon/Polygonizer.h>
 #include "geom/polygon/Ring.h"
 #include "geom/polygon/RingCoordinateIterator.h"
-#include <geodesk/geom/Mercator.h>
+#include <algorithm>
+#include <geodesk/geom/CoordinateTransform.h>
 #include <geodesk/geom/geos/GeosCoordinateIterator.h>
 
 namespace geodesk {
 
 void GeometryWriter::writeCoordinate(Coordinate c)
 {
-	if (coordStartChar_) writeByte(coordStartChar_);
-	double lon = Mercator::lonFromX(c.x);
-	double lat = Mercator::latFromY(c.y);
-	formatDouble(latitudeFirst_ ? lat : lon, precision_);
-	writeByte(coordValueSeparatorChar_);
-	formatDouble(latitudeFirst_ ? lon : lat, precision_);
-	if (coordEndChar_) writeByte(coordEndChar_);
+	writeCoordinateSegment(true, &c, 1);
 }
 
 
 void GeometryWriter::writeCoordinateSegment(bool isFirst, const Coordinate* p, size_t count)
 {
-	const Coordinate* end;
-	end = p + count;
-	while (p < end)
+	while (count > 0)
 	{
-		if (!isFirst) writeByte(',');  // TODO: always comma for all formats?
-		isFirst = false;
-		writeCoordinate(*p++);
+		size_t n = std::min(count, static_cast<size_t>(COORDINATE_BATCH_SIZE));
+		if (precision_ <= CoordinateTransform::MAX_SCALED_PRECISION)
+		{
+			int64_t lon[COORDINATE_BATCH_SIZE];
+			int64_t lat[COORDINATE_BATCH_SIZE];
+			CoordinateTransform::toScaledLonLat(p, n, precision_, lon, lat);
+			for (size_t i = 0; i < n; i++)
+			{
+				if (!isFirst) writeByte(',');  // TODO: always comma for all formats?
+				isFirst = false;
+				if (coordStartChar_) writeByte(coordStartChar_);
+				formatFixed(latitudeFirst_ ? lat[i] : lon[i], precision_);
+				writeByte(coordValueSeparatorChar_);
+				formatFixed(latitudeFirst_ ? lon[i] : lat[i], precision_);
+				if (coordEndChar_) writeByte(coordEndChar_);
+			}
+		}
+		else
+		{
+			double lon[COORDINATE_BATCH_SIZE];
+			double lat[COORDINATE_BATCH_SIZE];
+			CoordinateTransform::toLonLat(p, n, lon, lat);
+			for (size_t i = 0; i < n; i++)
+			{
+				if (!isFirst) writeByte(',');  // TODO: always comma for all formats?
+				isFirst = false;
+				if (coordStartChar_) writeByte(coordStartChar_);
+				formatDouble(latitudeFirst_ ? lat[i] : lon[i], precision_);
+				writeByte(coordValueSeparatorChar_);
+				formatDouble(latitudeFirst_ ? lon[i] : lat[i], precision_);
+				if (coordEndChar_) writeByte(coordEndChar_);
+			}
+		}
+		p += n;
+		count -= n;
 	}
 }
 
@@ -122,20 +148,43 @@ void GeometryWriter::writeGeometryCoordinates(
 #endif
 
 
+SharedPolygonizer GeometryWriter::rings(FeatureStore* store, RelationPtr relation) const
+{
+    if (!simplifier_.isEnabled()) return store->ringCache().rings(store, relation);
+    auto polygonizer = std::make_shared<Polygonizer>();
+    polygonizer->createRings(store, relation, &simplifier_);
+    polygonizer->assignAndMergeHoles();
+    polygonizer->validate();
+    return polygonizer;
+}
+
+
 void GeometryWriter::writeWayCoordinates(WayPtr way, bool group)
 {
+    if (simplifier_.isEnabled())
+    {
+        simplified_.clear();
+        simplifier_.simplifyWay(way, simplified_);
+        if(group) writeByte(coordGroupStartChar_);
+        writeByte(coordGroupStartChar_);
+        writeCoordinateSegment(true, simplified_.data(), simplified_.size());
+        writeByte(coordGroupEndChar_);
+        if (group) writeByte(coordGroupEndChar_);
+        return;
+    }
+
     WayCoordinateIterator iter(way);
     // TODO: Leaflet doesn't need duplicate end coordinate for polygons
     bool isFirst = true;
     if(group) writeByte(coordGroupStartChar_);
     writeByte(coordGroupStartChar_);
+    Coordinate coords[WayCoordinateIterator::BATCH_SIZE];
     for (;;)
     {
-        Coordinate c = iter.next();
-        if (c.isNull()) break;
-        if (!isFirst) writeByte(',');  // TODO: always comma for all formats?
+        int count = iter.nextBatch(coords, WayCoordinateIterator::BATCH_SIZE);
+        if (count == 0) break;
+        writeCoordinateSegment(isFirst, coords, count);
         isFirst = false;
-        writeCoordinate(c);
     }
     writeByte(coordGroupEndChar_);
     if (group) writeByte(coordGroupEndChar_);
@@ -155,14 +204,12 @@ void GeometryWriter::writePolygonizedCoordinates(const Polygonizer& polygonizer)
         if (!isFirst) writeByte(',');  // TODO: always comma for all formats?
         isFirst = false;
         writeByte(coordGroupStartChar_);
-        RingCoordinateIterator iter(ring);
-        writeCoordinates(iter);
+        writeRingCoordinates(ring);
         const Polygonizer::Ring* inner = ring->firstInner();
         while (inner)
         {
             writeByte(',');  // TODO: always comma for all formats?
-            RingCoordinateIterator iterInner(inner);
-            writeCoordinates(iterInner);
+            writeRingCoordinates(inner);
             inner = inner->next();
         }
         writeByte(coordGroupEndChar_);
@@ -172,4 +219,11 @@ void GeometryWriter::writePolygonizedCoordinates(const Polygonizer& polygonizer)
     if (first->next()) writeByte(coordGroupEndChar_);
 }
 
+
+void GeometryWriter::writeRingCoordinates(const Polygonizer::Ring* ring)
+{
+    RingCoordinateIterator iter(ring);
+    writeCoordinates(iter);
+}
+
 } // namespace geodesk
@@ -52,10 +52,8 @@ void WktWriter::writeWayGeometry(WayPtr way)
 
 void WktWriter::writeAreaRelationGeometry(FeatureStore* store, RelationPtr relation)
 {
-	Polygonizer polygonizer;
-	polygonizer.createRings(store, relation);
-	polygonizer.assignAndMergeHoles();
-	const Polygonizer::Ring* ring = polygonizer.outerRings();
+	SharedPolygonizer polygonizer = rings(store, relation);
+	const Polygonizer::Ring* ring = polygonizer->outerRings();
 	int count = ring ? (ring->next() ? 2 : 1) : 0;
 	if (count > 1)
 	{
@@ -71,7 +69,7 @@ void WktWriter::writeAreaRelationGeometry(FeatureStore* store, RelationPtr relat
 	}
 	else
 	{
-		writePolygonizedCoordinates(polygonizer);
+		writePolygonizedCoordinates(*polygonizer);
 	}
 }
 
@@ -0,0 +1,189 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <geodesk/geom/Coordinate.h>
+#include <geodesk/geom/Mercator.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GEODESK_APPROX_MATH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GEODESK_TARGET_AVX2
+#else
+#define GEODESK_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Polynomial approximations of exp() and atan(), in scalar and AVX2
+// variants that yield identical results, shared by the batch kernels
+// (MeasureKernels, CoordinateTransform). See MeasureKernels.h for
+// their accuracy. The results are only identical if the scalar code
+// isn't contracted into FMA instructions, hence the files that
+// include this header are compiled with -ffp-contract=off (see
+// CMakeLists.txt).
+
+namespace geodesk {
+
+namespace ApproxMath
+{
+	constexpr double LOG2E = 1.4426950408889634074;
+	constexpr double LN2_HI = 6.93145751953125e-1;
+	constexpr double LN2_LO = 1.42860682030941723212e-6;
+
+	// Taylor coefficients of exp(r), from 1/12! down to 1/0!
+	constexpr double EXP_COEFFS[] =
+	{
+		1.0 / 479001600.0,
+		1.0 / 39916800.0,
+		1.0 / 3628800.0,
+		1.0 / 362880.0,
+		1.0 / 40320.0,
+		1.0 / 5040.0,
+		1.0 / 720.0,
+		1.0 / 120.0,
+		1.0 / 24.0,
+		1.0 / 6.0,
+		1.0 / 2.0,
+		1.0,
+		1.0
+	};
+	constexpr int EXP_COEFF_COUNT = sizeof(EXP_COEFFS) / sizeof(double);
+
+	// Cephes atan()
+	constexpr double ATAN_P0 = -8.750608600031904122785e-1;
+	constexpr double ATAN_P1 = -1.615753718733365076637e1;
+	constexpr double ATAN_P2 = -7.500855792314704667340e1;
+	constexpr double ATAN_P3 = -1.228866684490136173410e2;
+	constexpr double ATAN_P4 = -6.485021904942025371773e1;
+	constexpr double ATAN_Q0 = 2.485846490142306297962e1;
+	constexpr double ATAN_Q1 = 1.650270098316988542046e2;
+	constexpr double ATAN_Q2 = 4.328810604912902668951e2;
+	constexpr double ATAN_Q3 = 4.853903996359136964868e2;
+	constexpr double ATAN_Q4 = 1.945506571482613964425e2;
+	constexpr double TAN_3PI_8 = 2.41421356237309504880;
+	constexpr double MOREBITS = 6.123233995736765886130e-17;
+	constexpr double PI_2 = M_PI / 2;
+	constexpr double PI_4 = M_PI / 4;
+
+	constexpr double RADIANS_PER_UNIT = 2 * M_PI / Mercator::MAP_WIDTH;
+
+	inline double exp(double t)
+	{
+		double n = std::nearbyint(t * LOG2E);
+		double r = (t - n * LN2_HI) - n * LN2_LO;
+		double p = EXP_COEFFS[0];
+		for (int i = 1; i < EXP_COEFF_COUNT; i++) p = p * r + EXP_COEFFS[i];
+		uint64_t bits = static_cast<uint64_t>(static_cast<int64_t>(n) + 1023) << 52;
+		double scale;
+		memcpy(&scale, &bits, sizeof(scale));
+		return p * scale;
+	}
+
+	inline double atan(double x)
+	{
+		double sign = x < 0 ? -1.0 : 1.0;
+		x = std::abs(x);
+		double y0;
+		double more;
+		if (x > TAN_3PI_8)
+		{
+			y0 = PI_2;
+			more = MOREBITS;
+			x = -1.0 / x;
+		}
+		else if (x > 0.66)
+		{
+			y0 = PI_4;
+			more = 0.5 * MOREBITS;
+			x = (x - 1.0) / (x + 1.0);
+		}
+		else
+		{
+			y0 = 0;
+			more = 0;
+		}
+		double z = x * x;
+		double num = (((ATAN_P0 * z + ATAN_P1) * z + ATAN_P2) * z + ATAN_P3) * z + ATAN_P4;
+		double den = ((((z + ATAN_Q0) * z + ATAN_Q1) * z + ATAN_Q2) * z + ATAN_Q3) * z + ATAN_Q4;
+		z = z * num / den;
+		z = x * z + x;
+		return sign * (y0 + (z + more));
+	}
+
+	#ifdef GEODESK_APPROX_MATH_X86
+
+	GEODESK_TARGET_AVX2
+	inline __m256d exp4(__m256d t)
+	{
+		__m256d n = _mm256_round_pd(_mm256_mul_pd(t, _mm256_set1_pd(LOG2E)),
+			_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		__m256d r = _mm256_sub_pd(
+			_mm256_sub_pd(t, _mm256_mul_pd(n, _mm256_set1_pd(LN2_HI))),
+			_mm256_mul_pd(n, _mm256_set1_pd(LN2_LO)));
+		__m256d p = _mm256_set1_pd(EXP_COEFFS[0]);
+		for (int i = 1; i < EXP_COEFF_COUNT; i++)
+		{
+			p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(EXP_COEFFS[i]));
+		}
+		__m256i exponent = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+		exponent = _mm256_slli_epi64(_mm256_add_epi64(exponent, _mm256_set1_epi64x(1023)), 52);
+		return _mm256_mul_pd(p, _mm256_castsi256_pd(exponent));
+	}
+
+	GEODESK_TARGET_AVX2
+	inline __m256d atan4(__m256d x)
+	{
+		__m256d signBit = _mm256_and_pd(x, _mm256_set1_pd(-0.0));
+		x = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+		__m256d one = _mm256_set1_pd(1.0);
+		__m256d large = _mm256_cmp_pd(x, _mm256_set1_pd(TAN_3PI_8), _CMP_GT_OQ);
+		__m256d medium = _mm256_andnot_pd(large,
+			_mm256_cmp_pd(x, _mm256_set1_pd(0.66), _CMP_GT_OQ));
+		__m256d xr = _mm256_blendv_pd(x,
+			_mm256_div_pd(_mm256_sub_pd(x, one), _mm256_add_pd(x, one)), medium);
+		xr = _mm256_blendv_pd(xr, _mm256_div_pd(_mm256_set1_pd(-1.0), x), large);
+		__m256d y0 = _mm256_blendv_pd(
+			_mm256_and_pd(medium, _mm256_set1_pd(PI_4)), _mm256_set1_pd(PI_2), large);
+		__m256d more = _mm256_blendv_pd(
+			_mm256_and_pd(medium, _mm256_set1_pd(0.5 * MOREBITS)),
+			_mm256_set1_pd(MOREBITS), large);
+
+		__m256d z = _mm256_mul_pd(xr, xr);
+		__m256d num = _mm256_set1_pd(ATAN_P0);
+		num = _mm256_add_pd(_mm256_mul_pd(num, z), _mm256_set1_pd(ATAN_P1));
+		num = _mm256_add_pd(_mm256_mul_pd(num, z), _mm256_set1_pd(ATAN_P2));
+		num = _mm256_add_pd(_mm256_mul_pd(num, z), _mm256_set1_pd(ATAN_P3));
+		num = _mm256_add_pd(_mm256_mul_pd(num, z), _mm256_set1_pd(ATAN_P4));
+		__m256d den = _mm256_add_pd(z, _mm256_set1_pd(ATAN_Q0));
+		den = _mm256_add_pd(_mm256_mul_pd(den, z), _mm256_set1_pd(ATAN_Q1));
+		den = _mm256_add_pd(_mm256_mul_pd(den, z), _mm256_set1_pd(ATAN_Q2));
+		den = _mm256_add_pd(_mm256_mul_pd(den, z), _mm256_set1_pd(ATAN_Q3));
+		den = _mm256_add_pd(_mm256_mul_pd(den, z), _mm256_set1_pd(ATAN_Q4));
+		z = _mm256_div_pd(_mm256_mul_pd(z, num), den);
+		z = _mm256_add_pd(_mm256_mul_pd(xr, z), xr);
+		__m256d y = _mm256_add_pd(y0, _mm256_add_pd(z, more));
+		return _mm256_xor_pd(y, signBit);
+	}
+
+	/**
+	 * Loads 4 coordinates and converts their X and Y components to doubles.
+	 */
+	GEODESK_TARGET_AVX2
+	inline void load4(const Coordinate* coords, __m256d& x, __m256d& y)
+	{
+		__m256i xy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(coords));
+		xy = _mm256_permutevar8x32_epi32(xy, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+		x = _mm256_cvtepi32_pd(_mm256_castsi256_si128(xy));
+		y = _mm256_cvtepi32_pd(_mm256_extracti128_si256(xy, 1));
+	}
+
+	#endif // GEODESK_APPROX_MATH_X86
+}
+
+} // namespace geodesk
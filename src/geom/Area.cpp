@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/geom/Area.h>
+#include <geodesk/feature/FeatureStore.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+#include <geodesk/geom/MeasureKernels.h>
 #include "geom/polygon/RingCoordinateIterator.h"
 
 namespace geodesk {
@@ -38,7 +41,21 @@ double Area::signedMercatorOfWay(const WayPtr way)
     assert(way.isArea());
     WayCoordinateIterator iter;
     iter.start(way, FeatureFlags::AREA);
-    return signedMercatorOfAbstractRing(iter);
+
+    // Each batch overlaps the previous by two coordinates
+    double x0 = 0;
+    double sum = 0.0;
+    bool first = true;
+    iter.forEachSegmentBatch<2>([&](const Coordinate* coords, int count)
+    {
+        if (first)
+        {
+            x0 = coords[0].x;
+            first = false;
+        }
+        sum += MeasureKernels::shoelace(coords, count, x0);
+    });
+    return sum / 2.0;
 }
 
 
@@ -57,20 +74,12 @@ double Area::ofRelation(FeatureStore* store, const RelationPtr relation)
     scale *= scale;     // squared for square meters
     double totalArea = 0;
 
-    Polygonizer polygonizer;
-    polygonizer.createRings(store, relation);
-    const Polygonizer::Ring* ring = polygonizer.outerRings();
-    while (ring)
-    {
-        totalArea += mercatorOfRing(ring) * scale;
-        ring = ring->next();
-    }
-    ring = polygonizer.innerRings();
-    while (ring)
+    SharedPolygonizer polygonizer = store->ringCache().rings(store, relation, false);
+    polygonizer->forEachRing([&totalArea, scale](const Polygonizer::Ring* ring, bool isOuter)
     {
-        totalArea -= mercatorOfRing(ring) * scale;
-        ring = ring->next();
-    }
+        double area = mercatorOfRing(ring) * scale;
+        totalArea += isOuter ? area : -area;
+    });
 
     // TODO: could apply scale at end; but we may also calculate
     // scale for each ring separately?
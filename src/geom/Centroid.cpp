@@ -30,22 +30,12 @@ Coordinate Centroid::ofWay(WayPtr way)
 
 void Centroid::Areal::addAreaRelation(FeatureStore* store, RelationPtr relation)
 {
-	Polygonizer polygonizer;
-	polygonizer.createRings(store, relation);
-	const Polygonizer::Ring* ring = polygonizer.outerRings();
-	while (ring)
+	SharedPolygonizer polygonizer = store->ringCache().rings(store, relation, false);
+	polygonizer->forEachRing([this](const Polygonizer::Ring* ring, bool isOuter)
 	{
 		RingCoordinateIterator iter(ring);
-		addRing(iter, true);
-		ring = ring->next();
-	}
-	ring = polygonizer.innerRings();
-	while (ring)
-	{
-		RingCoordinateIterator iter(ring);
-		addRing(iter, false);
-		ring = ring->next();
-	}
+		addRing(iter, isOuter);
+	});
 }
 
 
@@ -123,23 +113,24 @@ void Centroid::addRelation(FeatureStore* store, RelationPtr rel, RecursionGuard&
 void Centroid::Lineal::addLineSegments(WayPtr way)
 {
 	WayCoordinateIterator iter(way);
-	Coordinate c = iter.next();
-	double x1 = c.x;
-	double y1 = c.y;
-	for (int count = iter.coordinatesRemaining(); count > 0; count--)
+	iter.forEachSegmentBatch([this](const Coordinate* coords, int count)
 	{
-		c = iter.next();
-		double x2 = c.x;
-		double y2 = c.y;
-		double xDelta = x1 - x2;
-		double yDelta = y1 - y2;
-		double d = sqrt(xDelta * xDelta + yDelta * yDelta);
-		totalLength_ += d;
-		lineCentroidX_ += (x1 + x2) * d;
-		lineCentroidY_ += (y1 + y2) * d;
-		x1 = x2;
-		y1 = y2;
-	}
+		double x1 = coords[0].x;
+		double y1 = coords[0].y;
+		for (int i = 1; i < count; i++)
+		{
+			double x2 = coords[i].x;
+			double y2 = coords[i].y;
+			double xDelta = x1 - x2;
+			double yDelta = y1 - y2;
+			double d = sqrt(xDelta * xDelta + yDelta * yDelta);
+			totalLength_ += d;
+			lineCentroidX_ += (x1 + x2) * d;
+			lineCentroidY_ += (y1 + y2) * d;
+			x1 = x2;
+			y1 = y2;
+		}
+	});
 }
 
 
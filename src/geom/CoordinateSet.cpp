@@ -0,0 +1,49 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/CoordinateSet.h>
+#include <cstring>
+
+namespace geodesk {
+
+void CoordinateSet::build(const std::vector<Coordinate>& coords)
+{
+	// Table is at most half full, so probe sequences stay short
+	size_t slotCount = 16;
+	while (slotCount < coords.size() * 2) slotCount <<= 1;
+	slots_.reset(new uint64_t[slotCount]);
+	memset(slots_.get(), 0, slotCount * sizeof(uint64_t));
+	slotMask_ = slotCount - 1;
+
+	// Blocked Bloom filter with 8 bits per slot (i.e. 16 to 32 bits per
+	// coordinate) and 2 hash bits per coordinate, both in the same word
+	size_t bloomWords = slotCount / 8;
+	bloom_.reset(new uint64_t[bloomWords]);
+	memset(bloom_.get(), 0, bloomWords * sizeof(uint64_t));
+	bloomMask_ = bloomWords - 1;
+
+	count_ = 0;
+	for (Coordinate c : coords)
+	{
+		uint64_t key = static_cast<uint64_t>(static_cast<int64_t>(c));
+		if (key == 0) continue;
+		uint64_t h = hash(key);
+		uint64_t slot = (h >> 32) & slotMask_;
+		for (;;)
+		{
+			uint64_t v = slots_[slot];
+			if (v == key) break;
+			if (v == 0)
+			{
+				slots_[slot] = key;
+				bloom_[(h >> 12) & bloomMask_] |=
+					(1ULL << (h & 63)) | (1ULL << ((h >> 6) & 63));
+				count_++;
+				break;
+			}
+			slot = (slot + 1) & slotMask_;
+		}
+	}
+}
+
+} // namespace geodesk
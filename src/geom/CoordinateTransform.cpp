@@ -0,0 +1,197 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/CoordinateTransform.h>
+#include <cmath>
+#include <clarisma/math/Math.h>
+#include <clarisma/sys/CpuFeatures.h>
+#include <geodesk/geom/Mercator.h>
+#include "geom/ApproxMath.h"
+
+namespace geodesk {
+
+// ==================================================================
+//  Scalar
+// ==================================================================
+
+// The same order of operations as Mercator::lonFromX() and
+// Mercator::latFromY()
+
+static inline double lonFromX(double x)
+{
+	return x * 360.0 / Mercator::MAP_WIDTH;
+}
+
+
+static inline double latFromY(double y)
+{
+	return ApproxMath::atan(ApproxMath::exp(y * M_PI * 2.0 / Mercator::MAP_WIDTH))
+		* 360.0 / M_PI - 90.0;
+}
+
+
+static void toLonLatScalar(const Coordinate* coords, size_t count,
+	double* lon, double* lat)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		lon[i] = lonFromX(coords[i].x);
+		lat[i] = latFromY(coords[i].y);
+	}
+}
+
+
+static void toScaledLonLatScalar(const Coordinate* coords, size_t count,
+	int precision, int64_t* lon, int64_t* lat)
+{
+	double multiplier = clarisma::Math::POWERS_OF_10[precision];
+	for (size_t i = 0; i < count; i++)
+	{
+		lon[i] = static_cast<int64_t>(std::round(lonFromX(coords[i].x) * multiplier));
+		lat[i] = static_cast<int64_t>(std::round(latFromY(coords[i].y) * multiplier));
+	}
+}
+
+
+#ifdef GEODESK_APPROX_MATH_X86
+
+// ==================================================================
+//  AVX2 (4 coordinates at a time)
+// ==================================================================
+
+GEODESK_TARGET_AVX2
+static inline void lonLat4(const Coordinate* coords, __m256d& lon, __m256d& lat)
+{
+	__m256d x, y;
+	ApproxMath::load4(coords, x, y);
+	__m256d mapWidth = _mm256_set1_pd(Mercator::MAP_WIDTH);
+	lon = _mm256_div_pd(_mm256_mul_pd(x, _mm256_set1_pd(360.0)), mapWidth);
+	__m256d t = _mm256_div_pd(_mm256_mul_pd(
+		_mm256_mul_pd(y, _mm256_set1_pd(M_PI)), _mm256_set1_pd(2.0)), mapWidth);
+	lat = _mm256_sub_pd(_mm256_div_pd(
+		_mm256_mul_pd(ApproxMath::atan4(ApproxMath::exp4(t)), _mm256_set1_pd(360.0)),
+		_mm256_set1_pd(M_PI)), _mm256_set1_pd(90.0));
+}
+
+
+/**
+ * Rounds to the nearest integer (halfway cases away from zero, same
+ * as std::round()) and converts to 64-bit integers. Only valid for
+ * values below 2^51 in magnitude.
+ */
+GEODESK_TARGET_AVX2
+static inline __m256i roundToInt64(__m256d v)
+{
+	__m256d truncated = _mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+	__m256d signBit = _mm256_and_pd(v, _mm256_set1_pd(-0.0));
+	__m256d fraction = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(v, truncated));
+	__m256d roundAway = _mm256_cmp_pd(fraction, _mm256_set1_pd(0.5), _CMP_GE_OQ);
+	__m256d rounded = _mm256_add_pd(truncated, _mm256_and_pd(roundAway,
+		_mm256_or_pd(_mm256_set1_pd(1.0), signBit)));
+
+	// Adding 2^52 + 2^51 places the integer in the low bits of the
+	// mantissa (two's complement, offset by the bits of the constant)
+	constexpr double MAGIC = 6755399441055744.0;
+	__m256d magic = _mm256_set1_pd(MAGIC);
+	return _mm256_sub_epi64(
+		_mm256_castpd_si256(_mm256_add_pd(rounded, magic)),
+		_mm256_castpd_si256(magic));
+}
+
+
+GEODESK_TARGET_AVX2
+static void toLonLatAvx2(const Coordinate* coords, size_t count,
+	double* lon, double* lat)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d lon4, lat4;
+		lonLat4(coords + i, lon4, lat4);
+		_mm256_storeu_pd(lon + i, lon4);
+		_mm256_storeu_pd(lat + i, lat4);
+	}
+	toLonLatScalar(coords + i, count - i, lon + i, lat + i);
+}
+
+
+GEODESK_TARGET_AVX2
+static void toScaledLonLatAvx2(const Coordinate* coords, size_t count,
+	int precision, int64_t* lon, int64_t* lat)
+{
+	__m256d multiplier = _mm256_set1_pd(clarisma::Math::POWERS_OF_10[precision]);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d lon4, lat4;
+		lonLat4(coords + i, lon4, lat4);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lon + i),
+			roundToInt64(_mm256_mul_pd(lon4, multiplier)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lat + i),
+			roundToInt64(_mm256_mul_pd(lat4, multiplier)));
+	}
+	toScaledLonLatScalar(coords + i, count - i, precision, lon + i, lat + i);
+}
+
+#endif // GEODESK_APPROX_MATH_X86
+
+// ==================================================================
+//  Inverse
+// ==================================================================
+
+void CoordinateTransform::fromLonLat(const double* lon, const double* lat,
+	size_t count, Coordinate* coords)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		coords[i] = Coordinate(Mercator::xFromLon(lon[i]), Mercator::yFromLat(lat[i]));
+	}
+}
+
+// ==================================================================
+//  Dispatch
+// ==================================================================
+
+CoordinateTransform::Dispatch& CoordinateTransform::dispatch()
+{
+	static Dispatch dispatch = []()
+	{
+		Dispatch d{ toLonLatScalar, toScaledLonLatScalar, Implementation::SCALAR };
+		#ifdef GEODESK_APPROX_MATH_X86
+		if (clarisma::CpuFeatures::hasAvx2())
+		{
+			d = { toLonLatAvx2, toScaledLonLatAvx2, Implementation::AVX2 };
+		}
+		#endif
+		return d;
+	}();
+	return dispatch;
+}
+
+
+bool CoordinateTransform::select(Implementation impl)
+{
+	Dispatch& d = dispatch();
+	switch (impl)
+	{
+	case Implementation::SCALAR:
+		d = { toLonLatScalar, toScaledLonLatScalar, impl };
+		return true;
+	#ifdef GEODESK_APPROX_MATH_X86
+	case Implementation::AVX2:
+		if (!clarisma::CpuFeatures::hasAvx2()) return false;
+		d = { toLonLatAvx2, toScaledLonLatAvx2, impl };
+		return true;
+	#endif
+	default:
+		return false;
+	}
+}
+
+
+const char* CoordinateTransform::implementationName()
+{
+	return implementation() == Implementation::AVX2 ? "AVX2" : "scalar";
+}
+
+} // namespace geodesk
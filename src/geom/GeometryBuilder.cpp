@@ -4,6 +4,13 @@
 #ifdef GEODESK_WITH_GEOS
 
 #include <geodesk/geom/GeometryBuilder.h>
+#include <algorithm>
+#include <thread>
+#include <clarisma/thread/Threads.h>
+#include <geodesk/feature/FastMemberIterator.h>
+#include <geodesk/feature/FeatureStore.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+#include <geodesk/geom/geos/GeosContext.h>
 #include <geodesk/geom/polygon/Polygonizer.h>
 #include "geom/polygon/Ring.h"
 
@@ -15,12 +22,10 @@ GEOSGeometry* GeometryBuilder::buildWayGeometry(const FeaturePtr way, GEOSContex
 	int areaFlag = way.flags() & FeatureFlags::AREA;
 	iter.start(way, areaFlag);
 	int count = iter.storedCoordinatesRemaining() + (areaFlag ? 1 : 0);
-	GEOSCoordSequence* coordSeq = GEOSCoordSeq_create_r(geosContext, count, 2);  // 2D points
-	for (int i=0; i<count; i++)
-	{
-		Coordinate c = iter.next();
-		GEOSCoordSeq_setXY_r(geosContext, coordSeq, i, c.x, c.y);
-	}
+	std::vector<Coordinate>& coords = coordinateBuffer();
+	coords.resize(count);
+	iter.nextBatch(coords.data(), count);
+	GEOSCoordSequence* coordSeq = buildCoordSequence(coords.data(), count, geosContext);
 	if (areaFlag)
 	{
 		GEOSGeometry* exteriorRing = GEOSGeom_createLinearRing_r(geosContext, coordSeq);
@@ -32,6 +37,40 @@ GEOSGeometry* GeometryBuilder::buildWayGeometry(const FeaturePtr way, GEOSContex
 	}
 }
 
+std::vector<Coordinate>& GeometryBuilder::coordinateBuffer()
+{
+	thread_local std::vector<Coordinate> buffer;
+	return buffer;
+}
+
+
+GEOSCoordSequence* GeometryBuilder::buildCoordSequence(const Coordinate* coords,
+	size_t count, GEOSContextHandle_t geosContext)
+{
+	#if GEOS_VERSION_MAJOR > 3 || (GEOS_VERSION_MAJOR == 3 && GEOS_VERSION_MINOR >= 10)
+	thread_local std::vector<double> buffer;
+	buffer.resize(count * 2);
+	double* p = buffer.data();
+	for (size_t i = 0; i < count; i++)
+	{
+		*p++ = coords[i].x;
+		*p++ = coords[i].y;
+	}
+	return GEOSCoordSeq_copyFromBuffer_r(geosContext, buffer.data(),
+		static_cast<unsigned int>(count), 0, 0);    // no Z, no M
+	#else
+	GEOSCoordSequence* coordSeq = GEOSCoordSeq_create_r(geosContext,
+		static_cast<unsigned int>(count), 2);   // 2D points
+	for (size_t i = 0; i < count; i++)
+	{
+		GEOSCoordSeq_setXY_r(geosContext, coordSeq, static_cast<unsigned int>(i),
+			coords[i].x, coords[i].y);
+	}
+	return coordSeq;
+	#endif
+}
+
+
 // TODO: consolidate with buildPointGeometry
 GEOSGeometry* GeometryBuilder::buildNodeGeometry(const NodePtr node, GEOSContextHandle_t geosContext)
 {
@@ -63,10 +102,8 @@ GEOSGeometry* GeometryBuilder::buildBoxGeometry(const Box& box, GEOSContextHandl
 
 GEOSGeometry* GeometryBuilder::buildAreaRelationGeometry(FeatureStore* store, RelationPtr relation, GEOSContextHandle_t geosContext)
 {
-	Polygonizer polygonizer;
-	polygonizer.createRings(store, relation);
-	polygonizer.assignAndMergeHoles();
-	return polygonizer.createPolygonal(geosContext);
+	SharedPolygonizer polygonizer = store->ringCache().rings(store, relation);
+	return polygonizer->createPolygonal(geosContext);
 }
 
 
@@ -88,9 +125,14 @@ RelationGeometryBuilder::RelationGeometryBuilder(FeatureStore* store,
 	guard_(relation)
 {
 	gatherMembers(relation);
+	buildMemberGeometries();
 }
 
 
+/**
+ * Collects the members whose geometries make up the collection
+ * (flattening nested non-area relations).
+ */
 void RelationGeometryBuilder::gatherMembers(RelationPtr relation)
 {
 	FastMemberIterator iter(store_, relation);
@@ -99,35 +141,99 @@ void RelationGeometryBuilder::gatherMembers(RelationPtr relation)
 		FeaturePtr member = iter.next();
 		if (member.isNull()) break;
 		int memberType = member.typeCode();
-		GEOSGeometry* g;
 		if (memberType == 1)
 		{
 			WayPtr memberWay(member);
 			if (memberWay.isPlaceholder()) continue;
-			g = GeometryBuilder::buildWayGeometry(memberWay, context_);
 		}
 		else if (memberType == 0)
 		{
 			NodePtr memberNode(member);
 			if (memberNode.isPlaceholder()) continue;
-			g = GeometryBuilder::buildNodeGeometry(memberNode, context_);
 		}
 		else
 		{
 			assert(memberType == 2);
 			RelationPtr childRel(member);
 			if (childRel.isPlaceholder() || !guard_.checkAndAdd(childRel)) continue;
-			if (childRel.isArea())
-			{
-				g = GeometryBuilder::buildAreaRelationGeometry(store_, childRel, context_);
-			}
-			else
+			if (!childRel.isArea())
 			{
 				gatherMembers(childRel);
 				continue;
 			}
 		}
-		geoms_.push_back(g);
+		members_.push_back(member);
+	}
+}
+
+
+GEOSGeometry* RelationGeometryBuilder::buildMemberGeometry(
+	FeaturePtr member, GEOSContextHandle_t context) const
+{
+	int memberType = member.typeCode();
+	if (memberType == 1)
+	{
+		return GeometryBuilder::buildWayGeometry(WayPtr(member), context);
+	}
+	if (memberType == 0)
+	{
+		return GeometryBuilder::buildNodeGeometry(NodePtr(member), context);
+	}
+	return GeometryBuilder::buildAreaRelationGeometry(
+		store_, RelationPtr(member), context);
+}
+
+
+/**
+ * Builds the geometries of the members. For large relations, the
+ * members are split into contiguous ranges, which are built by
+ * separate threads; since a GEOS context handle must not be used
+ * by more than one thread at a time, each of these threads uses
+ * its own (the resulting geometries are not tied to the context
+ * that created them).
+ *
+ * If building any member fails, the geometries that have already
+ * been built are destroyed, and the exception is rethrown on the
+ * calling thread.
+ */
+void RelationGeometryBuilder::buildMemberGeometries()
+{
+	size_t count = members_.size();
+	geoms_.assign(count, nullptr);
+	size_t threadCount = count < MIN_PARALLEL_MEMBERS ? 1 :
+		std::max<size_t>(1, std::min<size_t>(
+			std::thread::hardware_concurrency(), count / MIN_MEMBERS_PER_THREAD));
+	try
+	{
+		if (threadCount == 1)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				geoms_[i] = buildMemberGeometry(members_[i], context_);
+			}
+			return;
+		}
+
+		clarisma::Threads::runInParallel(threadCount,
+			[this, count, threadCount](size_t part)
+		{
+			size_t start = count * part / threadCount;
+			size_t end = count * (part + 1) / threadCount;
+			GeosContext context;
+			for (size_t i = start; i < end; i++)
+			{
+				geoms_[i] = buildMemberGeometry(members_[i], context.handle());
+			}
+		});
+	}
+	catch (...)
+	{
+		for (GEOSGeometry* geom : geoms_)
+		{
+			if (geom) GEOSGeom_destroy_r(context_, geom);
+		}
+		geoms_.clear();
+		throw;
 	}
 }
 
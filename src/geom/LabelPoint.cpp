@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/LabelPoint.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <geodesk/feature/FeatureStore.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+#include <geodesk/geom/Centroid.h>
+#include "geom/polygon/RingCoordinateIterator.h"
+
+namespace geodesk {
+
+/**
+ * Collects the points where the edges of an area's rings cross a
+ * horizontal line. The line is offset by half a unit from the
+ * coordinate grid, so it never passes through a vertex.
+ */
+class Scanline
+{
+public:
+	explicit Scanline(int32_t y) : y_(y), lineY_(y + 0.5) {}
+
+	template<typename Iter>
+	void addRing(Iter& iter)
+	{
+		Coordinate prev = iter.next();
+		for (int count = iter.coordinatesRemaining(); count > 0; count--)
+		{
+			Coordinate next = iter.next();
+			if ((prev.y > lineY_) != (next.y > lineY_))
+			{
+				xs_.push_back(prev.x + (lineY_ - prev.y) *
+					(static_cast<double>(next.x) - prev.x) /
+					(static_cast<double>(next.y) - prev.y));
+			}
+			prev = next;
+		}
+	}
+
+	/**
+	 * Returns the midpoint of the widest span that lies inside the
+	 * area, or `fallback` if the line does not cross the area.
+	 */
+	Coordinate widestSpanCenter(Coordinate fallback)
+	{
+		if (xs_.size() < 2 || (xs_.size() & 1)) return fallback;
+		std::sort(xs_.begin(), xs_.end());
+		double maxWidth = -1;
+		double center = 0;
+		for (size_t i = 0; i < xs_.size(); i += 2)
+		{
+			double width = xs_[i + 1] - xs_[i];
+			if (width > maxWidth)
+			{
+				maxWidth = width;
+				center = (xs_[i] + xs_[i + 1]) / 2;
+			}
+		}
+		return Coordinate(static_cast<int32_t>(std::round(center)), y_);
+	}
+
+private:
+	int32_t y_;
+	double lineY_;
+	std::vector<double> xs_;
+};
+
+
+static Coordinate halfwayAlong(WayPtr way)
+{
+	std::vector<Coordinate> coords;
+	WayCoordinateIterator iter(way);
+	int count = iter.coordinatesRemaining();
+	coords.resize(count);
+	iter.nextBatch(coords.data(), count);
+	if (count < 2) return count ? coords[0] : way.bounds().center();
+
+	double total = 0;
+	for (int i = 1; i < count; i++)
+	{
+		total += std::hypot(static_cast<double>(coords[i].x) - coords[i - 1].x,
+			static_cast<double>(coords[i].y) - coords[i - 1].y);
+	}
+	double remaining = total / 2;
+	for (int i = 1; i < count; i++)
+	{
+		Coordinate a = coords[i - 1];
+		Coordinate b = coords[i];
+		double len = std::hypot(static_cast<double>(b.x) - a.x,
+			static_cast<double>(b.y) - a.y);
+		if (len >= remaining && len > 0)
+		{
+			double f = remaining / len;
+			return Coordinate(
+				static_cast<int32_t>(std::round(a.x + (static_cast<double>(b.x) - a.x) * f)),
+				static_cast<int32_t>(std::round(a.y + (static_cast<double>(b.y) - a.y) * f)));
+		}
+		remaining -= len;
+	}
+	return coords[count - 1];
+}
+
+
+Coordinate LabelPoint::ofWay(WayPtr way)
+{
+	if (!way.isArea()) return halfwayAlong(way);
+	Coordinate centroid = Centroid::ofWay(way);
+	Scanline scanline(centroid.y);
+	WayCoordinateIterator iter(way);
+	scanline.addRing(iter);
+	return scanline.widestSpanCenter(centroid);
+}
+
+
+Coordinate LabelPoint::ofRelation(FeatureStore* store, RelationPtr relation)
+{
+	Coordinate centroid = Centroid::ofRelation(store, relation);
+	if (!relation.isArea()) return centroid;
+	Scanline scanline(centroid.y);
+	SharedPolygonizer polygonizer = store->ringCache().rings(store, relation, false);
+	polygonizer->forEachRing([&scanline](const Polygonizer::Ring* ring, bool)
+	{
+		RingCoordinateIterator iter(ring);
+		scanline.addRing(iter);
+	});
+	return scanline.widestSpanCenter(centroid);
+}
+
+
+Coordinate LabelPoint::ofFeature(FeatureStore* store, FeaturePtr feature)
+{
+	if (feature.isWay()) return ofWay(WayPtr(feature));
+	if (feature.isRelation()) return ofRelation(store, RelationPtr(feature));
+	return NodePtr(feature).xy();
+}
+
+} // namespace geodesk
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include "geom/LambertArea.h"
+#include <geodesk/feature/FeatureStore.h>
 #include <geodesk/feature/WayCoordinateIterator.h>
 #include "geom/polygon/RingCoordinateIterator.h"
 
@@ -13,7 +14,10 @@ double LambertArea::signedOfWay(const WayPtr way)
     assert(way.isArea());
     WayCoordinateIterator iter;
     iter.start(way, FeatureFlags::AREA);
-    return signedOfAbstractRing(iter);
+    return signedOfBatches([&iter](Coordinate* coords, int maxCount)
+    {
+        return iter.nextBatch(coords, maxCount);
+    });
 }
 
 
@@ -29,20 +33,12 @@ double LambertArea::ofRelation(FeatureStore* store, const RelationPtr relation)
     assert(relation.isArea());
     double totalArea = 0;
 
-    Polygonizer polygonizer;
-    polygonizer.createRings(store, relation);
-    const Polygonizer::Ring* ring = polygonizer.outerRings();
-    while (ring)
-    {
-        totalArea += LambertArea::ofRing(ring);
-        ring = ring->next();
-    }
-    ring = polygonizer.innerRings();
-    while (ring)
+    SharedPolygonizer polygonizer = store->ringCache().rings(store, relation, false);
+    polygonizer->forEachRing([&totalArea](const Polygonizer::Ring* ring, bool isOuter)
     {
-        totalArea -= LambertArea::ofRing(ring);
-        ring = ring->next();
-    }
+        double area = LambertArea::ofRing(ring);
+        totalArea += isOuter ? area : -area;
+    });
     return totalArea;
 }
 
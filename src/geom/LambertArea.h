@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <geodesk/feature/WayCoordinateIterator.h>
 #include <geodesk/geom/polygon/Polygonizer.h>
+#include <geodesk/geom/MeasureKernels.h>
 #include "project/Lambert.h"
 #include "project/Sinusoidal.h"
 #include <geodesk/geom/Mercator.h>
@@ -44,12 +47,9 @@ public:
 
     static ProjectedCoordinate project(Coordinate c)
     {
-        double lat = Mercator::latFromY(c.y);
-        return ProjectedCoordinate
-        {
-            Sinusoidal::xFromLonLat(Mercator::lonFromX(c.x), lat),
-            Sinusoidal::yFromLat(lat)
-        };
+        ProjectedCoordinate p;
+        MeasureKernels::projectSinusoidal(&c, 1, &p.x, &p.y);
+        return p;
     }
 
     /*
@@ -66,22 +66,47 @@ public:
 	template<typename Iter>
 	static double signedOfAbstractRing(Iter& iter)
 	{
-        ProjectedCoordinate prev = project(iter.next());
-        ProjectedCoordinate middle = project(iter.next());
-        double sum = 0.0;
-        double x0 = prev.x;
-        for (int count = iter.coordinatesRemaining(); count > 0; count--)
+        return signedOfBatches([&iter](Coordinate* coords, int maxCount)
         {
-            ProjectedCoordinate next = project(iter.next());
-            double x = middle.x - x0;
-            double y1 = next.y;
-            double y2 = prev.y;
-            sum += x * (y2 - y1);
-            prev = middle;
-            middle = next;
-        }
-        return sum / 2.0;
+            int count = std::min(iter.coordinatesRemaining(), maxCount);
+            for (int i = 0; i < count; i++) coords[i] = iter.next();
+            return count;
+        });
 	}
+
+private:
+    static constexpr int BATCH_SIZE = WayCoordinateIterator::BATCH_SIZE;
+
+    /**
+     * Returns the signed area of a ring whose coordinates are
+     * supplied in batches by `nextBatch(coords, maxCount)`, which
+     * returns the number of coordinates it placed into `coords`
+     * (0 once the ring has been exhausted). The coordinates are
+     * projected in bulk; each batch overlaps the previous by two
+     * coordinates.
+     */
+    template<typename NextBatch>
+    static double signedOfBatches(NextBatch&& nextBatch)
+    {
+        double x[BATCH_SIZE];
+        double y[BATCH_SIZE];
+        double x0 = 0;
+        double sum = 0.0;
+        bool first = true;
+        WayCoordinateIterator::forEachSegmentBatch<2>(
+            std::forward<NextBatch>(nextBatch),
+            [&](const Coordinate* coords, int count)
+            {
+                MeasureKernels::projectSinusoidal(coords, count, x, y);
+                if (first)
+                {
+                    x0 = x[0];
+                    first = false;
+                }
+                sum += MeasureKernels::shoelace(x, y, count, x0);
+            });
+        return sum / 2.0;
+    }
 };
 
 } // namespace geodesk
@@ -4,7 +4,7 @@
 #include <geodesk/geom/Length.h>
 #include <geodesk/feature/FastMemberIterator.h>
 #include <geodesk/feature/WayCoordinateIterator.h>
-#include <geodesk/geom/Distance.h>
+#include <geodesk/geom/MeasureKernels.h>
 
 namespace geodesk {
 
@@ -12,14 +12,10 @@ double Length::ofWay(WayPtr way)
 {
     double d = 0;
     WayCoordinateIterator iter(way);
-    Coordinate p1 = iter.next();
-    for (;;)
+    iter.forEachSegmentBatch([&d](const Coordinate* coords, int count)
     {
-        Coordinate p2 = iter.next();
-        if (p2.isNull()) break;
-        d += Distance::metersBetween(p1, p2);
-        p1 = p2;
-    }
+        d += MeasureKernels::length(coords, count);
+    });
     return d;
 }
 
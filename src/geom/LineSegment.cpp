@@ -53,5 +53,35 @@ bool LineSegment::linesIntersect(
 }
 
 
+int LineSegment::signOfDifference(int64_t a, int64_t b, int64_t c, int64_t d)
+{
+    int sign1 = (a == 0 || b == 0) ? 0 : (((a < 0) != (b < 0)) ? -1 : 1);
+    int sign2 = (c == 0 || d == 0) ? 0 : (((c < 0) != (d < 0)) ? -1 : 1);
+    if (sign1 != sign2) return sign1 > sign2 ? 1 : -1;
+    if (sign1 == 0) return 0;
+
+    // Same sign: compare the magnitudes of the products
+    auto multiply = [](uint64_t x, uint64_t y, uint64_t& hi, uint64_t& lo)
+    {
+        uint64_t p0 = (x & 0xffff'ffff) * (y & 0xffff'ffff);
+        uint64_t p1 = (x & 0xffff'ffff) * (y >> 32);
+        uint64_t p2 = (x >> 32) * (y & 0xffff'ffff);
+        uint64_t p3 = (x >> 32) * (y >> 32);
+        uint64_t mid = (p0 >> 32) + (p1 & 0xffff'ffff) + (p2 & 0xffff'ffff);
+        lo = (mid << 32) | (p0 & 0xffff'ffff);
+        hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+    };
+    auto magnitude = [](int64_t v)
+    {
+        return v < 0 ? static_cast<uint64_t>(0) - static_cast<uint64_t>(v) :
+            static_cast<uint64_t>(v);
+    };
+    uint64_t hi1, lo1, hi2, lo2;
+    multiply(magnitude(a), magnitude(b), hi1, lo1);
+    multiply(magnitude(c), magnitude(d), hi2, lo2);
+    if (hi1 == hi2 && lo1 == lo2) return 0;
+    bool greater = hi1 != hi2 ? hi1 > hi2 : lo1 > lo2;
+    return greater ? sign1 : -sign1;
+}
 
 } // namespace geodesk
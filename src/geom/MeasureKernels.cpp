@@ -0,0 +1,262 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/MeasureKernels.h>
+#include <cmath>
+#include <cstdint>
+#include <clarisma/sys/CpuFeatures.h>
+#include <geodesk/geom/Mercator.h>
+#include "geom/ApproxMath.h"
+#include "geom/project/Sinusoidal.h"
+
+namespace geodesk {
+
+using namespace ApproxMath;
+
+// ==================================================================
+//  Constants
+// ==================================================================
+
+static constexpr double METERS_PER_UNIT_AT_EQUATOR =
+	Mercator::EARTH_CIRCUMFERENCE / Mercator::MAP_WIDTH;
+
+// ==================================================================
+//  Scalar
+// ==================================================================
+
+double MeasureKernels::exp(double t)
+{
+	return ApproxMath::exp(t);
+}
+
+
+double MeasureKernels::atan(double x)
+{
+	return ApproxMath::atan(x);
+}
+
+
+static inline double segmentMeters(Coordinate a, Coordinate b)
+{
+	double dx = static_cast<double>(a.x) - b.x;
+	double dy = static_cast<double>(a.y) - b.y;
+	double d = std::sqrt(dx * dx + dy * dy);
+	// Same as Math::avg()
+	double y = std::trunc((static_cast<double>(a.y) + b.y) * 0.5);
+	double e = MeasureKernels::exp(y * RADIANS_PER_UNIT);
+	return d * METERS_PER_UNIT_AT_EQUATOR * (2 * e / (e * e + 1));
+}
+
+
+static inline void projectSinusoidalCoordinate(Coordinate c, double* x, double* y)
+{
+	double e = MeasureKernels::exp(c.y * RADIANS_PER_UNIT);
+	double lat = MeasureKernels::atan(e) * 2 - PI_2;
+	double cosLat = 2 * e / (e * e + 1);
+	*x = Sinusoidal::EARTH_RADIUS * (c.x * RADIANS_PER_UNIT) * cosLat;
+	*y = Sinusoidal::EARTH_RADIUS * lat;
+}
+
+
+static double lengthScalar(const Coordinate* coords, size_t count)
+{
+	double sum = 0;
+	for (size_t i = 1; i < count; i++) sum += segmentMeters(coords[i - 1], coords[i]);
+	return sum;
+}
+
+
+static void projectSinusoidalScalar(const Coordinate* coords, size_t count,
+	double* x, double* y)
+{
+	for (size_t i = 0; i < count; i++) projectSinusoidalCoordinate(coords[i], x + i, y + i);
+}
+
+
+static double shoelaceScalar(const Coordinate* coords, size_t count, double x0)
+{
+	double sum = 0;
+	for (size_t i = 1; i + 1 < count; i++)
+	{
+		sum += (coords[i].x - x0) *
+			(static_cast<double>(coords[i - 1].y) - coords[i + 1].y);
+	}
+	return sum;
+}
+
+
+static double shoelaceProjectedScalar(const double* x, const double* y,
+	size_t count, double x0)
+{
+	double sum = 0;
+	for (size_t i = 1; i + 1 < count; i++)
+	{
+		sum += (x[i] - x0) * (y[i - 1] - y[i + 1]);
+	}
+	return sum;
+}
+
+
+#ifdef GEODESK_APPROX_MATH_X86
+
+// ==================================================================
+//  AVX2 (4 coordinates at a time)
+// ==================================================================
+
+GEODESK_TARGET_AVX2
+static inline double horizontalSum(__m256d v)
+{
+	__m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+
+GEODESK_TARGET_AVX2
+static double lengthAvx2(const Coordinate* coords, size_t count)
+{
+	__m256d sum = _mm256_setzero_pd();
+	size_t i = 1;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d x1, y1, x2, y2;
+		load4(coords + i - 1, x1, y1);
+		load4(coords + i, x2, y2);
+		__m256d dx = _mm256_sub_pd(x1, x2);
+		__m256d dy = _mm256_sub_pd(y1, y2);
+		__m256d d = _mm256_sqrt_pd(_mm256_add_pd(
+			_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+		__m256d y = _mm256_round_pd(
+			_mm256_mul_pd(_mm256_add_pd(y1, y2), _mm256_set1_pd(0.5)),
+			_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+		__m256d e = exp4(_mm256_mul_pd(y, _mm256_set1_pd(RADIANS_PER_UNIT)));
+		__m256d cosLat = _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), e),
+			_mm256_add_pd(_mm256_mul_pd(e, e), _mm256_set1_pd(1.0)));
+		sum = _mm256_add_pd(sum, _mm256_mul_pd(
+			_mm256_mul_pd(d, _mm256_set1_pd(METERS_PER_UNIT_AT_EQUATOR)), cosLat));
+	}
+	double total = horizontalSum(sum);
+	for (; i < count; i++) total += segmentMeters(coords[i - 1], coords[i]);
+	return total;
+}
+
+
+GEODESK_TARGET_AVX2
+static void projectSinusoidalAvx2(const Coordinate* coords, size_t count,
+	double* x, double* y)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d cx, cy;
+		load4(coords + i, cx, cy);
+		__m256d e = exp4(_mm256_mul_pd(cy, _mm256_set1_pd(RADIANS_PER_UNIT)));
+		__m256d lat = _mm256_sub_pd(
+			_mm256_mul_pd(atan4(e), _mm256_set1_pd(2.0)), _mm256_set1_pd(PI_2));
+		__m256d cosLat = _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), e),
+			_mm256_add_pd(_mm256_mul_pd(e, e), _mm256_set1_pd(1.0)));
+		__m256d radius = _mm256_set1_pd(Sinusoidal::EARTH_RADIUS);
+		_mm256_storeu_pd(x + i, _mm256_mul_pd(_mm256_mul_pd(radius,
+			_mm256_mul_pd(cx, _mm256_set1_pd(RADIANS_PER_UNIT))), cosLat));
+		_mm256_storeu_pd(y + i, _mm256_mul_pd(radius, lat));
+	}
+	for (; i < count; i++) projectSinusoidalCoordinate(coords[i], x + i, y + i);
+}
+
+
+GEODESK_TARGET_AVX2
+static double shoelaceAvx2(const Coordinate* coords, size_t count, double x0)
+{
+	__m256d sum = _mm256_setzero_pd();
+	__m256d origin = _mm256_set1_pd(x0);
+	size_t i = 1;
+	for (; i + 5 <= count; i += 4)
+	{
+		__m256d xPrev, yPrev, x, y, xNext, yNext;
+		load4(coords + i - 1, xPrev, yPrev);
+		load4(coords + i, x, y);
+		load4(coords + i + 1, xNext, yNext);
+		sum = _mm256_add_pd(sum, _mm256_mul_pd(
+			_mm256_sub_pd(x, origin), _mm256_sub_pd(yPrev, yNext)));
+	}
+	double total = horizontalSum(sum);
+	for (; i + 1 < count; i++)
+	{
+		total += (coords[i].x - x0) *
+			(static_cast<double>(coords[i - 1].y) - coords[i + 1].y);
+	}
+	return total;
+}
+
+
+GEODESK_TARGET_AVX2
+static double shoelaceProjectedAvx2(const double* x, const double* y,
+	size_t count, double x0)
+{
+	__m256d sum = _mm256_setzero_pd();
+	__m256d origin = _mm256_set1_pd(x0);
+	size_t i = 1;
+	for (; i + 5 <= count; i += 4)
+	{
+		sum = _mm256_add_pd(sum, _mm256_mul_pd(
+			_mm256_sub_pd(_mm256_loadu_pd(x + i), origin),
+			_mm256_sub_pd(_mm256_loadu_pd(y + i - 1), _mm256_loadu_pd(y + i + 1))));
+	}
+	double total = horizontalSum(sum);
+	for (; i + 1 < count; i++) total += (x[i] - x0) * (y[i - 1] - y[i + 1]);
+	return total;
+}
+
+
+#endif // GEODESK_APPROX_MATH_X86
+
+// ==================================================================
+//  Dispatch
+// ==================================================================
+
+MeasureKernels::Dispatch& MeasureKernels::dispatch()
+{
+	static Dispatch dispatch = []()
+	{
+		Dispatch d{ lengthScalar, projectSinusoidalScalar, shoelaceScalar,
+			shoelaceProjectedScalar, Implementation::SCALAR };
+		#ifdef GEODESK_APPROX_MATH_X86
+		if (clarisma::CpuFeatures::hasAvx2())
+		{
+			d = { lengthAvx2, projectSinusoidalAvx2, shoelaceAvx2,
+				shoelaceProjectedAvx2, Implementation::AVX2 };
+		}
+		#endif
+		return d;
+	}();
+	return dispatch;
+}
+
+
+bool MeasureKernels::select(Implementation impl)
+{
+	Dispatch& d = dispatch();
+	switch (impl)
+	{
+	case Implementation::SCALAR:
+		d = { lengthScalar, projectSinusoidalScalar, shoelaceScalar,
+			shoelaceProjectedScalar, impl };
+		return true;
+	#ifdef GEODESK_APPROX_MATH_X86
+	case Implementation::AVX2:
+		if (!clarisma::CpuFeatures::hasAvx2()) return false;
+		d = { lengthAvx2, projectSinusoidalAvx2, shoelaceAvx2,
+			shoelaceProjectedAvx2, impl };
+		return true;
+	#endif
+	default:
+		return false;
+	}
+}
+
+
+const char* MeasureKernels::implementationName()
+{
+	return implementation() == Implementation::AVX2 ? "AVX2" : "scalar";
+}
+
+} // namespace geodesk
@@ -0,0 +1,171 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/PointDistance.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <geodesk/feature/FastMemberIterator.h>
+#include <geodesk/feature/FeatureStore.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+#include <geodesk/geom/Distance.h>
+#include <geodesk/geom/polygon/PointInPolygon.h>
+
+namespace geodesk {
+
+double PointDistance::toBoxSquared(const Box& box) const
+{
+    double dx = std::max(std::max(
+        static_cast<double>(box.minX()) - xy_.x,
+        static_cast<double>(xy_.x) - box.maxX()), 0.0);
+    double dy = std::max(std::max(
+        static_cast<double>(box.minY()) - xy_.y,
+        static_cast<double>(xy_.y) - box.maxY()), 0.0);
+    return dx * dx + dy * dy;
+}
+
+
+double PointDistance::toFarthestCornerSquared(const Box& box) const
+{
+    double dx = std::max(
+        std::abs(static_cast<double>(box.minX()) - xy_.x),
+        std::abs(static_cast<double>(box.maxX()) - xy_.x));
+    double dy = std::max(
+        std::abs(static_cast<double>(box.minY()) - xy_.y),
+        std::abs(static_cast<double>(box.maxY()) - xy_.y));
+    return dx * dx + dy * dy;
+}
+
+
+double PointDistance::toNodeSquared(NodePtr node) const
+{
+    return Distance::pointsSquared(node.x(), node.y(), xy_.x, xy_.y);
+}
+
+
+double PointDistance::segmentsSquared(WayPtr way, int areaFlag) const
+{
+    WayCoordinateIterator iter;
+    iter.start(way, areaFlag);
+    Coordinate c = iter.next();
+    double x1 = c.x;
+    double y1 = c.y;
+    double minDistance = Distance::pointsSquared(x1, y1, xy_.x, xy_.y);
+    for (;;)
+    {
+        if (minDistance < stopSquared_) break;
+        c = iter.next();
+        if (c.isNull()) break;
+        double x2 = c.x;
+        double y2 = c.y;
+        minDistance = std::min(minDistance,
+            Distance::pointSegmentSquared(x1, y1, x2, y2, xy_.x, xy_.y));
+        x1 = x2;
+        y1 = y2;
+    }
+    return minDistance;
+}
+
+
+double PointDistance::toWaySquared(WayPtr way) const
+{
+    if (way.isArea())
+    {
+        double d = segmentsSquared(way, FeatureFlags::AREA);
+        if (d < stopSquared_ || d == 0) return d;
+
+        // The distance of a point that lies within a polygon is zero;
+        // we need to perform the p-in-p check because the edges
+        // themselves may be far away from the point
+        if (way.bounds().contains(xy_))
+        {
+            PointInPolygon pip(xy_);
+            pip.testAgainstWay(way);
+            if (pip.isInside()) return 0;
+        }
+        return d;
+    }
+    return segmentsSquared(way, 0);
+}
+
+
+double PointDistance::areaRelationSquared(FeatureStore* store, RelationPtr relation) const
+{
+    // Measure the distance to the ways that define shell and holes,
+    // and also perform the point-in-polygon test
+    double minDistance = std::numeric_limits<double>::infinity();
+    PointInPolygon pip(xy_);
+    FastMemberIterator iter(store, relation);
+    for (;;)
+    {
+        FeaturePtr member = iter.next();
+        if (member.isNull()) break;
+        if (!member.isWay()) continue;
+        WayPtr memberWay(member);
+        if (memberWay.isPlaceholder()) continue;
+        minDistance = std::min(minDistance,
+            segmentsSquared(memberWay, member.flags()));
+        if (minDistance < stopSquared_) return minDistance;
+        pip.testAgainstWay(memberWay);
+            // No bbox check needed, testAgainstWay() does it
+    }
+    return pip.isInside() ? 0 : minDistance;
+}
+
+
+double PointDistance::membersSquared(FeatureStore* store, RelationPtr relation,
+    RecursionGuard& guard) const
+{
+    double minDistance = std::numeric_limits<double>::infinity();
+    FastMemberIterator iter(store, relation);
+    for (;;)
+    {
+        FeaturePtr member = iter.next();
+        if (member.isNull()) break;
+        int typeCode = member.typeCode();
+        if (typeCode == 1)
+        {
+            WayPtr memberWay(member);
+            if (memberWay.isPlaceholder()) continue;
+            minDistance = std::min(minDistance, toWaySquared(memberWay));
+        }
+        else if (typeCode == 0)
+        {
+            NodePtr memberNode(member);
+            if (memberNode.isPlaceholder()) continue;
+            minDistance = std::min(minDistance, toNodeSquared(memberNode));
+        }
+        else
+        {
+            RelationPtr memberRel(member);
+            if (memberRel.isPlaceholder() || !guard.checkAndAdd(memberRel)) continue;
+            if (memberRel.isArea())
+            {
+                minDistance = std::min(minDistance,
+                    areaRelationSquared(store, memberRel));
+            }
+            else
+            {
+                minDistance = std::min(minDistance,
+                    membersSquared(store, memberRel, guard));
+            }
+        }
+        if (minDistance < stopSquared_) break;
+    }
+    return minDistance;
+}
+
+
+double PointDistance::toFeatureSquared(FeatureStore* store, FeaturePtr feature) const
+{
+    FeatureType type = feature.type();
+    if (type == FeatureType::NODE) return toNodeSquared(NodePtr(feature));
+    if (type == FeatureType::WAY) return toWaySquared(WayPtr(feature));
+    assert(type == FeatureType::RELATION);
+    RelationPtr relation(feature);
+    if (relation.isArea()) return areaRelationSquared(store, relation);
+    RecursionGuard guard(relation);
+    return membersSquared(store, relation, guard);
+}
+
+} // namespace geodesk
@@ -0,0 +1,296 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/Simplifier.h>
+#include <cmath>
+#include <queue>
+#include <clarisma/math/Math.h>
+#include <geodesk/feature/FastMemberIterator.h>
+#include <geodesk/feature/NodePtr.h>
+#include <geodesk/feature/WayCoordinateIterator.h>
+#include <geodesk/geom/Distance.h>
+#include <geodesk/geom/Mercator.h>
+#include "geom/polygon/Ring.h"
+#include "geom/polygon/RingCoordinateIterator.h"
+
+namespace geodesk {
+
+double Simplifier::unitsPerPixel(int zoom)
+{
+    return Mercator::MAP_WIDTH / 256 / std::ldexp(1.0, zoom);
+}
+
+
+double Simplifier::toleranceAt(int32_t y) const
+{
+    if (units_ > 0) return units_;
+    return Mercator::unitsFromMeters(meters_, y);
+}
+
+
+size_t Simplifier::simplify(Coordinate* coords, size_t count, double tolerance) const
+{
+    if (tolerance <= 0) return count;
+    return method_ == Method::VISVALINGAM ?
+        visvalingam(coords, count, tolerance) :
+        douglasPeucker(coords, count, tolerance);
+}
+
+
+/**
+ * Removes the coordinates that are not marked as kept, and returns
+ * the number of remaining coordinates.
+ */
+static size_t compact(Coordinate* coords, size_t count, const std::vector<bool>& keep)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (keep[i]) coords[n++] = coords[i];
+    }
+    return n;
+}
+
+
+size_t Simplifier::douglasPeucker(Coordinate* coords, size_t count, double tolerance)
+{
+    if (count < 3) return count;
+    double toleranceSquared = tolerance * tolerance;
+    std::vector<bool> keep(count, false);
+    keep[0] = true;
+    keep[count - 1] = true;
+
+    // Instead of recursing, we keep a stack of the spans that
+    // remain to be checked
+    std::vector<std::pair<size_t, size_t>> spans;
+    spans.emplace_back(0, count - 1);
+    while (!spans.empty())
+    {
+        auto [start, end] = spans.back();
+        spans.pop_back();
+        if (end - start < 2) continue;
+        Coordinate a = coords[start];
+        Coordinate b = coords[end];
+        double maxDistanceSquared = 0;
+        size_t farthest = start;
+        for (size_t i = start + 1; i < end; i++)
+        {
+            double d = Distance::pointSegmentSquared(a.x, a.y, b.x, b.y,
+                coords[i].x, coords[i].y);
+            if (d > maxDistanceSquared)
+            {
+                maxDistanceSquared = d;
+                farthest = i;
+            }
+        }
+        if (maxDistanceSquared <= toleranceSquared) continue;
+        keep[farthest] = true;
+        spans.emplace_back(start, farthest);
+        spans.emplace_back(farthest, end);
+    }
+    return compact(coords, count, keep);
+}
+
+
+static double triangleArea(Coordinate a, Coordinate b, Coordinate c)
+{
+    return std::abs(
+        (static_cast<double>(b.x) - a.x) * (static_cast<double>(c.y) - a.y) -
+        (static_cast<double>(c.x) - a.x) * (static_cast<double>(b.y) - a.y)) / 2;
+}
+
+
+size_t Simplifier::visvalingam(Coordinate* coords, size_t count, double tolerance)
+{
+    if (count < 3) return count;
+    double maxArea = tolerance * tolerance;
+
+    // The remaining coordinates form a doubly-linked list; each
+    // interior coordinate is entered into a min-heap by the area of
+    // the triangle formed with its neighbors. When a coordinate is
+    // removed, its neighbors are re-entered with their new areas
+    // (outdated heap entries are skipped)
+    std::vector<size_t> prev(count);
+    std::vector<size_t> next(count);
+    std::vector<double> area(count);
+    std::vector<bool> keep(count, true);
+    using Entry = std::pair<double, size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (size_t i = 0; i < count; i++)
+    {
+        prev[i] = i - 1;
+        next[i] = i + 1;
+    }
+    for (size_t i = 1; i < count - 1; i++)
+    {
+        area[i] = triangleArea(coords[i - 1], coords[i], coords[i + 1]);
+        heap.emplace(area[i], i);
+    }
+
+    while (!heap.empty())
+    {
+        auto [a, i] = heap.top();
+        if (a >= maxArea) break;
+        heap.pop();
+        if (!keep[i] || a != area[i]) continue;     // outdated entry
+        keep[i] = false;
+        size_t p = prev[i];
+        size_t n = next[i];
+        next[p] = n;
+        prev[n] = p;
+
+        // A neighbor's area never drops below the area of the removed
+        // coordinate, so coordinates are removed in ascending order
+        if (p > 0)
+        {
+            area[p] = std::max(a, triangleArea(coords[prev[p]], coords[p], coords[n]));
+            heap.emplace(area[p], p);
+        }
+        if (n < count - 1)
+        {
+            area[n] = std::max(a, triangleArea(coords[p], coords[n], coords[next[n]]));
+            heap.emplace(area[n], n);
+        }
+    }
+    return compact(coords, count, keep);
+}
+
+
+size_t Simplifier::simplifyWay(Coordinate* coords, size_t count) const
+{
+    if (!isEnabled() || count < 3) return count;
+    thread_local std::vector<Coordinate> original;
+    original.assign(coords, coords + count);
+    Coordinate first = coords[0];
+    Coordinate last = coords[count - 1];
+    size_t n = simplify(coords, count,
+        toleranceAt(clarisma::Math::avg(first.y, last.y)));
+    if (n < 3)
+    {
+        // Keep the vertex farthest from the line between the endpoints
+        // (or from the first vertex, if the way is closed), so the ways
+        // that form a ring can't collapse it into a line
+        double maxDistanceSquared = -1;
+        size_t farthest = 1;
+        for (size_t i = 1; i < count - 1; i++)
+        {
+            double d = Distance::pointSegmentSquared(first.x, first.y,
+                last.x, last.y, original[i].x, original[i].y);
+            if (d > maxDistanceSquared)
+            {
+                maxDistanceSquared = d;
+                farthest = i;
+            }
+        }
+        coords[0] = first;
+        coords[1] = original[farthest];
+        coords[2] = last;
+        n = 3;
+    }
+    if (first == last && n < 4)
+    {
+        // Don't let a closed way collapse
+        std::copy(original.begin(), original.end(), coords);
+        return count;
+    }
+    return n;
+}
+
+
+void Simplifier::simplifyWay(WayPtr way, std::vector<Coordinate>& out) const
+{
+    size_t start = out.size();
+    WayCoordinateIterator iter(way);
+    int count = iter.coordinatesRemaining();
+    out.resize(start + count);
+    iter.nextBatch(out.data() + start, count);
+    out.resize(start + simplifyWay(out.data() + start, count));
+}
+
+
+std::vector<std::vector<Coordinate>> Simplifier::simplifyFeature(
+    FeatureStore* store, FeaturePtr feature) const
+{
+    std::vector<std::vector<Coordinate>> parts;
+    if (feature.isRelation())
+    {
+        RecursionGuard guard((RelationPtr(feature)));
+        simplifyFeature(store, feature, &guard, parts);
+    }
+    else
+    {
+        simplifyFeature(store, feature, nullptr, parts);
+    }
+    return parts;
+}
+
+
+void Simplifier::simplifyFeature(FeatureStore* store, FeaturePtr feature,
+    RecursionGuard* guard, std::vector<std::vector<Coordinate>>& parts) const
+{
+    if (feature.isNode())
+    {
+        parts.push_back({ NodePtr(feature).xy() });
+        return;
+    }
+    if (feature.isWay())
+    {
+        parts.emplace_back();
+        simplifyWay(WayPtr(feature), parts.back());
+        return;
+    }
+    RelationPtr relation(feature);
+    if (relation.isArea())
+    {
+        simplifyAreaRelation(store, relation, parts);
+        return;
+    }
+    FastMemberIterator iter(store, relation);
+    for (;;)
+    {
+        FeaturePtr member = iter.next();
+        if (member.isNull()) break;
+        int memberType = member.typeCode();
+        if (memberType == 0)
+        {
+            if (NodePtr(member).isPlaceholder()) continue;
+        }
+        else if (memberType == 1)
+        {
+            if (WayPtr(member).isPlaceholder()) continue;
+        }
+        else
+        {
+            RelationPtr childRel(member);
+            if (childRel.isPlaceholder() || !guard->checkAndAdd(childRel)) continue;
+        }
+        simplifyFeature(store, member, guard, parts);
+    }
+}
+
+
+void Simplifier::simplifyAreaRelation(FeatureStore* store, RelationPtr relation,
+    std::vector<std::vector<Coordinate>>& parts) const
+{
+    // The member ways are simplified before the rings are assembled,
+    // so we can't use the store's RingCache
+    Polygonizer polygonizer;
+    polygonizer.createRings(store, relation, this);
+    polygonizer.assignAndMergeHoles();
+    for (const Polygonizer::Ring* ring = polygonizer.outerRings(); ring; ring = ring->next())
+    {
+        for (const Polygonizer::Ring* r = ring; r;
+            r = (r == ring) ? ring->firstInner() : r->next())
+        {
+            RingCoordinateIterator iter(r);
+            std::vector<Coordinate>& part = parts.emplace_back();
+            part.reserve(iter.coordinatesRemaining());
+            for (int i = iter.coordinatesRemaining(); i > 0; i--)
+            {
+                part.push_back(iter.next());
+            }
+        }
+    }
+}
+
+} // namespace geodesk
@@ -0,0 +1,375 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/index/ChainKernels.h>
+#include <bit>
+#include <clarisma/sys/CpuFeatures.h>
+#include <geodesk/geom/LineSegment.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GEODESK_CHAIN_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GEODESK_TARGET_AVX2
+#else
+#define GEODESK_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace geodesk {
+
+// ==================================================================
+//  Scalar
+// ==================================================================
+
+/**
+ * Tests a single segment; same logic as PointInPolygon::testAgainstWay().
+ *
+ * @return true if the point lies on the segment
+ */
+static inline bool countSegmentCrossing(Coordinate prev, Coordinate next,
+	Coordinate pt, uint32_t& crossings)
+{
+	// we normalize the vector so it always points upwards
+	Coordinate start = prev.y < next.y ? prev : next;
+	Coordinate end = prev.y < next.y ? next : prev;
+	if (pt.y >= start.y && pt.y <= end.y)
+	{
+		int orientation = LineSegment::orientation(start, end, pt);
+		if (orientation == 0) return true;
+		crossings += orientation > 0 ?
+			((pt.y == start.y || pt.y == end.y) ? 1 : 2) : 0;
+		// We count a ray crossing through a vertex as one-half
+	}
+	return false;
+}
+
+
+static inline bool pairIntersects(const ChainKernels::SegmentPairs& pairs, int i)
+{
+	return LineSegment::linesIntersect(
+		pairs.x1[i], pairs.y1[i], pairs.x2[i], pairs.y2[i],
+		pairs.x3[i], pairs.y3[i], pairs.x4[i], pairs.y4[i]);
+}
+
+
+static bool countCrossingsScalar(const Coordinate* coords, size_t count,
+	Coordinate pt, uint32_t& crossings)
+{
+	for (size_t i = 1; i < count; i++)
+	{
+		if (countSegmentCrossing(coords[i - 1], coords[i], pt, crossings)) return true;
+	}
+	return false;
+}
+
+
+static bool anyIntersectScalar(const ChainKernels::SegmentPairs& pairs)
+{
+	for (int i = 0; i < pairs.count; i++)
+	{
+		if (pairIntersects(pairs, i)) return true;
+	}
+	return false;
+}
+
+
+#ifdef GEODESK_CHAIN_KERNELS_X86
+
+// ==================================================================
+//  SSE2 (2 segments at a time)
+// ==================================================================
+
+static inline __m128d selectSse2(__m128d mask, __m128d a, __m128d b)
+{
+	// a where mask is set, otherwise b
+	return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+/**
+ * Same as LineSegment::orientation() up to the collinearity check
+ */
+static inline __m128d crossProductSse2(__m128d x1, __m128d y1,
+	__m128d x2, __m128d y2, __m128d px, __m128d py)
+{
+	x2 = _mm_sub_pd(x2, x1);
+	y2 = _mm_sub_pd(y2, y1);
+	px = _mm_sub_pd(px, x1);
+	py = _mm_sub_pd(py, y1);
+	return _mm_sub_pd(_mm_mul_pd(px, y2), _mm_mul_pd(py, x2));
+}
+
+
+static bool countCrossingsSse2(const Coordinate* coords, size_t count,
+	Coordinate pt, uint32_t& crossings)
+{
+	if (count < 2) return false;
+	size_t segmentCount = count - 1;
+	const __m128d px = _mm_set1_pd(pt.x);
+	const __m128d py = _mm_set1_pd(pt.y);
+	const __m128d zero = _mm_setzero_pd();
+	size_t i = 0;
+	for (; i + 2 <= segmentCount; i += 2)
+	{
+		// x0 y0 x1 y1 --> x0 x1 y0 y1
+		__m128i a = _mm_shuffle_epi32(_mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(coords + i)), _MM_SHUFFLE(3, 1, 2, 0));
+		__m128i b = _mm_shuffle_epi32(_mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(coords + i + 1)), _MM_SHUFFLE(3, 1, 2, 0));
+		__m128d ax = _mm_cvtepi32_pd(a);
+		__m128d ay = _mm_cvtepi32_pd(_mm_srli_si128(a, 8));
+		__m128d bx = _mm_cvtepi32_pd(b);
+		__m128d by = _mm_cvtepi32_pd(_mm_srli_si128(b, 8));
+
+		__m128d up = _mm_cmplt_pd(ay, by);
+		__m128d sx = selectSse2(up, ax, bx);
+		__m128d sy = selectSse2(up, ay, by);
+		__m128d ex = selectSse2(up, bx, ax);
+		__m128d ey = selectSse2(up, by, ay);
+		int inRange = _mm_movemask_pd(_mm_and_pd(
+			_mm_cmpge_pd(py, sy), _mm_cmple_pd(py, ey)));
+		if (inRange == 0) continue;
+
+		__m128d ccw = crossProductSse2(sx, sy, ex, ey, px, py);
+		int collinear = _mm_movemask_pd(_mm_cmpeq_pd(ccw, zero)) & inRange;
+		int positive = _mm_movemask_pd(_mm_cmpgt_pd(ccw, zero)) & inRange;
+		int atVertex = _mm_movemask_pd(_mm_or_pd(
+			_mm_cmpeq_pd(py, sy), _mm_cmpeq_pd(py, ey)));
+		crossings += 2 * std::popcount(static_cast<unsigned>(positive & ~atVertex)) +
+			std::popcount(static_cast<unsigned>(positive & atVertex));
+		for (int lane = 0; lane < 2; lane++)
+		{
+			if ((collinear & (1 << lane)) &&
+				countSegmentCrossing(coords[i + lane], coords[i + lane + 1], pt, crossings))
+			{
+				return true;
+			}
+		}
+	}
+	for (i++; i < count; i++)
+	{
+		if (countSegmentCrossing(coords[i - 1], coords[i], pt, crossings)) return true;
+	}
+	return false;
+}
+
+
+static bool anyIntersectSse2(const ChainKernels::SegmentPairs& pairs)
+{
+	const __m128d zero = _mm_setzero_pd();
+	int i = 0;
+	for (; i + 2 <= pairs.count; i += 2)
+	{
+		#define GEODESK_LOAD2(arr) _mm_cvtepi32_pd(_mm_loadl_epi64( \
+			reinterpret_cast<const __m128i*>(pairs.arr + i)))
+		__m128d x1 = GEODESK_LOAD2(x1);
+		__m128d y1 = GEODESK_LOAD2(y1);
+		__m128d x2 = GEODESK_LOAD2(x2);
+		__m128d y2 = GEODESK_LOAD2(y2);
+		__m128d x3 = GEODESK_LOAD2(x3);
+		__m128d y3 = GEODESK_LOAD2(y3);
+		__m128d x4 = GEODESK_LOAD2(x4);
+		__m128d y4 = GEODESK_LOAD2(y4);
+		#undef GEODESK_LOAD2
+
+		__m128d o1 = crossProductSse2(x1, y1, x2, y2, x3, y3);
+		__m128d o2 = crossProductSse2(x1, y1, x2, y2, x4, y4);
+		__m128d o3 = crossProductSse2(x3, y3, x4, y4, x1, y1);
+		__m128d o4 = crossProductSse2(x3, y3, x4, y4, x2, y2);
+		int collinear = _mm_movemask_pd(_mm_or_pd(
+			_mm_or_pd(_mm_cmpeq_pd(o1, zero), _mm_cmpeq_pd(o2, zero)),
+			_mm_or_pd(_mm_cmpeq_pd(o3, zero), _mm_cmpeq_pd(o4, zero))));
+		int crosses = _mm_movemask_pd(_mm_and_pd(
+			_mm_xor_pd(_mm_cmpgt_pd(o1, zero), _mm_cmpgt_pd(o2, zero)),
+			_mm_xor_pd(_mm_cmpgt_pd(o3, zero), _mm_cmpgt_pd(o4, zero))));
+		if (crosses & ~collinear) return true;
+		for (int lane = 0; lane < 2; lane++)
+		{
+			if ((collinear & (1 << lane)) && pairIntersects(pairs, i + lane)) return true;
+		}
+	}
+	for (; i < pairs.count; i++)
+	{
+		if (pairIntersects(pairs, i)) return true;
+	}
+	return false;
+}
+
+// ==================================================================
+//  AVX2 (4 segments at a time)
+// ==================================================================
+
+GEODESK_TARGET_AVX2
+static inline __m256d crossProductAvx2(__m256d x1, __m256d y1,
+	__m256d x2, __m256d y2, __m256d px, __m256d py)
+{
+	x2 = _mm256_sub_pd(x2, x1);
+	y2 = _mm256_sub_pd(y2, y1);
+	px = _mm256_sub_pd(px, x1);
+	py = _mm256_sub_pd(py, y1);
+	return _mm256_sub_pd(_mm256_mul_pd(px, y2), _mm256_mul_pd(py, x2));
+}
+
+
+GEODESK_TARGET_AVX2
+static bool countCrossingsAvx2(const Coordinate* coords, size_t count,
+	Coordinate pt, uint32_t& crossings)
+{
+	if (count < 2) return false;
+	size_t segmentCount = count - 1;
+	const __m256d px = _mm256_set1_pd(pt.x);
+	const __m256d py = _mm256_set1_pd(pt.y);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	size_t i = 0;
+	for (; i + 4 <= segmentCount; i += 4)
+	{
+		__m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>(coords + i)), deinterleave);
+		__m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>(coords + i + 1)), deinterleave);
+		__m256d ax = _mm256_cvtepi32_pd(_mm256_castsi256_si128(a));
+		__m256d ay = _mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1));
+		__m256d bx = _mm256_cvtepi32_pd(_mm256_castsi256_si128(b));
+		__m256d by = _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1));
+
+		__m256d up = _mm256_cmp_pd(ay, by, _CMP_LT_OQ);
+		__m256d sx = _mm256_blendv_pd(bx, ax, up);
+		__m256d sy = _mm256_blendv_pd(by, ay, up);
+		__m256d ex = _mm256_blendv_pd(ax, bx, up);
+		__m256d ey = _mm256_blendv_pd(ay, by, up);
+		int inRange = _mm256_movemask_pd(_mm256_and_pd(
+			_mm256_cmp_pd(py, sy, _CMP_GE_OQ), _mm256_cmp_pd(py, ey, _CMP_LE_OQ)));
+		if (inRange == 0) continue;
+
+		__m256d ccw = crossProductAvx2(sx, sy, ex, ey, px, py);
+		int collinear = _mm256_movemask_pd(_mm256_cmp_pd(ccw, zero, _CMP_EQ_OQ)) & inRange;
+		int positive = _mm256_movemask_pd(_mm256_cmp_pd(ccw, zero, _CMP_GT_OQ)) & inRange;
+		int atVertex = _mm256_movemask_pd(_mm256_or_pd(
+			_mm256_cmp_pd(py, sy, _CMP_EQ_OQ), _mm256_cmp_pd(py, ey, _CMP_EQ_OQ)));
+		crossings += 2 * std::popcount(static_cast<unsigned>(positive & ~atVertex)) +
+			std::popcount(static_cast<unsigned>(positive & atVertex));
+		while (collinear)
+		{
+			int lane = std::countr_zero(static_cast<unsigned>(collinear));
+			if (countSegmentCrossing(coords[i + lane], coords[i + lane + 1], pt, crossings))
+			{
+				return true;
+			}
+			collinear &= collinear - 1;
+		}
+	}
+	for (i++; i < count; i++)
+	{
+		if (countSegmentCrossing(coords[i - 1], coords[i], pt, crossings)) return true;
+	}
+	return false;
+}
+
+
+GEODESK_TARGET_AVX2
+static bool anyIntersectAvx2(const ChainKernels::SegmentPairs& pairs)
+{
+	const __m256d zero = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 4 <= pairs.count; i += 4)
+	{
+		#define GEODESK_LOAD4(arr) _mm256_cvtepi32_pd(_mm_loadu_si128( \
+			reinterpret_cast<const __m128i*>(pairs.arr + i)))
+		__m256d x1 = GEODESK_LOAD4(x1);
+		__m256d y1 = GEODESK_LOAD4(y1);
+		__m256d x2 = GEODESK_LOAD4(x2);
+		__m256d y2 = GEODESK_LOAD4(y2);
+		__m256d x3 = GEODESK_LOAD4(x3);
+		__m256d y3 = GEODESK_LOAD4(y3);
+		__m256d x4 = GEODESK_LOAD4(x4);
+		__m256d y4 = GEODESK_LOAD4(y4);
+		#undef GEODESK_LOAD4
+
+		__m256d o1 = crossProductAvx2(x1, y1, x2, y2, x3, y3);
+		__m256d o2 = crossProductAvx2(x1, y1, x2, y2, x4, y4);
+		__m256d o3 = crossProductAvx2(x3, y3, x4, y4, x1, y1);
+		__m256d o4 = crossProductAvx2(x3, y3, x4, y4, x2, y2);
+		int collinear = _mm256_movemask_pd(_mm256_or_pd(
+			_mm256_or_pd(_mm256_cmp_pd(o1, zero, _CMP_EQ_OQ), _mm256_cmp_pd(o2, zero, _CMP_EQ_OQ)),
+			_mm256_or_pd(_mm256_cmp_pd(o3, zero, _CMP_EQ_OQ), _mm256_cmp_pd(o4, zero, _CMP_EQ_OQ))));
+		int crosses = _mm256_movemask_pd(_mm256_and_pd(
+			_mm256_xor_pd(_mm256_cmp_pd(o1, zero, _CMP_GT_OQ), _mm256_cmp_pd(o2, zero, _CMP_GT_OQ)),
+			_mm256_xor_pd(_mm256_cmp_pd(o3, zero, _CMP_GT_OQ), _mm256_cmp_pd(o4, zero, _CMP_GT_OQ))));
+		if (crosses & ~collinear) return true;
+		while (collinear)
+		{
+			int lane = std::countr_zero(static_cast<unsigned>(collinear));
+			if (pairIntersects(pairs, i + lane)) return true;
+			collinear &= collinear - 1;
+		}
+	}
+	for (; i < pairs.count; i++)
+	{
+		if (pairIntersects(pairs, i)) return true;
+	}
+	return false;
+}
+
+#endif // GEODESK_CHAIN_KERNELS_X86
+
+// ==================================================================
+//  Dispatch
+// ==================================================================
+
+ChainKernels::Dispatch& ChainKernels::dispatch()
+{
+	static Dispatch dispatch = []()
+	{
+		Dispatch d{ countCrossingsScalar, anyIntersectScalar, Implementation::SCALAR };
+		#ifdef GEODESK_CHAIN_KERNELS_X86
+		if (clarisma::CpuFeatures::hasAvx2())
+		{
+			d = { countCrossingsAvx2, anyIntersectAvx2, Implementation::AVX2 };
+		}
+		else
+		{
+			d = { countCrossingsSse2, anyIntersectSse2, Implementation::SSE2 };
+		}
+		#endif
+		return d;
+	}();
+	return dispatch;
+}
+
+
+bool ChainKernels::select(Implementation impl)
+{
+	Dispatch& d = dispatch();
+	switch (impl)
+	{
+	case Implementation::SCALAR:
+		d = { countCrossingsScalar, anyIntersectScalar, impl };
+		return true;
+	#ifdef GEODESK_CHAIN_KERNELS_X86
+	case Implementation::SSE2:
+		d = { countCrossingsSse2, anyIntersectSse2, impl };
+		return true;
+	case Implementation::AVX2:
+		if (!clarisma::CpuFeatures::hasAvx2()) return false;
+		d = { countCrossingsAvx2, anyIntersectAvx2, impl };
+		return true;
+	#endif
+	default:
+		return false;
+	}
+}
+
+
+const char* ChainKernels::implementationName()
+{
+	switch (implementation())
+	{
+	case Implementation::SSE2: return "SSE2";
+	case Implementation::AVX2: return "AVX2";
+	default: return "scalar";
+	}
+}
+
+} // namespace geodesk
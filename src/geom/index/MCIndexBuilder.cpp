@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/geom/index/MCIndexBuilder.h>
+#include <algorithm>
+#include <thread>
+#include <clarisma/thread/Threads.h>
 #include <geodesk/geom/index/WaySlicer.h>
 #include <geodesk/geom/index/CoordSequenceSlicer.h>
 #include <geodesk/feature/FeatureStore.h>
@@ -17,11 +20,22 @@ MCIndexBuilder::MCIndexBuilder() :
 	chainCount_(0),
 	totalChainSize_(0),
 	first_(nullptr),
+	last_(nullptr),
 	arena_(16 * 1024, Arena::GrowthPolicy::DOUBLE)
 {
 }
 
 
+void MCIndexBuilder::addChain(MCHolder* holder)
+{
+	holder->next = first_;
+	first_ = holder;
+	if (!last_) last_ = holder;
+	chainCount_++;
+	totalChainSize_ += holder->chain.storageSize();
+}
+
+
 void MCIndexBuilder::segmentizeWay(WayPtr way)
 {
 	WaySlicer slicer(way);
@@ -33,16 +47,84 @@ void MCIndexBuilder::segmentizeWay(WayPtr way)
 		// Give back the unused space to the Arena
 		int unusedVertexes = MAX_VERTEX_COUNT - holder->chain.vertexCount();
 		arena_.reduceLastAlloc(unusedVertexes * sizeof(Coordinate));
-		holder->next = first_;
-		first_ = holder;
-		chainCount_++;
-		totalChainSize_ += holder->chain.storageSize();
+		addChain(holder);
 	}
 	while (slicer.hasMore());
 }
 
+
+/**
+ * Segmentizes the given ways. If they have enough vertexes (as is
+ * typical for the boundaries of large areas), the ways are split into
+ * contiguous ranges of roughly equal vertex counts, which are sliced
+ * in parallel by separate builders. Their chains are then linked into
+ * this builder's list in member order, so the result is the same as
+ * if the ways had been segmentized one by one.
+ *
+ * The threshold is high enough that indexes built on worker threads
+ * (e.g. by PointLocator) rarely fan out any further.
+ */
+void MCIndexBuilder::segmentizeWays(const std::vector<WayPtr>& ways)
+{
+	std::vector<size_t> vertexCounts;
+	vertexCounts.reserve(ways.size());
+	size_t totalVertexCount = 0;
+	for (WayPtr way : ways)
+	{
+		WayCoordinateIterator iter(way);
+		totalVertexCount += iter.storedCoordinatesRemaining();
+		vertexCounts.push_back(totalVertexCount);
+	}
+
+	size_t threadCount = totalVertexCount < MIN_PARALLEL_VERTEXES ? 1 :
+		std::min<size_t>(std::thread::hardware_concurrency(), ways.size());
+	if (threadCount < 2)
+	{
+		for (WayPtr way : ways) segmentizeWay(way);
+		return;
+	}
+
+	// Each range ends with the first way at which the running count
+	// of vertexes reaches its share of the total
+	std::vector<size_t> ends(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		size_t share = totalVertexCount * (i + 1) / threadCount;
+		ends[i] = std::lower_bound(vertexCounts.begin(), vertexCounts.end(),
+			share) - vertexCounts.begin() + 1;
+	}
+	ends[threadCount - 1] = ways.size();
+
+	size_t firstPart = parts_.size();
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		parts_.emplace_back(new MCIndexBuilder());
+	}
+	Threads::runInParallel(threadCount, [this, &ways, &ends, firstPart](size_t i)
+	{
+		MCIndexBuilder* part = parts_[firstPart + i].get();
+		size_t start = i == 0 ? 0 : ends[i - 1];
+		for (size_t n = start; n < ends[i]; n++) part->segmentizeWay(ways[n]);
+	});
+
+	// Chains are prepended, so each part's list runs backwards;
+	// prepending the parts in order keeps the sequential order
+	for (size_t i = firstPart; i < parts_.size(); i++)
+	{
+		MCIndexBuilder* part = parts_[i].get();
+		if (part->chainCount_ == 0) continue;
+		part->last_->next = first_;
+		first_ = part->first_;
+		if (!last_) last_ = part->last_;
+		chainCount_ += part->chainCount_;
+		totalChainSize_ += part->totalChainSize_;
+	}
+}
+
+
 void MCIndexBuilder::segmentizeAreaRelation(FeatureStore* store, RelationPtr rel)
 {
+	std::vector<WayPtr> ways;
 	FastMemberIterator iter(store, rel);
 	for (;;)
 	{
@@ -51,9 +133,10 @@ void MCIndexBuilder::segmentizeAreaRelation(FeatureStore* store, RelationPtr rel
 		if (member.isWay())
 		{
 			WayPtr way(member);
-			if(!way.isPlaceholder()) segmentizeWay(way);
+			if(!way.isPlaceholder()) ways.push_back(way);
 		}
 	}
+	segmentizeWays(ways);
 
 	// If no ways were extracted, attempt to extract any features
 	// (i.e. treat like non-area relation)
@@ -64,12 +147,21 @@ void MCIndexBuilder::segmentizeAreaRelation(FeatureStore* store, RelationPtr rel
 		segmentizeMembers(store, rel, guard);
 	}
 
-	// TODO: We still need to ensure there is at least one chain;
-	// chainCount_ could be 0 if relation only consists of nodes
+	// chainCount_ is still 0 if the relation only consists of nodes;
+	// callers must check isEmpty() before calling build()
 }
 
 
 void MCIndexBuilder::segmentizeMembers(FeatureStore* store, RelationPtr rel, RecursionGuard& guard)
+{
+	std::vector<WayPtr> ways;
+	collectMemberWays(store, rel, guard, ways);
+	segmentizeWays(ways);
+}
+
+
+void MCIndexBuilder::collectMemberWays(FeatureStore* store, RelationPtr rel,
+	RecursionGuard& guard, std::vector<WayPtr>& ways)
 {
 	FastMemberIterator iter(store, rel);
 	for (;;)
@@ -81,18 +173,18 @@ void MCIndexBuilder::segmentizeMembers(FeatureStore* store, RelationPtr rel, Rec
 		{
 			WayPtr memberWay(member);
 			if (memberWay.isPlaceholder()) continue;
-			segmentizeWay(memberWay);
+			ways.push_back(memberWay);
 		}
 		else if(memberType == 2)
 		{
 			RelationPtr childRel(member);
 			if (childRel.isPlaceholder() || !guard.checkAndAdd(childRel)) continue;
-			segmentizeMembers(store, childRel, guard);
+			collectMemberWays(store, childRel, guard, ways);
 		}
 	}
 }
 
-// TODO: must be able to deal with empty areas (i.e. chainCount_ == 0)
+// Must not be called for an empty builder (see isEmpty())
 MCIndex MCIndexBuilder::build(Box bounds)
 {
 	assert(chainCount_ > 0);
@@ -133,10 +225,7 @@ void MCIndexBuilder::segmentizeCoords(GEOSContextHandle_t context, const GEOSCoo
 		// Give back the unused space to the Arena
 		int unusedVertexes = MAX_VERTEX_COUNT - holder->chain.vertexCount();
 		arena_.reduceLastAlloc(unusedVertexes * sizeof(Coordinate));
-		holder->next = first_;
-		first_ = holder;
-		chainCount_++;
-		totalChainSize_ += holder->chain.storageSize();
+		addChain(holder);
 	}
 	while (slicer.hasMore());
 }
@@ -166,10 +255,7 @@ void MCIndexBuilder::addLineSegment(Coordinate start, Coordinate end)
 	MCHolder* holder = arena_.allocWithExplicitSize<MCHolder>(
 		MCHolder::storageSize(2));
 	holder->chain.initLineSegment(start, end);
-	holder->next = first_;
-	first_ = holder;
-	chainCount_++;
-	totalChainSize_ += holder->chain.storageSize();
+	addChain(holder);
 }
 
 } // namespace geodesk
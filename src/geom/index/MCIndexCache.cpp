@@ -0,0 +1,86 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/index/MCIndexCache.h>
+#include <cassert>
+
+namespace geodesk {
+
+SharedMCIndex MCIndexCache::get(uint64_t typedId)
+{
+	if (!isEnabled()) return {};
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = map_.find(typedId);
+	if (it == map_.end()) return {};
+	entries_.splice(entries_.begin(), entries_, it->second);
+	return it->second->index;
+}
+
+
+void MCIndexCache::put(uint64_t typedId, SharedMCIndex index, size_t size)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = map_.find(typedId);
+	if (it != map_.end())
+	{
+		totalBytes_ -= it->second->size;
+		entries_.erase(it->second);
+		map_.erase(it);
+	}
+	if (size > maxBytes_) return;
+	entries_.push_front({ typedId, std::move(index), size, {} });
+	map_[typedId] = entries_.begin();
+	totalBytes_ += size;
+	evict();
+}
+
+
+SharedTileClassifier MCIndexCache::tileClassifier(uint64_t typedId,
+	const MCIndex* index, TileClassifier::Mode mode, const Box& bounds)
+{
+	assert(mode != TileClassifier::Mode::CORRIDOR);
+	if (isEnabled())
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = map_.find(typedId);
+		if (it != map_.end() && it->second->index.get() == index)
+		{
+			SharedTileClassifier& classifier =
+				it->second->classifiers[static_cast<int>(mode)];
+			if (!classifier) classifier = std::make_shared<const TileClassifier>(mode, bounds);
+			return classifier;
+		}
+	}
+	return std::make_shared<const TileClassifier>(mode, bounds);
+}
+
+
+void MCIndexCache::setMaxBytes(size_t maxBytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	maxBytes_ = maxBytes;
+	evict();
+}
+
+
+void MCIndexCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_.clear();
+	map_.clear();
+	totalBytes_ = 0;
+}
+
+
+void MCIndexCache::evict()
+{
+	while (totalBytes_ > maxBytes_)
+	{
+		const Entry& last = entries_.back();
+		totalBytes_ -= last.size;
+		map_.erase(last.typedId);
+		entries_.pop_back();
+	}
+}
+
+} // namespace geodesk
@@ -4,6 +4,7 @@
 #include <geodesk/geom/index/MonotoneChain.h>
 #include <algorithm>
 #include <geodesk/geom/LineSegment.h>
+#include <geodesk/geom/index/ChainKernels.h>
 
 namespace geodesk {
 
@@ -104,23 +105,28 @@ bool MonotoneChain::intersects(const MonotoneChain* other) const
 	Coordinate start2 = *p2++;
 	Coordinate end2 = *p2++;
 
+	// Rather than testing each pair of segments as we walk the chains,
+	// we collect them into batches for the vectorized kernel
+
+	ChainKernels::SegmentPairs pairs;
 	for (;;)
 	{
-		// check for line segment intersection
-		if (LineSegment::linesIntersect(start1, end1, start2, end2))
+		pairs.add(start1, end1, start2, end2);
+		if (pairs.isFull())
 		{
-			return true;
+			if (ChainKernels::anyIntersect(pairs)) return true;
+			pairs.count = 0;
 		}
 
 		if (end1.y < end2.y)
 		{
-			if (p1 == pEnd1) return false;
+			if (p1 == pEnd1) break;
 			start1 = end1;
 			end1 = *p1++;
 		}
 		else
 		{
-			if (p2 == pEnd2) return false;
+			if (p2 == pEnd2) break;
 			start2 = end2;
 			end2 = *p2++;
 		}
@@ -128,6 +134,7 @@ bool MonotoneChain::intersects(const MonotoneChain* other) const
 		// Right now, we arbitrarily move one pointer or the other, could this
 		// impact robustness?
 	}
+	return ChainKernels::anyIntersect(pairs);
 }
 
 
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/index/TileClassifier.h>
+
+namespace geodesk {
+
+int TileClassifier::locate(const MCIndex& index, Tile tile) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	int32_t parent = -1;		// node holding the entry (-1 = root)
+	int quadrant = 0;
+	int32_t entry = root_;
+	int zoom = tile.zoom();
+	for (int z = 0; z < zoom; z++)
+	{
+		if (entry == PARTIAL)
+		{
+			int shift = zoom - z;
+			entry = subdivide(index, Tile::fromColumnRowZoom(
+				tile.column() >> shift, tile.row() >> shift, z));
+			if (parent < 0)
+			{
+				root_ = entry;
+			}
+			else
+			{
+				nodes_[parent][quadrant] = entry;
+			}
+		}
+		if (entry < FIRST_NODE) return entry;
+		parent = entry - FIRST_NODE;
+		int shift = zoom - z - 1;
+		quadrant = ((tile.column() >> shift) & 1) |
+			(((tile.row() >> shift) & 1) << 1);
+		entry = nodes_[parent][quadrant];
+	}
+	return entry < PARTIAL ? entry : 0;
+}
+
+
+/**
+ * Classifies the four children of the given boundary tile, and
+ * returns the entry of the node that holds them.
+ */
+int32_t TileClassifier::subdivide(const MCIndex& index, Tile tile) const
+{
+	std::array<int32_t,4> children;
+	int col = tile.column() << 1;
+	int row = tile.row() << 1;
+	int zoom = tile.zoom() + 1;
+	for (int quadrant = 0; quadrant < 4; quadrant++)
+	{
+		children[quadrant] = classify(index, Tile::fromColumnRowZoom(
+			col + (quadrant & 1), row + (quadrant >> 1), zoom));
+	}
+	nodes_.push_back(children);
+	return static_cast<int32_t>(nodes_.size() - 1) + FIRST_NODE;
+}
+
+
+int32_t TileClassifier::classify(const MCIndex& index, Tile tile) const
+{
+	Box bounds = tile.bounds();
+	if (!bounds.intersects(bounds_)) return -1;
+
+	int loc;
+	switch (mode_)
+	{
+	case Mode::AREA:
+		loc = index.locateBox(bounds);
+		break;
+	case Mode::LINEAL:
+		loc = index.intersectsBoxBoundary(bounds) ? 0 : -1;
+		break;
+	default:
+		if (corridorIsArea_ && index.locateBox(bounds) == 1)
+		{
+			loc = 1;
+			break;
+		}
+		bounds.bufferSimple(corridorDistance_);
+		loc = index.intersectsBoxBoundary(bounds) ? 0 : -1;
+		break;
+	}
+	if (loc != 0 || tile.zoom() == MAX_ZOOM) return loc;
+	return PARTIAL;
+}
+
+} // namespace geodesk
@@ -6,21 +6,33 @@
 #include "RingBuilder.h"
 #include "RingAssigner.h"
 #include "RingMerger.h"
+#include "RingValidator.h"
 #include "Segment.h"
 #include <geodesk/feature/FeatureStore.h>
 #include <geodesk/feature/MemberIterator.h>
+#include <geodesk/geom/Simplifier.h>
+#include <geodesk/geom/geos/GeosContext.h>
+#include <clarisma/thread/Threads.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 namespace geodesk {
 
 Polygonizer::Polygonizer() :
 	outerRings_(nullptr),
-	innerRings_(nullptr)
+	innerRings_(nullptr),
+	invalidCount_(0)
 {
 }
 
 
 // TODO: Use a separate path for areas (which be definition don't require assembling)?
 // This way, no need to test for flag
+/**
+ * Allocates a Segment for the given way, but does not yet decode its
+ * coordinates (see decodeSegments()).
+ */
 Polygonizer::Segment* Polygonizer::createSegment(WayPtr way, Segment* next)
 {
 	WayCoordinateIterator iter(way);
@@ -31,24 +43,80 @@ Polygonizer::Segment* Polygonizer::createSegment(WayPtr way, Segment* next)
 	seg->status = Segment::SEGMENT_UNASSIGNED;
 	seg->backward = false;
 	seg->vertexCount = vertexCount;
-	Coordinate* p = seg->coords;
-    Coordinate* end = p + vertexCount;
-	do
-	{
-		*p++ = iter.next();
-	} 
-	while (p < end);
 	return seg;
 }
 
 
-void Polygonizer::createRings(FeatureStore* store, RelationPtr relation)
+void Polygonizer::decodeSegment(Segment* seg, const Simplifier* simplifier)
+{
+	WayCoordinateIterator iter(seg->way);
+	int count = iter.nextBatch(seg->coords, seg->vertexCount);
+	assert(count == seg->vertexCount);
+	if (simplifier)
+	{
+		seg->vertexCount = static_cast<uint16_t>(
+			simplifier->simplifyWay(seg->coords, count));
+	}
+}
+
+
+/**
+ * Decodes the coordinates of all segments. For relations with many
+ * vertexes, the segments are decoded in parallel (each thread takes
+ * every n-th segment); since the segments have already been allocated,
+ * the threads don't touch the arena. Simplification (if any) happens
+ * as each segment is decoded.
+ */
+void Polygonizer::decodeSegments(Segment* outerSegments, Segment* innerSegments,
+    const Simplifier* simplifier)
+{
+    std::vector<Segment*> segments;
+    size_t vertexCount = 0;
+    for (Segment* list : { outerSegments, innerSegments })
+    {
+        for (Segment* seg = list; seg; seg = seg->next)
+        {
+            segments.push_back(seg);
+            vertexCount += seg->vertexCount;
+        }
+    }
+
+    int threadCount = vertexCount < MIN_PARALLEL_VERTEXES ? 1 :
+        std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+            static_cast<int>(segments.size())));
+    if (threadCount == 1)
+    {
+        for (Segment* seg : segments) decodeSegment(seg, simplifier);
+        return;
+    }
+
+    clarisma::Threads::runInParallel(threadCount,
+        [&segments, threadCount, simplifier](size_t start)
+    {
+        for (size_t i = start; i < segments.size(); i += threadCount)
+        {
+            decodeSegment(segments[i], simplifier);
+        }
+    });
+}
+
+
+void Polygonizer::createRings(FeatureStore* store, RelationPtr relation,
+    const Simplifier* simplifier)
 {
     Segment* outerSegments = nullptr;
     Segment* innerSegments = nullptr;
     int outerSegmentCount = 0;
     int innerSegmentCount = 0;
 
+    // "inner" and "outer" are not guaranteed to be global strings (they
+    // may fall below the minimum count in very small datasets), so we
+    // look up their codes (-1 if they are local) and only fall back to
+    // comparing strings for roles that are themselves local strings
+    const StringTable& strings = store->strings();
+    int outerCode = strings.getCode("outer", 5);
+    int innerCode = strings.getCode("inner", 5);
+
     DataPtr pMembers = relation.bodyptr();
     // TODO: empty relations?
     // TODO: deal with missing tiles
@@ -71,24 +139,33 @@ void Polygonizer::createRings(FeatureStore* store, RelationPtr relation)
         }
         */
 
-        // TODO: Use more efficient check for inner/outer role
-        // based on global string code; however, this would require
-        // change to the GOL spec to ensure that "inner" and "outer"
-        // are always global strings (may not be the case for very small
-        // datasets where their string count falls below the minimum)
+        bool isOuter;
+        bool isInner;
+        int roleCode = iter.currentRoleCode();
+        if (roleCode >= 0)
+        {
+            isOuter = roleCode == outerCode;
+            isInner = roleCode == innerCode;
+        }
+        else
+        {
+            std::string_view role = iter.currentRole();
+            isOuter = role == "outer";
+            isInner = role == "inner";
+        }
 
-        std::string_view role = iter.currentRole();
-        if (role == "outer")
+        if (isOuter)
         {
             outerSegments = createSegment(way, outerSegments);
             outerSegmentCount++;
         }
-        else if (role == "inner")
+        else if (isInner)
         {
             innerSegments = createSegment(way, innerSegments);
             innerSegmentCount++;
         }
     }
+    decodeSegments(outerSegments, innerSegments, simplifier);
     if (outerSegmentCount > 0)
     {
         outerRings_ = buildRings(outerSegmentCount, outerSegments);
@@ -100,6 +177,21 @@ void Polygonizer::createRings(FeatureStore* store, RelationPtr relation)
 }
 
 
+void Polygonizer::addRing(const Coordinate* coords, int count, bool isOuter)
+{
+    assert(count > 0 && count <= UINT16_MAX);
+    Segment* seg = arena_.allocWithExplicitSize<Segment>(Segment::sizeWithVertexCount(count));
+    seg->next = nullptr;
+    seg->way = WayPtr(FeaturePtr(nullptr));
+    seg->status = Segment::SEGMENT_ASSIGNED;
+    seg->backward = false;
+    seg->vertexCount = static_cast<uint16_t>(count);
+    std::copy(coords, coords + count, seg->coords);
+    Ring*& rings = isOuter ? outerRings_ : innerRings_;
+    rings = createRing(count, seg, rings, arena_);
+}
+
+
 Polygonizer::Ring* Polygonizer::buildRings(int segmentCount, Segment* firstSegment)
 {
     assert(segmentCount > 0);
@@ -158,9 +250,50 @@ void Polygonizer::assignAndMergeHoles()
     while (ring);
 }
 
+int Polygonizer::validate()
+{
+    // Scratch memory for the copied coordinates and monotone chains
+    clarisma::Arena arena(64 * 1024);
+    RingValidator validator(arena);
+    invalidCount_ = 0;
+    for (Ring* ring = outerRings_; ring; ring = ring->next())
+    {
+        if (!validator.validatePolygon(ring, true)) invalidCount_++;
+    }
+    for (Ring* ring = innerRings_; ring; ring = ring->next())
+    {
+        if (!validator.validatePolygon(ring, false)) invalidCount_++;
+    }
+    return invalidCount_;
+}
+
 #ifdef GEODESK_WITH_GEOS
-GEOSGeometry* Polygonizer::createPolygonal(GEOSContextHandle_t context) 
+GEOSGeometry* Polygonizer::createPolygonal(GEOSContextHandle_t context) const
+{
+    GEOSGeometry* geom = buildPolygonal(context);
+    if (invalidCount_ == 0) return geom;
+
+    // Only geometries that failed validate() are handed to GEOS
+    // for repair (MakeValid is far more expensive than our checks).
+    // GEOS versions before 3.8 lack MakeValid; a zero-width buffer
+    // is the traditional fallback (it resolves self-intersections,
+    // but may drop the parts of a "bow-tie" with reversed orientation)
+    #if GEOS_VERSION_MAJOR > 3 || (GEOS_VERSION_MAJOR == 3 && GEOS_VERSION_MINOR >= 8)
+    GEOSGeometry* repaired = GEOSMakeValid_r(context, geom);
+    #else
+    GEOSGeometry* repaired = GEOSBuffer_r(context, geom, 0, 8);
+    #endif
+    if (!repaired) return geom;
+    GEOSGeom_destroy_r(context, geom);
+    return repaired;
+}
+
+
+GEOSGeometry* Polygonizer::buildPolygonal(GEOSContextHandle_t context) const
 {
+    // The rings may be shared via the RingCache, so we use our own
+    // arena for the temporary arrays instead of the Polygonizer's
+    clarisma::Arena arena;
     if (outerRings_ == nullptr)
     {
         return GEOSGeom_createEmptyPolygon();
@@ -175,15 +308,61 @@ GEOSGeometry* Polygonizer::createPolygonal(GEOSContextHandle_t context)
     }
     while (ring);
 
-    if(ringCount == 1) return outerRings_->createPolygon(context, arena_);
+    if(ringCount == 1) return outerRings_->createPolygon(context, arena);
     
-    GEOSGeometry** polygons = arena_.allocArray<GEOSGeometry*>(ringCount);
+    GEOSGeometry** polygons = arena.allocArray<GEOSGeometry*>(ringCount);
+    std::fill_n(polygons, ringCount, nullptr);
     ring = outerRings_;
+    size_t vertexCount = 0;
     for (int i = 0; i < ringCount; i++)
     {
-        polygons[i] = ring->createPolygon(context, arena_);
+        vertexCount += ring->vertexCount();
         ring = ring->next();
     }
+    int threadCount = vertexCount < MIN_PARALLEL_VERTEXES ? 1 :
+        std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+            ringCount));
+    // If building any polygon fails, we destroy the ones that were
+    // built and rethrow the exception
+    try
+    {
+        if (threadCount == 1)
+        {
+            ring = outerRings_;
+            for (int i = 0; i < ringCount; i++)
+            {
+                polygons[i] = ring->createPolygon(context, arena);
+                ring = ring->next();
+            }
+        }
+        else
+        {
+            // Build the polygons of large multipolygons in parallel; each
+            // thread takes every n-th outer ring and uses its own GEOS
+            // context and its own arena for the arrays of holes
+            std::vector<Ring*> rings;
+            rings.reserve(ringCount);
+            for (ring = outerRings_; ring; ring = ring->next()) rings.push_back(ring);
+            clarisma::Threads::runInParallel(threadCount,
+                [&rings, polygons, threadCount](size_t part)
+            {
+                GeosContext threadContext;
+                clarisma::Arena arena;
+                for (size_t i = part; i < rings.size(); i += threadCount)
+                {
+                    polygons[i] = rings[i]->createPolygon(threadContext.handle(), arena);
+                }
+            });
+        }
+    }
+    catch (...)
+    {
+        for (int i = 0; i < ringCount; i++)
+        {
+            if (polygons[i]) GEOSGeom_destroy_r(context, polygons[i]);
+        }
+        throw;
+    }
     return GEOSGeom_createCollection_r(context, GEOS_MULTIPOLYGON, polygons, ringCount);
 }
 #endif
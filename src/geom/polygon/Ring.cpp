@@ -4,29 +4,30 @@
 #include "Ring.h"
 #include <geodesk/geom/polygon/PointInPolygon.h>
 #include "Segment.h"
+#ifdef GEODESK_WITH_GEOS
+#include <geodesk/geom/GeometryBuilder.h>
+#endif
 
 namespace geodesk {
 
 #ifdef GEODESK_WITH_GEOS
 GEOSCoordSequence* Polygonizer::Ring::createCoordSequence(GEOSContextHandle_t context)
 {
-    GEOSCoordSequence* coordSeq = GEOSCoordSeq_create_r(context, vertexCount_, 2);
-    if (coordSeq)
+    // Assemble the coordinates in a buffer, so the sequence can be
+    // created in a single call
+    std::vector<Coordinate>& coords = GeometryBuilder::coordinateBuffer();
+    coords.resize(vertexCount_);
+    Segment* seg = firstSegment_;
+    coords[0] = seg->backward ? seg->coords[seg->vertexCount - 1] : seg->coords[0];
+    Coordinate* p = coords.data() + 1;
+    do
     {
-        Segment* seg = firstSegment_;
-        Coordinate first = seg->backward ? seg->coords[seg->vertexCount - 1] : seg->coords[0];
-        GEOSCoordSeq_setXY_r(context, coordSeq, 0, first.x, first.y);
-        int pos = 1;
-        do
-        {
-            seg->copyTo(context, coordSeq, pos);
-            pos += seg->vertexCount - 1;
-            seg = seg->next;
-        }
-        while (seg);
-        assert(pos == vertexCount_);
+        p = seg->copyTo(p);
+        seg = seg->next;
     }
-    return coordSeq;
+    while (seg);
+    assert(p == coords.data() + vertexCount_);
+    return GeometryBuilder::buildCoordSequence(coords.data(), vertexCount_, context);
 }
 
 GEOSGeometry* Polygonizer::Ring::createLinearRing(GEOSContextHandle_t context)
@@ -74,6 +75,23 @@ void Polygonizer::Ring::calculateBounds()
 }
 
 
+void Polygonizer::Ring::reverse()
+{
+    Segment* prev = nullptr;
+    Segment* seg = firstSegment_;
+    do
+    {
+        Segment* next = seg->next;
+        seg->next = prev;
+        seg->backward = !seg->backward;
+        prev = seg;
+        seg = next;
+    }
+    while (seg);
+    firstSegment_ = prev;
+}
+
+
 PointInPolygon::Location Polygonizer::Ring::locateCoordinate(Coordinate c) const
 {
     PointInPolygon tester(c);
@@ -23,12 +23,20 @@ public:
         firstInner_(nullptr),
         next_(next),
         number_(next ? (next->number_ + 1) : 1),
-        vertexCount_(vertexCount) {}
+        vertexCount_(vertexCount),
+        valid_(true) {}
 
     int number() const { return number_; };
     int vertexCount() const { return vertexCount_; };
     Ring* next() const { return next_; }
     Ring* firstInner() const { return firstInner_; }
+
+    /**
+     * Returns false if Polygonizer::validate() found edges of this
+     * ring (or, for an outer ring, of any of its holes) that cross
+     * or overlap.
+     */
+    bool isValid() const { return valid_; }
     void calculateBounds();
     #ifdef GEODESK_WITH_GEOS
     GEOSCoordSequence* createCoordSequence(GEOSContextHandle_t context);
@@ -62,16 +70,41 @@ private:
         firstInner_ = inner;
     }
 
+    /**
+     * Reverses the orientation of this ring, by reversing the order
+     * of its segments and the direction in which each is traversed.
+     */
+    void reverse();
+
     Segment* firstSegment_;
     Ring* firstInner_;
     Ring* next_;
     int number_;
     int vertexCount_;
+    bool valid_;
     Box bounds_;
 
     friend class Polygonizer;
     friend class RingAssigner;
     friend class RingMerger;
     friend class RingCoordinateIterator;
+    friend class RingValidator;
 };
+template <typename F>
+void Polygonizer::forEachRing(F&& f) const
+{
+    for (const Ring* ring = outerRings_; ring; ring = ring->next())
+    {
+        f(ring, true);
+        for (const Ring* inner = ring->firstInner(); inner; inner = inner->next())
+        {
+            f(inner, false);
+        }
+    }
+    for (const Ring* ring = innerRings_; ring; ring = ring->next())
+    {
+        f(ring, false);
+    }
+}
+
 } // namespace geodesk
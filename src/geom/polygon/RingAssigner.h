@@ -4,6 +4,7 @@
 #pragma once
 
 #include <geodesk/geom/polygon/Polygonizer.h>
+#include <geodesk/geom/index/HilbertTreeBuilder.h>
 #include "Ring.h"
 
 namespace geodesk {
@@ -86,6 +87,12 @@ public:
         }
         std::swap(outerRings[0], outerRings[biggestRing]);
 
+        if (outerCount >= MIN_OUTERS_FOR_INDEX)
+        {
+            assignRingsIndexed(outerRings, outerCount, firstInner, arena);
+            return;
+        }
+
         // Calculate bboxes of all rings, except for the largest
 
         for (int i = 1; i < outerCount; i++)
@@ -106,6 +113,67 @@ public:
         while (inner);
     }
 
+private:
+    /**
+     * Multipolygons with at least this many outer rings have their
+     * candidate outers looked up via a spatial index instead of a
+     * linear scan.
+     */
+    static constexpr int MIN_OUTERS_FOR_INDEX = 16;
+
+    struct OuterQuery
+    {
+        const Ring* inner;
+        const Ring* biggest;
+        Ring* result;
+    };
+
+    static bool findOuter(const RTree<Ring>::Node* node, OuterQuery* query)
+    {
+        Ring* outer = node->item();
+        if (outer == query->biggest) return false;
+        if (!outer->containsBoundsOf(query->inner)) return false;
+        if (!outer->contains(query->inner)) return false;
+        query->result = outer;
+        return true;
+    }
+
+    /**
+     * Same as the linear assignment above, but uses an R-tree (built
+     * from the bounding boxes of the outer rings) to find candidates.
+     * For relations with thousands of outer rings (e.g. large forest
+     * or wetland multipolygons), this turns the assignment from
+     * quadratic into roughly O(n log n). As above, the biggest ring
+     * (the first in the array) is the default outer and is never
+     * tested.
+     */
+    static void assignRingsIndexed(Ring** outerRings, int outerCount,
+        Ring* firstInner, clarisma::Arena& arena)
+    {
+        BoundedItem* items = arena.allocArray<BoundedItem>(outerCount);
+        Box totalBounds;
+        for (int i = 0; i < outerCount; i++)
+        {
+            Ring* outer = outerRings[i];
+            outer->calculateBounds();
+            items[i] = { outer->bounds_, outer };
+            totalBounds.expandToIncludeSimple(outer->bounds_);
+        }
+        HilbertTreeBuilder builder(&arena);
+        RTree<Ring> index = builder.build<Ring>(items, outerCount, 8, totalBounds);
+
+        Ring* inner = firstInner;
+        do
+        {
+            inner->calculateBounds();
+            Ring* next = inner->next();
+            OuterQuery query{ inner, outerRings[0], outerRings[0] };
+            index.search(inner->bounds_, findOuter, &query);
+            query.result->addInner(inner);
+            inner = next;
+        }
+        while (inner);
+    }
 };
 
 
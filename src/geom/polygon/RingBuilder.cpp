@@ -33,9 +33,12 @@ Polygonizer::RingBuilder::RingBuilder(int segmentCount, Segment* firstSegment, A
     candidateCount_(0)
 {
     segments_ = arena.allocArray<Segment*>(segmentCount);
-    // tableSize_ = (((uint32_t)0xffff'ffff) >> Bits::numberOfLeadingZeros(segmentCount - 1)) + 1;
-    tableSize_ = (((uint32_t)0xffff'ffff) >> Bits::countLeadingZeros32(
-        (segmentCount - 1) | 1)) + 1;
+    // Each segment has two endpoints; we size the table so that it is
+    // at most half full (at least 2 slots)
+    int tableBits = 32 - Bits::countLeadingZeros32(
+        static_cast<uint32_t>(segmentCount * 2 - 1) | 1);
+    tableSize_ = 1u << tableBits;
+    tableShift_ = 64 - tableBits;
     assert(tableSize_ > 0);
 
     lookupTable_ = arena.allocArray<int>(tableSize_);
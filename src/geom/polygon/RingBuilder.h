@@ -20,9 +20,17 @@ private:
         int nextCandidate;
     };
 
+    /**
+     * Mixes both coordinates with a multiplicative (Fibonacci) hash and
+     * takes the top bits as the slot. Unlike XOR-ing x and y, this
+     * doesn't map coordinates with the same x ^ y (e.g. points on
+     * the same diagonal, or mirrored points) to the same slot.
+     */
     inline int slotOf(Coordinate c) const
     {
-        return (c.x ^ c.y) & (tableSize_ - 1);
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(c.x)) << 32) |
+            static_cast<uint32_t>(c.y);
+        return static_cast<int>((key * 0x9E37'79B9'7F4A'7C15ULL) >> tableShift_);
     }
 
     void addToTable(Coordinate c, int segmentNumber)
@@ -42,6 +50,7 @@ private:
     Candidate* candidates_;
     int* lookupTable_;
     uint32_t tableSize_;
+    int tableShift_;
     uint32_t candidateCount_;
 };
 
@@ -0,0 +1,122 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/geom/polygon/RingCache.h>
+#include <geodesk/feature/FeatureStore.h>
+#include "Ring.h"
+
+namespace geodesk {
+
+SharedPolygonizer RingCache::rings(FeatureStore* store, RelationPtr relation,
+	bool assignHoles)
+{
+	if (!isEnabled())
+	{
+		auto polygonizer = std::make_shared<Polygonizer>();
+		polygonizer->createRings(store, relation);
+		if (assignHoles) polygonizer->assignAndMergeHoles();
+		return polygonizer;
+	}
+
+	uint64_t id = relation.id();
+	SharedPolygonizer cached = get(id);
+	if (cached) return cached;
+
+	// We assemble the rings without holding the lock; if two threads
+	// miss the same relation at the same time, both do the work, and
+	// the second put() simply replaces the first entry. Since the
+	// rings are validated only once per miss, the cost of validate()
+	// is amortized over all the callers that share them
+	auto polygonizer = std::make_shared<Polygonizer>();
+	polygonizer->createRings(store, relation);
+	polygonizer->assignAndMergeHoles();
+	polygonizer->validate();
+	put(id, polygonizer, estimatedSize(*polygonizer));
+	return polygonizer;
+}
+
+
+SharedPolygonizer RingCache::get(uint64_t relationId)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = map_.find(relationId);
+	if (it == map_.end())
+	{
+		misses_++;
+		return {};
+	}
+	hits_++;
+	entries_.splice(entries_.begin(), entries_, it->second);
+	return it->second->rings;
+}
+
+
+void RingCache::put(uint64_t relationId, SharedPolygonizer rings, size_t size)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = map_.find(relationId);
+	if (it != map_.end())
+	{
+		totalBytes_ -= it->second->size;
+		entries_.erase(it->second);
+		map_.erase(it);
+	}
+	if (size > maxBytes_) return;
+	entries_.push_front({ relationId, std::move(rings), size });
+	map_[relationId] = entries_.begin();
+	totalBytes_ += size;
+	evict();
+}
+
+
+void RingCache::setMaxBytes(size_t maxBytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	maxBytes_ = maxBytes;
+	evict();
+}
+
+
+void RingCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_.clear();
+	map_.clear();
+	totalBytes_ = 0;
+}
+
+
+RingCache::Stats RingCache::stats()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return { hits_, misses_, evictions_, entries_.size(), totalBytes_ };
+}
+
+
+void RingCache::evict()
+{
+	while (totalBytes_ > maxBytes_)
+	{
+		const Entry& last = entries_.back();
+		totalBytes_ -= last.size;
+		map_.erase(last.relationId);
+		entries_.pop_back();
+		evictions_++;
+	}
+}
+
+
+size_t RingCache::estimatedSize(const Polygonizer& polygonizer)
+{
+	// Each vertex of a ring is stored once in the segment it
+	// belongs to (the endpoints shared by adjacent segments are
+	// not counted, which roughly makes up for the segment headers)
+	size_t size = sizeof(Polygonizer);
+	polygonizer.forEachRing([&size](const Polygonizer::Ring* ring, bool)
+	{
+		size += sizeof(Polygonizer::Ring) + ring->vertexCount() * sizeof(Coordinate);
+	});
+	return size;
+}
+
+} // namespace geodesk
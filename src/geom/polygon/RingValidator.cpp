@@ -0,0 +1,242 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "RingValidator.h"
+#include <algorithm>
+#include <geodesk/geom/LineSegment.h>
+#include <geodesk/geom/MeasureKernels.h>
+#include <geodesk/geom/Quadrant.h>
+#include "RingCoordinateIterator.h"
+
+namespace geodesk {
+
+/**
+ * Returns 1 if a closed ring is oriented counter-clockwise, -1 if it
+ * is clockwise, or 0 if this can't be determined from the turn at its
+ * lowest vertex (which is only the case for degenerate rings). Unlike
+ * a shoelace sum, this is exact even for very thin rings.
+ */
+static int ringOrientation(const Coordinate* coords, int count)
+{
+    int n = count - 1;      // the last coordinate repeats the first
+    int lowest = 0;
+    for (int i = 1; i < n; i++)
+    {
+        if (coords[i].y < coords[lowest].y ||
+            (coords[i].y == coords[lowest].y && coords[i].x < coords[lowest].x))
+        {
+            lowest = i;
+        }
+    }
+    Coordinate v = coords[lowest];
+    int prev = lowest;
+    do prev = (prev + n - 1) % n; while (coords[prev] == v && prev != lowest);
+    int next = lowest;
+    do next = (next + 1) % n; while (coords[next] == v && next != lowest);
+    return LineSegment::side(coords[prev], v, coords[next]);
+}
+
+
+bool Polygonizer::RingValidator::validatePolygon(Ring* ring, bool isOuter)
+{
+    // A ring of n vertexes has n-1 edges, which form at most n-1 chains
+    int maxChainCount = ring->vertexCount();
+    if (isOuter)
+    {
+        for (Ring* inner = ring->firstInner_; inner; inner = inner->next_)
+        {
+            maxChainCount += inner->vertexCount();
+        }
+    }
+    chains_ = arena_.allocArray<Chain>(maxChainCount);
+    chainCount_ = 0;
+
+    bool valid = addRing(ring, isOuter);
+    if (isOuter)
+    {
+        for (Ring* inner = ring->firstInner_; inner; inner = inner->next_)
+        {
+            valid &= addRing(inner, false);
+        }
+    }
+    valid = valid && !hasInvalidEdges();
+    ring->valid_ = valid;
+    return valid;
+}
+
+
+/**
+ * Copies the coordinates of a ring, checks that it is closed,
+ * reverses it if necessary and slices it into monotone chains.
+ *
+ * @return false if the ring is not closed
+ */
+bool Polygonizer::RingValidator::addRing(Ring* ring, bool counterClockwise)
+{
+    int count = ring->vertexCount();
+    Coordinate* coords = arena_.allocArray<Coordinate>(count);
+    RingCoordinateIterator iter(ring);
+    for (int i = 0; i < count; i++) coords[i] = iter.next();
+    if (count < 4 || coords[0] != coords[count - 1]) return false;
+
+    // If the turn at the lowest vertex is degenerate, we fall back
+    // to the shoelace kernel (which yields a negative sum for
+    // counter-clockwise rings)
+    int orientation = ringOrientation(coords, count);
+    bool isCounterClockwise = orientation != 0 ? (orientation > 0) :
+        (MeasureKernels::shoelace(coords, count, coords[0].x) < 0);
+    if (isCounterClockwise != counterClockwise) ring->reverse();
+        // (The orientation of our copy doesn't matter)
+
+    int start = 0;
+    while (start < count - 1)
+    {
+        int end = start + 1;
+        if (coords[start].y != coords[end].y)
+        {
+            int quadrant = Quadrant::quadrant(coords[start], coords[end]);
+            while (end < count - 1 && coords[end].y != coords[end + 1].y &&
+                Quadrant::quadrant(coords[end], coords[end + 1]) == quadrant)
+            {
+                end++;
+            }
+        }
+        addChain(coords + start, end - start + 1);
+        start = end;
+    }
+    return true;
+}
+
+
+void Polygonizer::RingValidator::addChain(const Coordinate* coords, int count)
+{
+    Chain& chain = chains_[chainCount_++];
+    if (coords[0].y > coords[count - 1].y)
+    {
+        Coordinate* reversed = arena_.allocArray<Coordinate>(count);
+        std::reverse_copy(coords, coords + count, reversed);
+        coords = reversed;
+    }
+    chain.coords = coords;
+    chain.count = count;
+    chain.minX = std::min(coords[0].x, coords[count - 1].x);
+    chain.maxX = std::max(coords[0].x, coords[count - 1].x);
+}
+
+
+bool Polygonizer::RingValidator::hasInvalidEdges()
+{
+    std::sort(chains_, chains_ + chainCount_, [](const Chain& a, const Chain& b)
+    {
+        return a.minY() < b.minY();
+    });
+
+    for (int i = 0; i < chainCount_; i++)
+    {
+        const Chain& a = chains_[i];
+        for (int j = i + 1; j < chainCount_ && chains_[j].minY() <= a.maxY(); j++)
+        {
+            const Chain& b = chains_[j];
+            if (b.maxX < a.minX || b.minX > a.maxX) continue;
+            if (chainsIntersect(a, b)) return true;
+        }
+    }
+    return false;
+}
+
+
+const Coordinate* Polygonizer::RingValidator::Chain::findEdgeForY(int32_t y) const
+{
+    int start = 1;
+    int end = count - 1;
+    while (start <= end)
+    {
+        int mid = start + (end - start) / 2;
+        if (coords[mid].y < y)
+        {
+            start = mid + 1;
+        }
+        else
+        {
+            end = mid - 1;
+        }
+    }
+    return &coords[start - 1];
+}
+
+
+/**
+ * Walks two chains (whose Y-ranges overlap) from south to north,
+ * testing each pair of edges whose Y-ranges overlap
+ * (same approach as MonotoneChain::intersects()).
+ */
+bool Polygonizer::RingValidator::chainsIntersect(const Chain& a, const Chain& b)
+{
+    const Chain* chain1 = &a;
+    const Chain* chain2 = &b;
+    if (chain2->minY() > chain1->minY()) std::swap(chain1, chain2);
+
+    const Coordinate* p1 = chain1->coords;
+    const Coordinate* pEnd1 = chain1->coords + chain1->count;
+    const Coordinate* p2 = chain2->findEdgeForY(chain1->minY());
+    const Coordinate* pEnd2 = chain2->coords + chain2->count;
+    Coordinate start1 = *p1++;
+    Coordinate end1 = *p1++;
+    Coordinate start2 = *p2++;
+    Coordinate end2 = *p2++;
+    for (;;)
+    {
+        if (edgesIntersect(start1, end1, start2, end2)) return true;
+        if (end1.y < end2.y)
+        {
+            if (p1 == pEnd1) break;
+            start1 = end1;
+            end1 = *p1++;
+        }
+        else
+        {
+            if (p2 == pEnd2) break;
+            start2 = end2;
+            end2 = *p2++;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Checks if two edges cross, or if they are collinear and share more
+ * than a single point. Edges that only touch are not considered to
+ * intersect.
+ */
+bool Polygonizer::RingValidator::edgesIntersect(
+    Coordinate a1, Coordinate a2, Coordinate b1, Coordinate b2)
+{
+    int d1 = LineSegment::side(a1, a2, b1);
+    int d2 = LineSegment::side(a1, a2, b2);
+    int d3 = LineSegment::side(b1, b2, a1);
+    int d4 = LineSegment::side(b1, b2, a2);
+    if (d1 * d2 < 0 && d3 * d4 < 0) return true;
+    if (d1 != 0 || d2 != 0) return false;
+
+    // Collinear: check if the edges overlap along the axis
+    // on which the first edge extends
+    int32_t minA, maxA, minB, maxB;
+    if (a1.x != a2.x)
+    {
+        minA = std::min(a1.x, a2.x);
+        maxA = std::max(a1.x, a2.x);
+        minB = std::min(b1.x, b2.x);
+        maxB = std::max(b1.x, b2.x);
+    }
+    else
+    {
+        minA = std::min(a1.y, a2.y);
+        maxA = std::max(a1.y, a2.y);
+        minB = std::min(b1.y, b2.y);
+        maxB = std::max(b1.y, b2.y);
+    }
+    return std::max(minA, minB) < std::min(maxA, maxB);
+}
+
+} // namespace geodesk
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#pragma once
+
+#include <geodesk/geom/polygon/Polygonizer.h>
+#include <clarisma/alloc/Arena.h>
+#include <geodesk/geom/Coordinate.h>
+#include "Ring.h"
+
+namespace geodesk {
+
+/**
+ * Checks a polygon (an outer ring and its holes) for edges that cross
+ * or overlap, and normalizes the orientation of its rings.
+ *
+ * The rings are sliced into monotone chains (runs of edges that all
+ * point into the same quadrant; horizontal edges form chains of their
+ * own), which are sorted by their lowest Y and swept from south to
+ * north. Only chains whose extents overlap are compared, by walking
+ * both chains in step along the Y axis, so only edges with overlapping
+ * Y-ranges are tested against each other. Two edges are considered
+ * invalid if they cross, or if they are collinear and share more than
+ * a single point (which also catches spikes); edges that merely touch
+ * (such as consecutive edges, or rings touching at a vertex) are not.
+ * The orientation tests are computed exactly (in 128-bit integer
+ * math), so nearly collinear edges are never misclassified.
+ *
+ * All scratch memory (the copied coordinates and the chains) is
+ * allocated from the given Arena.
+ */
+class Polygonizer::RingValidator
+{
+public:
+    explicit RingValidator(clarisma::Arena& arena) :
+        arena_(arena),
+        chains_(nullptr),
+        chainCount_(0) {}
+
+    /**
+     * Validates the given ring (including its holes, if it is an
+     * outer ring) and marks it as valid or invalid.
+     *
+     * @return true if the polygon is valid
+     */
+    bool validatePolygon(Ring* ring, bool isOuter);
+
+private:
+    struct Chain
+    {
+        const Coordinate* coords;   // in ascending order of Y
+        int count;
+        int32_t minX;
+        int32_t maxX;
+
+        int32_t minY() const { return coords[0].y; }
+        int32_t maxY() const { return coords[count - 1].y; }
+
+        /**
+         * Returns a pointer to the start of the first edge
+         * whose end lies at or above y.
+         */
+        const Coordinate* findEdgeForY(int32_t y) const;
+    };
+
+    bool addRing(Ring* ring, bool counterClockwise);
+    void addChain(const Coordinate* coords, int count);
+    bool hasInvalidEdges();
+
+    static bool chainsIntersect(const Chain& a, const Chain& b);
+    static bool edgesIntersect(Coordinate a1, Coordinate a2, Coordinate b1, Coordinate b2);
+
+    clarisma::Arena& arena_;
+    Chain* chains_;
+    int chainCount_;
+};
+
+} // namespace geodesk
@@ -45,12 +45,22 @@ public:
 
     Box bounds() const
     {
-        return way.bounds();
+        if (!way.isNull()) return way.bounds();
+
+        // Fragments (and the segments of rings added via
+        // Polygonizer::addRing()) have no way
+        Box b;
+        for (int i = 0; i < vertexCount; i++) b.expandToInclude(coords[i]);
+        return b;
     }
 
-    #ifdef GEODESK_WITH_GEOS
-    void copyTo(GEOSContextHandle_t context, GEOSCoordSequence* seq, int destPos) const;
-    #endif
+    /**
+     * Copies all coordinates except the start coordinate (in the
+     * direction of the ring) to `dest`.
+     *
+     * @return a pointer past the last copied coordinate
+     */
+    Coordinate* copyTo(Coordinate* dest) const;
     Segment* createFragment(int start, int end, clarisma::Arena& arena) const;
 };
 
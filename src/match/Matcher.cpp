@@ -4,7 +4,9 @@
 #include <geodesk/match/Matcher.h>
 #include <cstddef>   // for offsetof
 #include <regex>
+#include <clarisma/util/Bits.h>
 #include <clarisma/util/pointer.h>
+#include <geodesk/match/MatcherProfile.h>
 
 namespace geodesk {
 
@@ -22,6 +24,11 @@ bool MatcherHolder::matchAllMethod(const Matcher*, FeaturePtr)
 	return true;
 }
 
+uint64_t MatcherHolder::matchAllBatchMethod(const Matcher*, const FeaturePtr*, int count)
+{
+	return count == Matcher::MAX_BATCH_SIZE ? ~0ULL : ((1ULL << count) - 1);
+}
+
 
 MatcherHolder::MatcherHolder(FeatureTypes types, uint32_t keyMask, uint32_t keyMin) :
 	refcount_(1),
@@ -31,7 +38,7 @@ MatcherHolder::MatcherHolder(FeatureTypes types, uint32_t keyMask, uint32_t keyM
 	regexCount_(0),
 	roleMatcherOffset_(offsetof(MatcherHolder, defaultRoleMatcher_)),
 	defaultRoleMatcher_(defaultRoleMethod, nullptr),
-	mainMatcher_(matchAllMethod, nullptr)
+	mainMatcher_(matchAllMethod, matchAllBatchMethod, nullptr)
 {
 	for (int i = 0; i < 4; i++)
 	{
@@ -75,6 +82,11 @@ void MatcherHolder::dealloc() const
 		}
 	}
 
+#ifdef GEODESK_MATCHER_PROFILING
+	delete MatcherProfile::of(this);
+		// (nullptr unless this is a compiled matcher)
+#endif
+
 	delete[] p;
 }
 
@@ -85,98 +97,124 @@ const MatcherHolder* MatcherHolder::createMatchAll(FeatureTypes types)
 }
 
 /**
- * A matcher that checks for [k=v], where k and v are both global strings.
+ * A matcher that checks for N tags with global keys, e.g.
+ * [highway=primary][name][oneway=yes]. Keys in the global-tag table
+ * are sorted, so all tests are resolved in a single pass; since N is
+ * a template parameter, the loop over the tests is fully unrolled.
  */
-class GlobalTagMatcher : public Matcher
+template<int N>
+class GlobalTagsMatcher : public Matcher
 {
 public:
-    GlobalTagMatcher(int keyCode, int valueCode) :
-        Matcher(matchKeyValue, nullptr),	// don't need store access
-        tagBits_((keyCode << 2) | (valueCode << 16) | 1) {}
+	GlobalTagsMatcher(const GlobalTagTest* tests) :
+		Matcher(matchTags, acceptEachWith<matchTags>, nullptr)
+			// don't need store access
+	{
+		for (int i = 0; i < N; i++)
+		{
+			Test& test = tests_[i];
+			test.keyBits = static_cast<uint16_t>(tests[i].keyCode << 2);
+			test.valueBits = (static_cast<uint32_t>(tests[i].valueCode) << 16) | 1;
+				// narrow string value (global string)
+			test.notEqual = tests[i].notEqual;
+		}
+		std::sort(tests_, tests_ + N, [](const Test& a, const Test& b)
+		{
+			return a.keyBits < b.keyBits;
+		});
+	}
 
-	static bool matchKeyValue(const Matcher* matcher, FeaturePtr pFeature)
+	static bool matchTags(const Matcher* matcher, FeaturePtr pFeature)
 	{
-		uint32_t tagBits = ((GlobalTagMatcher*)matcher)->tagBits_;
-		uint16_t keyBits = static_cast<uint16_t>(tagBits);
+		const Test* tests = static_cast<const GlobalTagsMatcher*>(matcher)->tests_;
 		DataPtr p(pFeature.ptr() + 8);
 		p = p.followTagged(~1);			// TODO: clean up
-		for (; ; )
+		for (int i = 0; i < N; i++)
 		{
-			// TODO: maybe just fetch key/value separately
-			// to avoid unaligned read issue altogether
-			uint32_t tag = p.getUnsignedIntUnaligned();
-			if ((tag & 0xffff) >= keyBits)
+			const Test& test = tests[i];
+			uint32_t tag;
+			for (; ; )
 			{
-				return (tag & 0xffff'7fff) == tagBits;
+				// The last key has bit 15 set, so this loop always ends
+				tag = p.getUnsignedIntUnaligned();
+				if ((tag & 0xffff) >= test.keyBits) break;
+				p += 4 + (tag & 2);
 			}
-			p += 4 + (tag & 2);
+			if ((tag & 0x7ffc) != test.keyBits) return false;
+			if (((tag & 0xffff'0003) == test.valueBits) == test.notEqual) return false;
+			// The next test has a higher key, so we stay on the current
+			// tag (if it was the last, the next key comparison fails)
 		}
+		return true;
 	}
 
 private:
-    uint32_t tagBits_;
+	struct Test
+	{
+		uint16_t keyBits;
+		bool notEqual;
+		uint32_t valueBits;
+	};
+
+	Test tests_[N];
 };
 
+
 /**
- * A matcher that checks for [k], where k is a global string (k must be
- * present and must not be "no")
+ * Allocates a MatcherHolder whose main matcher is a GlobalTagsMatcher<N>,
+ * which is larger than a plain Matcher and extends into the space
+ * allocated past the end of the MatcherHolder.
  */
-class GlobalKeyMatcher : public Matcher
+template<int N>
+const MatcherHolder* MatcherHolder::createGlobalTagsMatcher(FeatureTypes types,
+	uint32_t indexBits, const GlobalTagTest* tests)
 {
-public:
-	GlobalKeyMatcher(int keyCode, int codeNo) :
-		Matcher(matchKeyValue, nullptr),	// don't need store access
-		tagBits_((keyCode << 2) | (codeNo << 16)) {}
+	uint8_t* p = alloc(sizeof(MatcherHolder) + sizeof(GlobalTagsMatcher<N>) - sizeof(Matcher));
+	MatcherHolder* self = new (p) MatcherHolder(types, indexBits, indexBits);
+	// Construct the matcher in the raw allocation (rather than in the
+	// storage of mainMatcher_, which is too small for it)
+	size_t offset = reinterpret_cast<const uint8_t*>(&self->mainMatcher_) - p;
+	new (p + offset) GlobalTagsMatcher<N>(tests);
+	return self;
+}
+
+
+const MatcherHolder* MatcherHolder::createMatchGlobalTags(FeatureTypes types,
+	uint32_t indexBits, const GlobalTagTest* tests, int count)
+{
+	assert(count > 0 && count <= MAX_GLOBAL_TAG_TESTS);
 
-	static bool matchKeyValue(const Matcher* matcher, FeaturePtr pFeature)
+	// Every test requires its key, so a feature must have all
+	// indexed keys: (keys & indexBits) >= indexBits
+	// (only true if all bits are present)
+
+	switch (count)
 	{
-		uint32_t tagBits = ((GlobalKeyMatcher*)matcher)->tagBits_;
-		uint16_t keyBits = static_cast<uint16_t>(tagBits);
-		pointer p(pFeature.ptr() + 8);
-		p = p.followTagged(~1);
-		for (; ; )
-		{
-			uint32_t key = p.getUnsignedShort();
-			if (key > keyBits)
-			{
-				uint32_t tag = (p.getUnsignedShort(2) << 16) | (key & 3);
-				return (key & 0x7ffc) == keyBits && tag != 
-					((tagBits & 0xffff'0000) | 1);
-				// key matches, but it's value is not global string "no"
-			}
-			p += 4 + (key & 2);
-		}
+	case 1:
+		return createGlobalTagsMatcher<1>(types, indexBits, tests);
+	case 2:
+		return createGlobalTagsMatcher<2>(types, indexBits, tests);
+	case 3:
+		return createGlobalTagsMatcher<3>(types, indexBits, tests);
+	default:
+		return createGlobalTagsMatcher<4>(types, indexBits, tests);
 	}
-
-private:
-	uint32_t tagBits_;
-};
+}
 
 
-// TODO: doesn't work, need mask, check "no"
 const MatcherHolder* MatcherHolder::createMatchKey(
 	FeatureTypes types, uint32_t indexBits, int keyCode, int codeNo)
 {
-	size_t size = sizeof(MatcherHolder) + sizeof(GlobalKeyMatcher) - sizeof(Matcher);
-	MatcherHolder* self = (MatcherHolder*)alloc(size);
-
-	// Since there is only one tag, mask and min are the same
-	new (self) MatcherHolder(types, indexBits, indexBits);
-	new (&self->mainMatcher_)GlobalKeyMatcher(keyCode, codeNo);
-	return self;
+	GlobalTagTest test{ keyCode, codeNo, true };
+	return createMatchGlobalTags(types, indexBits, &test, 1);
 }
 
 
 const MatcherHolder* MatcherHolder::createMatchKeyValue(
 	FeatureTypes types, uint32_t indexBits, int keyCode, int valueCode)
 {
-	size_t size = sizeof(MatcherHolder) + sizeof(GlobalTagMatcher) - sizeof(Matcher);
-	MatcherHolder* self = (MatcherHolder*)alloc(size);
-
-	// Since there is only one tag, mask and min are the same
-	new (self) MatcherHolder(types, indexBits, indexBits);
-	new (&self->mainMatcher_)GlobalTagMatcher(keyCode, valueCode);
-	return self;
+	GlobalTagTest test{ keyCode, valueCode, false };
+	return createMatchGlobalTags(types, indexBits, &test, 1);
 }
 
 
@@ -184,17 +222,56 @@ class ComboMatcher : public Matcher
 {
 public:
 	ComboMatcher(FeatureStore* store) :
-		Matcher(matchCombo, store) {}
+		Matcher(matchCombo, matchComboBatch, store) {}
 
 	static bool matchCombo(const Matcher* matcher, FeaturePtr pFeature)
 	{
-		const uint8_t* p = reinterpret_cast<const uint8_t*>(matcher) -
-			offsetof(MatcherHolder, mainMatcher_) - sizeof(MatcherHolder*) * 2;
-		const MatcherHolder* const* pChildMatcher =
-			reinterpret_cast<const MatcherHolder* const*>(p);
+		const MatcherHolder* const* pChildMatcher = childMatchers(matcher);
 		return (*pChildMatcher)->mainMatcher_.accept(pFeature) &&
 			(*(pChildMatcher + 1))->mainMatcher_.accept(pFeature);
 	}
+
+	/**
+	 * Runs the first child over the whole batch, then runs the
+	 * second child only over the features accepted by the first.
+	 */
+	static uint64_t matchComboBatch(const Matcher* matcher,
+		const FeaturePtr* features, int count)
+	{
+		const MatcherHolder* const* pChildMatcher = childMatchers(matcher);
+		uint64_t accepted = (*pChildMatcher)->mainMatcher_.acceptBatch(features, count);
+		if (accepted == 0) return 0;
+
+		FeaturePtr survivors[MAX_BATCH_SIZE];
+		uint8_t survivorIndexes[MAX_BATCH_SIZE];
+		int survivorCount = 0;
+		uint64_t bits = accepted;
+		while (bits)
+		{
+			int i = Bits::countTrailingZerosInNonZero(bits);
+			bits &= bits - 1;
+			survivors[survivorCount] = features[i];
+			survivorIndexes[survivorCount++] = static_cast<uint8_t>(i);
+		}
+		uint64_t acceptedSurvivors = (*(pChildMatcher + 1))->mainMatcher_.acceptBatch(
+			survivors, survivorCount);
+		accepted = 0;
+		while (acceptedSurvivors)
+		{
+			int i = Bits::countTrailingZerosInNonZero(acceptedSurvivors);
+			acceptedSurvivors &= acceptedSurvivors - 1;
+			accepted |= 1ULL << survivorIndexes[i];
+		}
+		return accepted;
+	}
+
+private:
+	static const MatcherHolder* const* childMatchers(const Matcher* matcher)
+	{
+		const uint8_t* p = reinterpret_cast<const uint8_t*>(matcher) -
+			offsetof(MatcherHolder, mainMatcher_) - sizeof(MatcherHolder*) * 2;
+		return reinterpret_cast<const MatcherHolder* const*>(p);
+	}
 };
 
 
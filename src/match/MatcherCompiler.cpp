@@ -8,6 +8,8 @@
 #include "match/MatcherEmitter.h"
 #include "match/MatcherParser.h"
 #include "match/MatcherValidator.h"
+#include "match/Selector.h"
+#include "match/TagClause.h"
 #include <clarisma/util/BufferWriter.h>
 #include <clarisma/util/log.h>
 
@@ -29,45 +31,19 @@ const MatcherHolder* MatcherCompiler::getMatcher(const char* query)
 	{
 		// Single-selector query
 		FeatureTypes types = sel->acceptedTypes;
-		TagClause* clause = sel->firstClause;
-		if (clause == nullptr)
+		if (sel->firstClause == nullptr)
 		{
 			// Types only
 			matcher = MatcherHolder::createMatchAll(types);
 		}
 		else
 		{
-			OpNode* keyOp = &clause->keyOp;
-			if (clause->next == nullptr &&
-				keyOp->opcode == Opcode::GLOBAL_KEY &&
-				!keyOp->isNegated())
+			GlobalTagTest tests[MatcherHolder::MAX_GLOBAL_TAG_TESTS];
+			int count = globalTagTests(sel, parser.codeNo(), tests);
+			if (count)
 			{
-				// single positive global-key op
-				int globalKeyCode = keyOp->operand.code;
-				OpNode* valueOp = keyOp->next[1];
-				assert(valueOp);
-				if (valueOp->opcode == Opcode::EQ_CODE && 
-					valueOp->next[0]->opcode == Opcode::RETURN &&
-					valueOp->next[1]->opcode == Opcode::RETURN)
-				{
-					// single EQ_CODE value-op
-
-					int valueCode = valueOp->operand.code;
-					if (valueOp->isNegated())
-					{
-						int codeNo = parser.codeNo();
-						if (valueCode == codeNo)
-						{
-							matcher = MatcherHolder::createMatchKey(
-								types, indexBits, globalKeyCode, codeNo);
-						}
-					}
-					else
-					{
-						matcher = MatcherHolder::createMatchKeyValue(
-							types, indexBits, globalKeyCode, valueCode);
-					}
-				}
+				matcher = MatcherHolder::createMatchGlobalTags(
+					types, indexBits, tests, count);
 			}
 		}
 	}
@@ -88,12 +64,50 @@ const MatcherHolder* MatcherCompiler::getMatcher(const char* query)
 	return matcher;
 }
 
+/**
+ * Checks if the clauses of a selector are all simple tests of global
+ * keys ([k=v] where v is a global string, or [k]), which can be
+ * handled by a specialized matcher instead of the interpreter.
+ *
+ * @return the number of tests written to `tests`, or 0 if the
+ *   selector doesn't have this shape (or has too many clauses)
+ */
+int MatcherCompiler::globalTagTests(const Selector* sel, int codeNo, GlobalTagTest* tests)
+{
+	int count = 0;
+	for (const TagClause* clause = sel->firstClause; clause; clause = clause->next)
+	{
+		if (count == MatcherHolder::MAX_GLOBAL_TAG_TESTS) return 0;
+		const OpNode* keyOp = &clause->keyOp;
+		if (keyOp->opcode != Opcode::GLOBAL_KEY || keyOp->isNegated()) return 0;
+		const OpNode* valueOp = keyOp->next[1];
+		assert(valueOp);
+		if (valueOp->opcode != Opcode::EQ_CODE ||
+			valueOp->next[0]->opcode != Opcode::RETURN ||
+			valueOp->next[1]->opcode != Opcode::RETURN)
+		{
+			return 0;
+		}
+		int valueCode = valueOp->operand.code;
+		bool notEqual = valueOp->isNegated();
+		if (notEqual && valueCode != codeNo) return 0;
+			// only [k] (i.e. k != "no") is supported
+		tests[count++] = { static_cast<int>(keyOp->operand.code), valueCode, notEqual };
+	}
+	return count;
+}
+
 const MatcherHolder* MatcherCompiler::compileMatcher(OpGraph& graph, Selector* firstSel, uint32_t indexBits)
 {
 	MatcherValidator validator(graph);
 	OpNode* root = validator.validate(firstSel);
 
 	size_t resourceSize = validator.resourceSize();
+#ifdef GEODESK_MATCHER_PROFILING
+	// Reserve a slot for the profile pointer right ahead of the
+	// MatcherHolder (see MatcherProfile::of)
+	resourceSize += sizeof(MatcherProfile*);
+#endif
 	size_t matcherSize = sizeof(MatcherHolder) + resourceSize + validator.maxInstructionSize();
 	uint8_t* matcherData = new uint8_t[matcherSize];
 	MatcherHolder* matcherHolder = reinterpret_cast<MatcherHolder*>(matcherData + resourceSize);
@@ -112,7 +126,14 @@ const MatcherHolder* MatcherCompiler::compileMatcher(OpGraph& graph, Selector* f
 	emitter.emit();
 	emitter.fixJumps();
 
-	new (&matcherHolder->mainMatcher_)Matcher((MatcherMethod)MatcherEngine::accept, store_);
+	new (&matcherHolder->mainMatcher_)Matcher((MatcherMethod)MatcherEngine::accept,
+		MatcherEngine::acceptBatch, store_);
+
+#ifdef GEODESK_MATCHER_PROFILING
+	// The profile is owned by the matcher (freed by MatcherHolder::dealloc)
+	*reinterpret_cast<MatcherProfile**>(matcherData + resourceSize - sizeof(MatcherProfile*)) =
+		new MatcherProfile(validator.maxInstructionSize() / 2);
+#endif
 
 	return matcherHolder;
 }
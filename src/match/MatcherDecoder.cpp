@@ -6,6 +6,7 @@
 #include "MatcherEmitter.h"			// TODO: refactor
 #include "OpGraph.h"
 #include <geodesk/feature/FeatureStore.h>
+#include <geodesk/match/MatcherProfile.h>
 
 namespace geodesk {
 
@@ -13,6 +14,10 @@ using namespace clarisma;
 
 void MatcherDecoder::decode()
 {
+	if (profile_)
+	{
+		out_.writeString("    executed      matched         cycles  addr  instruction\n");
+	}
 	const uint16_t* p = pCodeStart_;
 	for (;;)
 	{
@@ -71,9 +76,28 @@ void MatcherDecoder::writeAddress(const uint16_t* p, bool padded)
 	out_.writeString(buf);
 }
 
-void MatcherDecoder::writeOpcodeStub(const uint16_t* p)
+/**
+ * Writes the address of the instruction, preceded by its execution
+ * counts if we're decoding a profiled matcher.
+ */
+void MatcherDecoder::writeInstructionStart(const uint16_t* p)
 {
+	if (profile_)
+	{
+		MatcherProfile::Counters& counters = profile_->counters(p - pCodeStart_);
+		char buf[80];
+		Format::unsafe(buf, "%12llu %12llu %14llu ",
+			static_cast<unsigned long long>(counters.executed.load(std::memory_order_relaxed)),
+			static_cast<unsigned long long>(counters.matched.load(std::memory_order_relaxed)),
+			static_cast<unsigned long long>(counters.cycles.load(std::memory_order_relaxed)));
+		out_.writeString(buf);
+	}
 	writeAddress(p, true);
+}
+
+void MatcherDecoder::writeOpcodeStub(const uint16_t* p)
+{
+	writeInstructionStart(p);
 	out_.writeString("  ");
 	out_.writeString(OPCODE_NAMES[*p & 0xff]);
 }
@@ -82,7 +106,7 @@ void MatcherDecoder::writeBranchingOp(const uint16_t* p)
 {
 	int opcode = *p & 0xff;
 	bool negated = (*p >> 8) & 1;
-	writeAddress(p, true);
+	writeInstructionStart(p);
 	out_.writeString(negated ? "  NOT " : "  ");
 	out_.writeString(OPCODE_NAMES[*p & 0xff]);
 	p++;
@@ -9,17 +9,21 @@
 namespace geodesk {
 
 class FeatureStore;
+class MatcherProfile;
 
 class MatcherDecoder
 {
 public:
-	MatcherDecoder(FeatureStore* store, clarisma::BufferWriter& out, const uint16_t* pCode) :
-		store_(store), out_(out), pCodeStart_(pCode), pLastInstruction_(pCode) {}
+	MatcherDecoder(FeatureStore* store, clarisma::BufferWriter& out, const uint16_t* pCode,
+		MatcherProfile* profile = nullptr) :
+		store_(store), out_(out), pCodeStart_(pCode), pLastInstruction_(pCode),
+		profile_(profile) {}
 
 	void decode();
 	
 private:
 	void writeAddress(const uint16_t* p, bool padded);
+	void writeInstructionStart(const uint16_t* p);
 	void writeOpcodeStub(const uint16_t* p);
 	void writeBranchingOp(const uint16_t* p);
 
@@ -27,6 +31,7 @@ private:
 	const uint16_t* pLastInstruction_;
 	clarisma::BufferWriter& out_;
 	FeatureStore* store_;
+	MatcherProfile* profile_;		// may be null
 };
 
 } // namespace geodesk
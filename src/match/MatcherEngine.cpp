@@ -46,8 +46,17 @@ int MatcherEngine::scanLocalKeys()
         int32_t key = pTag_.getUnalignedInt();
         pTag_ -= 6 + (key & 2);
         pointer pKey = pTagTableAligned + ((key >> 3) << 2);
-        geodesk::StringValue keyString(pKey);
-        if (keyString == operand)
+        bool matched;
+        if (localKeyMatches_)
+        {
+            matched = localKeyMatches_->matches(pKey.asBytePointer(), operand);
+        }
+        else
+        {
+            geodesk::StringValue keyString(pKey);
+            matched = (keyString == operand);
+        }
+        if (matched)
         {
             tagKey_ = key;
             return 1;
@@ -95,8 +104,15 @@ inline uint32_t MatcherEngine::getFeatureTypeOperand()
 }
 
 int MatcherEngine::accept(const Matcher* matcher, FeaturePtr pFeature)
+{
+    return run(matcher, pFeature, nullptr);
+}
+
+int MatcherEngine::run(const Matcher* matcher, FeaturePtr pFeature,
+    LocalKeyMatches* localKeyMatches)
 {
     MatcherEngine ctx;
+    ctx.localKeyMatches_ = localKeyMatches;
     uint32_t codeValue;
     const uint8_t* stringValue;
     double doubleValue;
@@ -104,9 +120,11 @@ int MatcherEngine::accept(const Matcher* matcher, FeaturePtr pFeature)
     // The matcher's bytecode begins right after the Matcher structure
     ctx.ip_ = pointer(reinterpret_cast<const uint8_t*>(matcher) + sizeof(Matcher));
     ctx.pTagTable_ = (pFeature.ptr() + 8).follow();
+    MatcherProfileRecorder profile(matcher);    // no-op unless profiling
     for (;;)
     {
         int matched;
+        profile.enter(ctx.ip_.asBytePointer());
         int op = ctx.ip_.getUnsignedShort();
         int opcode = op & 0xff;
         ctx.ip_ += 2;   // move to first operand
@@ -314,9 +332,21 @@ int MatcherEngine::accept(const Matcher* matcher, FeaturePtr pFeature)
             // is corrupted and the bounds check won't save us
         }
         matched ^= isNegated(op);
+        profile.matched(matched);
         ctx.jumpIf(matched);
     }
 }
 
 
+uint64_t MatcherEngine::acceptBatch(const Matcher* matcher,
+    const FeaturePtr* features, int count)
+{
+    LocalKeyMatches localKeyMatches;
+    return Matcher::acceptPrefetched(features, count,
+        [matcher, &localKeyMatches](FeaturePtr f)
+        {
+            return run(matcher, f, &localKeyMatches) != 0;
+        });
+}
+
 } // namespace geodesk
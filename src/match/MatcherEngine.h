@@ -3,21 +3,136 @@
 
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <regex>
 #include <string_view>
 #include <clarisma/util/pointer.h>
 #include <clarisma/util/ShortVarString.h>
+#include <geodesk/feature/StringValue.h>
 #include <geodesk/match/Matcher.h>
+#include <geodesk/match/MatcherProfile.h>
 
 namespace geodesk {
 
 
+/**
+ * Remembers, for the duration of a batch, whether a local-key string
+ * equals a string operand of the matcher. Local-key strings are
+ * typically shared by all features in a tile, so a batch of features
+ * from the same index leaf resolves each distinct key string once,
+ * and afterwards only compares pointers (see also LocalKeyCache).
+ */
+class LocalKeyMatches
+{
+public:
+	LocalKeyMatches() : initialized_(false) {}
+
+	bool matches(const uint8_t* keyString, std::string_view operand)
+	{
+		if (!initialized_)
+		{
+			memset(entries_, 0, sizeof(entries_));
+			initialized_ = true;
+		}
+		uint64_t h = (reinterpret_cast<uintptr_t>(keyString) ^
+			(reinterpret_cast<uintptr_t>(operand.data()) << 16))
+			* 0x9E37'79B9'7F4A'7C15ULL;
+		Entry& entry = entries_[h >> (64 - SLOT_BITS)];
+		if (entry.keyString == keyString && entry.operand == operand.data())
+		{
+			return entry.matched;
+		}
+		entry.keyString = keyString;
+		entry.operand = operand.data();
+		entry.matched = geodesk::StringValue(keyString) == operand;
+		return entry.matched;
+	}
+
+private:
+	static constexpr int SLOT_BITS = 8;
+
+	struct Entry
+	{
+		const uint8_t* keyString;
+		const char* operand;
+		bool matched;
+	};
+
+	bool initialized_;
+	Entry entries_[1 << SLOT_BITS];
+};
+
+#ifdef GEODESK_MATCHER_PROFILING
+/**
+ * Attributes executions, matches and elapsed cycles to the instruction
+ * currently being executed by the MatcherEngine. The time spent in an
+ * instruction is measured from its start to the start of the next
+ * instruction (or the end of the run).
+ */
+class MatcherProfileRecorder
+{
+public:
+	explicit MatcherProfileRecorder(const Matcher* matcher) :
+		profile_(MatcherProfile::of(matcher)),
+		pCode_(reinterpret_cast<const uint8_t*>(matcher) + sizeof(Matcher)),
+		current_(nullptr),
+		start_(0)
+	{
+	}
+
+	~MatcherProfileRecorder() { stop(MatcherProfile::timestamp()); }
+
+	void enter(const uint8_t* ip)
+	{
+		if (!profile_) return;
+		uint64_t now = MatcherProfile::timestamp();
+		stop(now);
+		current_ = &profile_->counters((ip - pCode_) / 2);
+		current_->executed.fetch_add(1, std::memory_order_relaxed);
+		start_ = now;
+	}
+
+	void matched(int matched)
+	{
+		if (current_ && matched)
+		{
+			current_->matched.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	void stop(uint64_t now)
+	{
+		if (current_)
+		{
+			current_->cycles.fetch_add(now - start_, std::memory_order_relaxed);
+		}
+	}
+
+	MatcherProfile* profile_;
+	const uint8_t* pCode_;
+	MatcherProfile::Counters* current_;
+	uint64_t start_;
+};
+#else
+class MatcherProfileRecorder
+{
+public:
+	explicit MatcherProfileRecorder(const Matcher*) {}
+	void enter(const uint8_t*) {}
+	void matched(int) {}
+};
+#endif
+
 class MatcherEngine
 {
 public:
 	static int accept(const Matcher*, FeaturePtr);
+	static uint64_t acceptBatch(const Matcher*, const FeaturePtr* features, int count);
 
 private:
+	static int run(const Matcher*, FeaturePtr, LocalKeyMatches* localKeyMatches);
+
 	void jumpIf(int matched) { ip_ += matched ? ip_.getShort() : 2; }
 	inline int scanGlobalKeys();
 	int scanLocalKeys();	// inline not needed for this
@@ -39,6 +154,7 @@ private:
 	clarisma::pointer pTag_;
 	uint16_t tagKey_;
 	int16_t valueOfs_;
+	LocalKeyMatches* localKeyMatches_;		// may be null
 };
 
 
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/match/MatcherProfile.h>
+#include <chrono>
+#include <cstddef>   // for offsetof
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+#include <clarisma/util/BufferWriter.h>
+#include <geodesk/match/Matcher.h>
+#include "match/MatcherDecoder.h"
+#include "match/MatcherEngine.h"
+
+namespace geodesk {
+
+using namespace clarisma;
+
+MatcherProfile::MatcherProfile(size_t codeWords) :
+    codeWords_(codeWords),
+    counters_(new Counters[codeWords])
+{
+    reset();
+}
+
+bool MatcherProfile::isEnabled()
+{
+#ifdef GEODESK_MATCHER_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MatcherProfile::reset()
+{
+    for (size_t i = 0; i < codeWords_; i++)
+    {
+        counters_[i].executed.store(0, std::memory_order_relaxed);
+        counters_[i].matched.store(0, std::memory_order_relaxed);
+        counters_[i].cycles.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t MatcherProfile::timestamp()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// In profiling builds, MatcherCompiler reserves a slot for a pointer
+// to the profile at the very end of the matcher's resources, right
+// ahead of the MatcherHolder
+
+MatcherProfile* MatcherProfile::of(const MatcherHolder* matcher)
+{
+    return of(&matcher->mainMatcher());
+}
+
+MatcherProfile* MatcherProfile::of(const Matcher* matcher)
+{
+#ifdef GEODESK_MATCHER_PROFILING
+    if (matcher->method() != (MatcherMethod)MatcherEngine::accept) return nullptr;
+        // Only compiled matchers have a profile
+    const uint8_t* pHolder = reinterpret_cast<const uint8_t*>(matcher) -
+        offsetof(MatcherHolder, mainMatcher_);
+    return *reinterpret_cast<MatcherProfile* const*>(
+        pHolder - sizeof(MatcherProfile*));
+#else
+    (void)matcher;
+    return nullptr;
+#endif
+}
+
+std::string MatcherProfile::report(const MatcherHolder* matcher)
+{
+    MatcherProfile* profile = of(matcher);
+    if (!profile)
+    {
+        return isEnabled() ? "(matcher has no profile)\n" :
+            "(not built with GEODESK_MATCHER_PROFILING)\n";
+    }
+    DynamicBuffer buf(4096);
+    BufferWriter out(&buf);
+    MatcherDecoder decoder(matcher->mainMatcher().store(), out,
+        reinterpret_cast<const uint16_t*>(
+            reinterpret_cast<const uint8_t*>(&matcher->mainMatcher()) + sizeof(Matcher)),
+        profile);
+    decoder.decode();
+    return std::string(buf.data(), buf.length());
+}
+
+} // namespace geodesk
@@ -0,0 +1,335 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/query/NearestQuery.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <geodesk/feature/FeatureIterator.h>
+#include <geodesk/feature/FeatureStore.h>
+#include <geodesk/geom/Distance.h>
+#include <geodesk/geom/Mercator.h>
+#include <geodesk/match/Matcher.h>
+#include <geodesk/query/TileIndexWalker.h>
+
+namespace geodesk {
+
+NearestQuery::NearestQuery(const View& view, Coordinate xy) :
+    view_(view),
+    xy_(xy),
+    bounds_(view.bounds()),
+    distance_(xy),
+    radius_(INITIAL_RADIUS)
+{
+}
+
+
+std::vector<std::pair<Feature,double>> NearestQuery::search(size_t k)
+{
+    std::vector<std::pair<Feature,double>> results;
+    if (k == 0) return results;
+    if (view_.view() == View::WORLD)
+    {
+        searchWorld(k, results);
+    }
+    else if (view_.view() != View::EMPTY)
+    {
+        searchGeneric(k, results);
+    }
+    return results;
+}
+
+
+double NearestQuery::metersFromSquared(double distanceSquared) const
+{
+    return std::sqrt(distanceSquared) * Mercator::metersPerUnitAtY(xy_.y);
+}
+
+
+void NearestQuery::searchGeneric(size_t k, std::vector<std::pair<Feature,double>>& results)
+{
+    FeatureStore* store = view_.store();
+    std::vector<Feature> features;
+    std::vector<std::pair<double,size_t>> distances;
+        // (Feature is not assignable, so we sort indexes instead)
+    FeatureIterator<Feature> iter(view_);
+    while (iter != nullptr)
+    {
+        Feature f = *iter;
+        double d;
+        if (f.isAnonymousNode())
+        {
+            Coordinate c = f.xy();
+            d = Distance::pointsSquared(c.x, c.y, xy_.x, xy_.y);
+        }
+        else
+        {
+            d = distance_.toFeatureSquared(store, f.ptr());
+        }
+        distances.emplace_back(d, features.size());
+        features.push_back(f);
+        ++iter;
+    }
+    size_t n = std::min(k, distances.size());
+    std::partial_sort(distances.begin(),
+        distances.begin() + static_cast<ptrdiff_t>(n), distances.end());
+    results.reserve(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        results.emplace_back(features[distances[i].second],
+            metersFromSquared(distances[i].first));
+    }
+}
+
+
+void NearestQuery::searchWorld(size_t k, std::vector<std::pair<Feature,double>>& results)
+{
+    FeatureStore* store = view_.store();
+    const Filter* filter = view_.filter();
+    queueTiles();
+    while (!queue_.empty())
+    {
+        Entry entry = queue_.top();
+        queue_.pop();
+        switch (entry.type)
+        {
+        case EXPAND:
+            radius_ *= 2;
+            queueTiles();
+            break;
+        case TILE:
+            openTile(entry);
+            break;
+        case ROOT:
+        case BRANCH:
+            openBranch(entry);
+            break;
+        case LEAF:
+            if (entry.indexType == FeatureIndexType::NODES)
+            {
+                openNodeLeaf(entry);
+            }
+            else
+            {
+                openLeaf(entry);
+            }
+            break;
+        case CANDIDATE:
+        {
+            FeaturePtr feature(entry.p);
+            if (filter && !filter->accept(store, feature,
+                FastFilterHint(entry.turboFlags, entry.tile)))
+            {
+                break;
+            }
+            entry.distanceSquared = distance_.toFeatureSquared(store, feature);
+            entry.type = MEASURED;
+            queue_.push(entry);
+            break;
+        }
+        case MEASURED:
+            results.emplace_back(Feature(store, FeaturePtr(entry.p)),
+                metersFromSquared(entry.distanceSquared));
+            if (results.size() == k) return;
+            break;
+        }
+    }
+}
+
+
+static int32_t clampToInt32(int64_t v)
+{
+    return static_cast<int32_t>(std::clamp<int64_t>(v,
+        std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+}
+
+
+/**
+ * Queues the tiles that intersect both the view's bounds and the
+ * square of the current radius around the point (skipping any tiles
+ * that were queued for a smaller square, and those rejected by the
+ * filter). Unless the square covers the view's bounds entirely, also
+ * queues an EXPAND marker at the distance of the square's edge: Any
+ * tile that hasn't been queued lies outside the square, so it can't
+ * be closer than that. Tiles are only fetched once they reach the
+ * front of the queue.
+ */
+void NearestQuery::queueTiles()
+{
+    Box square(
+        clampToInt32(xy_.x - radius_), clampToInt32(xy_.y - radius_),
+        clampToInt32(xy_.x + radius_), clampToInt32(xy_.y + radius_));
+    if (square.intersects(bounds_))
+    {
+        FeatureStore* store = view_.store();
+        TileIndexWalker walker(store->tileIndex(), store->zoomLevels(),
+            Box::simpleIntersection(square, bounds_), view_.filter());
+        while (walker.next())
+        {
+            if (!queuedTiles_.insert(walker.currentTip()).second) continue;
+            Entry entry;
+            entry.tile = walker.currentTile();
+            entry.distanceSquared = distance_.toBoxSquared(entry.tile.bounds());
+            entry.p = nullptr;
+            entry.tip = walker.currentTip();
+            entry.turboFlags = walker.turboFlags();
+            entry.type = TILE;
+            queue_.push(entry);
+        }
+    }
+    if (!square.containsSimple(bounds_))
+    {
+        Entry entry;
+        entry.distanceSquared = static_cast<double>(radius_) * static_cast<double>(radius_);
+        entry.p = nullptr;
+        entry.type = EXPAND;
+        queue_.push(entry);
+    }
+}
+
+
+void NearestQuery::openTile(const Entry& entry)
+{
+    DataPtr pTile = view_.store()->fetchTile(entry.tip);
+    FeatureTypes types = view_.types();
+    if (types & FeatureTypes::NODES) queueRoots(pTile, entry, FeatureIndexType::NODES);
+    if (types & FeatureTypes::NONAREA_WAYS) queueRoots(pTile, entry, FeatureIndexType::WAYS);
+    if (types & FeatureTypes::AREAS) queueRoots(pTile, entry, FeatureIndexType::AREAS);
+    if (types & FeatureTypes::NONAREA_RELATIONS) queueRoots(pTile, entry, FeatureIndexType::RELATIONS);
+}
+
+
+void NearestQuery::queueRoots(DataPtr pTile, const Entry& tileEntry, FeatureIndexType indexType)
+{
+    Entry entry = tileEntry;
+    entry.indexType = indexType;
+    DataPtr ppRoot = pTile + 8 + indexType * 4;
+    int32_t ptr = ppRoot.getInt();
+    if (ptr == 0) return;
+    if ((ptr & 1) == 0)
+    {
+        queueChild(ppRoot, entry);
+        return;
+    }
+
+    const MatcherHolder* matcher = view_.matcher();
+    DataPtr p = ppRoot + (ptr ^ 1);
+    for (;;)
+    {
+        int32_t last = p.getInt() & 1;
+        int32_t keys = (p+4).getInt();
+        if (matcher->acceptIndex(indexType, keys))
+        {
+            queueChild(p, entry);
+        }
+        if (last != 0) break;
+        p += 8;
+    }
+}
+
+
+/**
+ * Queues the root of an index tree. Its bounding box is unknown,
+ * so it inherits the distance of its tile.
+ */
+void NearestQuery::queueChild(DataPtr ppChild, const Entry& parent)
+{
+    int32_t ptr = ppChild.getInt();
+    if (ptr == 0) return;
+    Entry entry = parent;
+    entry.p = (ppChild + (ptr & 0xffff'fffc)).ptr();
+    entry.type = (ptr & 2) ? LEAF : ROOT;
+    queue_.push(entry);
+}
+
+
+void NearestQuery::openBranch(const Entry& parent)
+{
+    DataPtr p(parent.p);
+    for (;;)
+    {
+        int32_t ptr = p.getInt();
+        int32_t last = ptr & 1;
+        const Box& childBounds = *reinterpret_cast<const Box*>(p.ptr() + 4);
+        if (bounds_.intersects(childBounds))
+        {
+            Entry entry = parent;
+            entry.distanceSquared = std::max(parent.distanceSquared,
+                distance_.toBoxSquared(childBounds));
+            entry.p = (p + (ptr & 0xffff'fffc)).ptr();
+            entry.type = (ptr & 2) ? LEAF : BRANCH;
+            queue_.push(entry);
+        }
+        if (last != 0) break;
+        p += 20;
+    }
+}
+
+
+void NearestQuery::openNodeLeaf(const Entry& parent)
+{
+    FeatureTypes acceptedTypes = view_.types();
+    const Matcher& matcher = view_.matcher()->mainMatcher();
+    DataPtr p(parent.p);
+    for (;;)
+    {
+        int32_t flags = (p+8).getInt();
+        int32_t x = p.getInt();
+        int32_t y = (p+4).getInt();
+        if (bounds_.contains(x, y) && acceptedTypes.acceptFlags(flags))
+        {
+            FeaturePtr node(p + 8);
+            if (matcher.accept(node))
+            {
+                queueCandidate(node, distance_.toNodeSquared(NodePtr(node)), parent);
+            }
+        }
+        if (flags & 1) break;
+        p += 20 + (flags & 4);
+    }
+}
+
+
+void NearestQuery::openLeaf(const Entry& parent)
+{
+    FeatureTypes acceptedTypes = view_.types();
+    const Matcher& matcher = view_.matcher()->mainMatcher();
+    DataPtr p(parent.p);
+    for (;;)
+    {
+        int32_t flags = (p+16).getInt();
+        const Box& featureBounds = *reinterpret_cast<const Box*>(p.ptr());
+        if (bounds_.intersects(featureBounds) && acceptedTypes.acceptFlags(flags))
+        {
+            FeaturePtr feature(p + 16);
+            if (matcher.accept(feature))
+            {
+                // Don't combine with the distance of the parent: the
+                // feature may extend into a closer tile
+                queueCandidate(feature, distance_.toBoxSquared(featureBounds), parent);
+            }
+        }
+        if (flags & 1) break;
+        p += 32;
+    }
+}
+
+
+void NearestQuery::queueCandidate(FeaturePtr feature, double distanceSquared, const Entry& parent)
+{
+    // A way or relation that spans tiles is stored in each of them;
+    // since its distance does not depend on the tile, we only need to
+    // queue it once (nodes always live in a single tile)
+    if (!feature.isNode())
+    {
+        if (!seen_.insert(feature.typedId()).second) return;
+    }
+    Entry entry = parent;
+    entry.distanceSquared = distanceSquared;
+    entry.p = feature.ptr().ptr();
+    entry.type = CANDIDATE;
+    queue_.push(entry);
+}
+
+
+} // namespace geodesk
@@ -0,0 +1,207 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/query/PointLocator.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <clarisma/thread/Threads.h>
+#include <geodesk/feature/FeatureIterator.h>
+#include <geodesk/feature/FeatureStore.h>
+#include <geodesk/geom/index/HilbertTreeBuilder.h>
+#include <geodesk/geom/index/MCIndexBuilder.h>
+#include <geodesk/geom/index/hilbert.h>
+
+namespace geodesk {
+
+using namespace clarisma;
+
+PointLocator::PointLocator(const View& view)
+{
+    FeatureIterator<Feature> iter(view);
+    while (iter != nullptr)
+    {
+        Feature f = *iter;
+        if (f.isArea()) areas_.push_back(f);
+        ++iter;
+    }
+
+    // Sort areas by the size of their bounding boxes, so each point's
+    // areas are listed from largest (e.g. country) to smallest
+    // (Feature is not assignable, so we sort indexes instead)
+    std::vector<std::pair<double,uint32_t>> sizes;
+    sizes.reserve(areas_.size());
+    for (uint32_t i = 0; i < areas_.size(); i++)
+    {
+        sizes.emplace_back(-areas_[i].bounds().area(), i);
+    }
+    std::sort(sizes.begin(), sizes.end());
+    std::vector<Feature> sorted;
+    sorted.reserve(areas_.size());
+    for (const auto& [size, i] : sizes) sorted.push_back(areas_[i]);
+    areas_.swap(sorted);
+
+    buildIndexes();
+    buildTree();
+}
+
+
+/**
+ * Builds the MCIndex of each area (unless it is already cached),
+ * using as many threads as there are cores.
+ */
+void PointLocator::buildIndexes()
+{
+    indexes_.resize(areas_.size());
+    for (uint32_t n = 0; n < areas_.size(); n++)
+    {
+        Area& entry = indexes_[n];
+        entry.number = n;
+        double level = areas_[n]["admin_level"];
+        entry.adminLevel = (level >= 1 && level <= 63) ? static_cast<int>(level) : 0;
+            // (NaN if the tag is missing or not a number)
+    }
+
+    std::atomic<size_t> next = 0;
+    auto build = [this, &next](size_t)
+    {
+        for (;;)
+        {
+            size_t n = next++;
+            if (n >= areas_.size()) break;
+            const Feature& area = areas_[n];
+            FeatureStore* store = area.store();
+            Area& entry = indexes_[n];
+            entry.index = store->indexCache().get(area.ptr().typedId());
+            if (entry.index) continue;
+
+            MCIndexBuilder builder;
+            if (area.isWay())
+            {
+                builder.segmentizeWay(WayPtr(area.ptr()));
+            }
+            else
+            {
+                builder.segmentizeAreaRelation(store, RelationPtr(area.ptr()));
+            }
+            if (builder.isEmpty()) continue;
+            size_t size = builder.estimatedIndexSize();
+            entry.index = std::make_shared<const MCIndex>(builder.build(area.bounds()));
+            store->indexCache().put(area.ptr().typedId(), entry.index, size);
+        }
+    };
+
+    Threads::runInParallel(std::min<size_t>(
+        std::thread::hardware_concurrency(), areas_.size()), build);
+}
+
+
+void PointLocator::buildTree()
+{
+    std::vector<BoundedItem> items;
+    Box totalBounds;
+    for (const Area& entry : indexes_)
+    {
+        if (!entry.index) continue;     // empty area
+        Box bounds = areas_[entry.number].bounds();
+        items.push_back({ bounds, const_cast<Area*>(&entry) });
+        totalBounds.expandToIncludeSimple(bounds);
+    }
+    if (items.empty()) return;
+    HilbertTreeBuilder builder(&arena_);
+    tree_ = builder.build<const Area>(items.data(), items.size(), 8, totalBounds);
+}
+
+
+bool PointLocator::containsPoint(const RTree<const Area>::Node* node, PointQuery* query)
+{
+    const Area* area = node->item();
+    if (area->index->containsPoint(query->point))
+    {
+        query->found->push_back(area->number);
+    }
+    return false;   // keep going
+}
+
+
+/**
+ * Given the numbers of the areas that contain a point (sorted from
+ * largest to smallest), removes all but the smallest area of each
+ * admin level.
+ */
+void PointLocator::keepSmallestPerLevel(std::vector<uint32_t>& found) const
+{
+    uint64_t seenLevels = 0;
+    size_t kept = found.size();
+    for (size_t i = found.size(); i > 0; i--)
+    {
+        uint32_t n = found[i - 1];
+        int level = indexes_[n].adminLevel;
+        if (level != 0)
+        {
+            uint64_t bit = uint64_t{1} << level;
+            if (seenLevels & bit) continue;
+            seenLevels |= bit;
+        }
+        found[--kept] = n;
+    }
+    found.erase(found.begin(), found.begin() + kept);
+}
+
+
+std::vector<std::vector<uint32_t>> PointLocator::locate(
+    std::span<const Coordinate> points) const
+{
+    std::vector<std::vector<uint32_t>> results(points.size());
+    if (points.empty() || tree_.root() == nullptr) return results;
+
+    // Sort the points along the Hilbert curve
+
+    Box bounds;
+    for (Coordinate c : points) bounds.expandToInclude(c);
+    if (bounds.widthSimple() == 0)
+    {
+        bounds.expandToIncludeX(bounds.minX() == std::numeric_limits<int32_t>::max() ?
+            bounds.minX() - 1 : bounds.minX() + 1);
+    }
+    if (bounds.height() == 0)
+    {
+        int32_t y = bounds.minY() == std::numeric_limits<int32_t>::max() ?
+            bounds.minY() - 1 : bounds.minY() + 1;
+        bounds.expandToInclude(Coordinate(bounds.minX(), y));
+    }
+    std::vector<std::pair<uint32_t,uint32_t>> order;
+    order.reserve(points.size());
+    for (uint32_t i = 0; i < points.size(); i++)
+    {
+        order.emplace_back(hilbert::calculateHilbertDistance(points[i], bounds), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    // Resolve contiguous ranges of sorted points in parallel; each
+    // result is written by exactly one thread
+
+    auto resolve = [this, &points, &order, &results](size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; i++)
+        {
+            uint32_t n = order[i].second;
+            PointQuery query{ points[n], &results[n] };
+            tree_.search(Box(query.point), containsPoint, &query);
+            std::sort(results[n].begin(), results[n].end());
+                // area numbers are ordered by size
+            keepSmallestPerLevel(results[n]);
+        }
+    };
+
+    size_t threadCount = std::max<size_t>(1, std::min<size_t>(
+        std::thread::hardware_concurrency(), points.size() / MIN_POINTS_PER_THREAD));
+    Threads::runInParallel(threadCount, [&points, &resolve, threadCount](size_t i)
+    {
+        resolve(points.size() * i / threadCount, points.size() * (i + 1) / threadCount);
+    });
+    return results;
+}
+
+} // namespace geodesk
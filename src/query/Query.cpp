@@ -2,7 +2,10 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/query/Query.h>
+#include <algorithm>
+#include <limits>
 #include <clarisma/util/log.h>
+#include <geodesk/geom/index/hilbert.h>
 #include <geodesk/query/TileQueryTask.h>
 
 namespace geodesk {
@@ -11,7 +14,7 @@ namespace geodesk {
 
 
 Query::Query(FeatureStore* store, const Box& box, FeatureTypes types,
-    const MatcherHolder* matcher, const Filter* filter) :
+    const MatcherHolder* matcher, const Filter* filter, bool hilbertOrdered) :
     AbstractQuery(store),
     types_(types),
     matcher_(matcher),
@@ -20,6 +23,9 @@ Query::Query(FeatureStore* store, const Box& box, FeatureTypes types,
     currentResults_(QueryResults::EMPTY),
     currentPos_(QueryResults::EMPTY->count),
     allTilesRequested_(false),
+    hilbertOrdered_(hilbertOrdered),
+    nextHilbertTile_(0),
+    firstIncompleteTile_(0),
     tileIndexWalker_(store->tileIndex(), store->zoomLevels(), box, filter),
     queuedResults_(QueryResults::EMPTY),
     completedTiles_(0)
@@ -33,6 +39,7 @@ Query::Query(FeatureStore* store, const Box& box, FeatureTypes types,
                             // are guaranteed to be kept alive for duration of the
                             // query's lifetime
     */
+    if (hilbertOrdered_) collectHilbertTiles();
     requestTiles();
 }
 
@@ -83,6 +90,14 @@ void Query::offer(QueryResults* res)
     resultsReady_.notify_one();
 }
 
+void Query::offerSorted(SortedQueryResults&& res)
+{
+    std::unique_lock lock(mutex_);
+    sortedResults_.push_back(std::move(res));     // (even if empty, to track completion)
+    completedTiles_++;
+    resultsReady_.notify_one();
+}
+
 void Query::cancel()
 {
     std::unique_lock lock(mutex_);
@@ -139,16 +154,32 @@ void Query::requestTiles()
     int submitCount = std::max(store_->executor().minimumRemainingCapacity(), 1);
     while (submitCount > 0)
     {
-        if (!tileIndexWalker_.next())
+        if (hilbertOrdered_)
         {
-            allTilesRequested_ = true;
-            break;
+            if (nextHilbertTile_ == hilbertTiles_.size())
+            {
+                allTilesRequested_ = true;
+                break;
+            }
+            const HilbertTile& tile = hilbertTiles_[nextHilbertTile_];
+            TileQueryTask task(this, tile.tipAndFlags, tile.fastFilterHint,
+                static_cast<uint32_t>(nextHilbertTile_));
+            store_->executor().post(task);
+            nextHilbertTile_++;
+        }
+        else
+        {
+            if (!tileIndexWalker_.next())
+            {
+                allTilesRequested_ = true;
+                break;
+            }
+            TileQueryTask task(this,
+                (tileIndexWalker_.currentTip() << 8) |
+                tileIndexWalker_.northwestFlags(),
+                FastFilterHint(tileIndexWalker_.turboFlags(), tileIndexWalker_.currentTile()));
+            store_->executor().post(task);
         }
-        TileQueryTask task(this,
-            (tileIndexWalker_.currentTip() << 8) |
-            tileIndexWalker_.northwestFlags(),
-            FastFilterHint(tileIndexWalker_.turboFlags(), tileIndexWalker_.currentTile()));
-        store_->executor().post(task);
         pendingTiles_++;
         submitCount--;
     }
@@ -157,6 +188,7 @@ void Query::requestTiles()
 
 FeaturePtr Query::next()
 {
+    if (hilbertOrdered_) return nextInHilbertOrder();
     for (;;)
     {
         if (currentPos_ == currentResults_->count)
@@ -206,4 +238,126 @@ FeaturePtr Query::next()
 }
 
 
+/**
+ * Walks the tile index up front and orders the tiles by the lowest
+ * distance along the Hilbert curve of any feature they may contain.
+ * A feature is stored in every tile its bounding box intersects, but
+ * never spans more than 2x2 tiles, so its center lies within one tile
+ * extent of each of these tiles.
+ */
+void Query::collectHilbertTiles()
+{
+    Box world = Box::ofWorld();
+    while (tileIndexWalker_.next())
+    {
+        Tile tile = tileIndexWalker_.currentTile();
+        Box tileBounds = tile.bounds();
+        int64_t extent = 1LL << (32 - tile.zoom());
+        auto clamp = [](int64_t v)
+        {
+            return static_cast<int32_t>(std::clamp<int64_t>(v,
+                std::numeric_limits<int32_t>::min(),
+                std::numeric_limits<int32_t>::max()));
+        };
+        Box reach(
+            clamp(tileBounds.minX() - extent), clamp(tileBounds.minY() - extent),
+            clamp(tileBounds.maxX() + extent), clamp(tileBounds.maxY() + extent));
+        hilbertTiles_.push_back({
+            hilbert::lowestHilbertDistance(reach, world),
+            (tileIndexWalker_.currentTip() << 8) | tileIndexWalker_.northwestFlags(),
+            FastFilterHint(tileIndexWalker_.turboFlags(), tile) });
+    }
+    std::stable_sort(hilbertTiles_.begin(), hilbertTiles_.end(),
+        [](const HilbertTile& a, const HilbertTile& b)
+        {
+            return a.lowestDistance < b.lowestDistance;
+        });
+    tilesCompleted_.resize(hilbertTiles_.size());
+}
+
+/**
+ * Returns the lowest distance of any feature that has yet to be
+ * placed into the merge heap (or 2^32 if all tiles have completed).
+ */
+uint64_t Query::lowestPendingDistance() const
+{
+    return firstIncompleteTile_ == hilbertTiles_.size() ? (1ULL << 32) :
+        hilbertTiles_[firstIncompleteTile_].lowestDistance;
+}
+
+/**
+ * Waits for at least one tile to complete, and places the sorted
+ * results of all completed tiles into the merge heap.
+ */
+void Query::takeSorted()
+{
+    std::vector<SortedQueryResults> completed;
+    {
+        std::unique_lock lock(mutex_);
+        while (completedTiles_ == 0)
+        {
+            resultsReady_.wait(lock);
+        }
+        completed.swap(sortedResults_);
+        pendingTiles_ -= completedTiles_;
+        completedTiles_ = 0;
+    }
+    for (SortedQueryResults& res : completed)
+    {
+        tilesCompleted_[res.tileNumber] = true;
+        if (res.entries.empty()) continue;
+        mergeHeap_.push_back({ std::move(res.entries), 0, res.pTile });
+        std::push_heap(mergeHeap_.begin(), mergeHeap_.end());
+    }
+    while (firstIncompleteTile_ < hilbertTiles_.size() &&
+        tilesCompleted_[firstIncompleteTile_])
+    {
+        firstIncompleteTile_++;
+    }
+    if (!allTilesRequested_) requestTiles();
+}
+
+/**
+ * Returns the next feature from a k-way merge of the sorted
+ * results of the completed tiles. Since the tiles are requested in
+ * order of their lowest distance, features can be returned while
+ * the remaining tiles are still being searched.
+ */
+FeaturePtr Query::nextInHilbertOrder()
+{
+    for (;;)
+    {
+        if (mergeHeap_.empty() ||
+            (mergeHeap_.front().current() >> 32) >= lowestPendingDistance())
+        {
+            if (firstIncompleteTile_ == hilbertTiles_.size()) return nullptr;
+            takeSorted();
+            continue;
+        }
+
+        std::pop_heap(mergeHeap_.begin(), mergeHeap_.end());
+        MergeCursor& cursor = mergeHeap_.back();
+        uint32_t item = static_cast<uint32_t>(cursor.current());
+        DataPtr pTile = cursor.pTile;
+        if (++cursor.pos == cursor.entries.size())
+        {
+            mergeHeap_.pop_back();
+        }
+        else
+        {
+            std::push_heap(mergeHeap_.begin(), mergeHeap_.end());
+        }
+
+        if (item & REQUIRES_DEDUP)
+        {
+            FeaturePtr pFeature(pTile + (item & ~REQUIRES_DEDUP));
+            uint64_t idBits = pFeature.idBits();
+            if (potentialDupes_.count(idBits)) continue;
+            potentialDupes_.insert(idBits);
+            return pFeature;
+        }
+        return FeaturePtr(pTile + item);
+    }
+}
+
 } // namespace geodesk
@@ -0,0 +1,271 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/query/SpatialJoin.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <clarisma/thread/Threads.h>
+#include <geodesk/feature/FeatureIterator.h>
+#include <geodesk/feature/FeatureStore.h>
+#include <geodesk/filter/FeatureDistanceFilter.h>
+#include <geodesk/filter/IntersectsFilter.h>
+#include <geodesk/filter/WithinFilter.h>
+#include <geodesk/geom/Mercator.h>
+#include <geodesk/geom/index/HilbertTreeBuilder.h>
+#include <geodesk/geom/index/hilbert.h>
+
+namespace geodesk {
+
+using namespace clarisma;
+
+SpatialJoin::SpatialJoin(const View& left, const View& right,
+    Predicate predicate, double meters) :
+    left_(left),
+    right_(right),
+    predicate_(predicate),
+    meters_(meters)
+{
+}
+
+
+SpatialJoin::~SpatialJoin() = default;
+
+
+void SpatialJoin::FilterRelease::operator()(const Filter* filter) const
+{
+    filter->release();
+}
+
+
+std::vector<Feature> SpatialJoin::collect(const View& view)
+{
+    std::vector<Feature> features;
+    FeatureIterator<Feature> iter(view);
+    while (iter != nullptr)
+    {
+        Feature f = *iter;
+        if (!f.isAnonymousNode()) features.push_back(f);
+        ++iter;
+    }
+    return features;
+}
+
+
+static Box clampedBox(int64_t minX, int64_t minY, int64_t maxX, int64_t maxY)
+{
+    constexpr int64_t MIN = std::numeric_limits<int32_t>::min();
+    constexpr int64_t MAX = std::numeric_limits<int32_t>::max();
+    return Box(
+        static_cast<int32_t>(std::max(minX, MIN)),
+        static_cast<int32_t>(std::max(minY, MIN)),
+        static_cast<int32_t>(std::min(maxX, MAX)),
+        static_cast<int32_t>(std::min(maxY, MAX)));
+}
+
+
+void SpatialJoin::buildTree()
+{
+    size_t count = rightFeatures_.size();
+    candidates_.resize(count);
+    filtersPrepared_.reset(new std::once_flag[count]);
+    filters_.reset(new FilterPtr[count]);
+
+    std::vector<BoundedItem> items;
+    items.reserve(count);
+    Box totalBounds;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        candidates_[i].number = i;
+        Box bounds = rightFeatures_[i].bounds();
+        if (predicate_ == Predicate::MAX_DISTANCE)
+        {
+            // Use the scale at the edge closest to the pole, so the
+            // enlarged box covers the distance everywhere
+            double y = std::max(std::abs(static_cast<double>(bounds.minY())),
+                std::abs(static_cast<double>(bounds.maxY())));
+            int64_t d = static_cast<int64_t>(std::ceil(
+                Mercator::unitsFromMeters(meters_, y)));
+            bounds = clampedBox(
+                static_cast<int64_t>(bounds.minX()) - d,
+                static_cast<int64_t>(bounds.minY()) - d,
+                static_cast<int64_t>(bounds.maxX()) + d,
+                static_cast<int64_t>(bounds.maxY()) + d);
+        }
+        items.push_back({ bounds, &candidates_[i] });
+        totalBounds.expandToIncludeSimple(bounds);
+    }
+    if (items.empty()) return;
+    HilbertTreeBuilder builder(&arena_);
+    tree_ = builder.build<const Candidate>(items.data(), items.size(), 8, totalBounds);
+}
+
+
+std::vector<std::pair<Feature,Feature>> SpatialJoin::run()
+{
+    std::vector<std::pair<Feature,Feature>> results;
+    rightFeatures_ = collect(right_);
+    buildTree();
+    if (tree_.root() == nullptr) return results;
+
+    std::vector<Feature> leftFeatures = collect(left_);
+    if (leftFeatures.empty()) return results;
+
+    // Sort the left features along the Hilbert curve, by the centers
+    // of their bounding boxes (Feature is not assignable, so we sort
+    // indexes instead)
+
+    Box bounds;
+    std::vector<Coordinate> centers;
+    centers.reserve(leftFeatures.size());
+    for (const Feature& f : leftFeatures)
+    {
+        Box b = f.bounds();
+        Coordinate center(
+            static_cast<int32_t>((static_cast<int64_t>(b.minX()) + b.maxX()) / 2),
+            static_cast<int32_t>((static_cast<int64_t>(b.minY()) + b.maxY()) / 2));
+        centers.push_back(center);
+        bounds.expandToInclude(center);
+    }
+    bounds = clampedBox(bounds.minX(), bounds.minY(),
+        static_cast<int64_t>(bounds.maxX()) + 1, static_cast<int64_t>(bounds.maxY()) + 1);
+    if (bounds.widthSimple() == 0 || bounds.height() == 0)
+    {
+        bounds = clampedBox(static_cast<int64_t>(bounds.minX()) - 1,
+            static_cast<int64_t>(bounds.minY()) - 1, bounds.maxX(), bounds.maxY());
+    }
+    std::vector<std::pair<uint32_t,uint32_t>> order;
+    order.reserve(leftFeatures.size());
+    for (uint32_t i = 0; i < leftFeatures.size(); i++)
+    {
+        order.emplace_back(hilbert::calculateHilbertDistance(centers[i], bounds), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    // Probe contiguous ranges in parallel, each into its own results
+
+    size_t threadCount = std::max<size_t>(1, std::min<size_t>(
+        std::thread::hardware_concurrency(),
+        leftFeatures.size() / MIN_FEATURES_PER_THREAD));
+    std::vector<std::vector<std::pair<Feature,Feature>>> partialResults(threadCount);
+    auto probeRange = [this, &leftFeatures, &order, &partialResults, threadCount](size_t part)
+    {
+        size_t start = leftFeatures.size() * part / threadCount;
+        size_t end = leftFeatures.size() * (part + 1) / threadCount;
+        for (size_t i = start; i < end; i++)
+        {
+            probe(leftFeatures[order[i].second], partialResults[part]);
+        }
+    };
+    Threads::runInParallel(threadCount, probeRange);
+
+    size_t total = 0;
+    for (const auto& part : partialResults) total += part.size();
+    results.reserve(total);
+    for (auto& part : partialResults)
+    {
+        for (auto& pair : part) results.push_back(std::move(pair));
+    }
+    return results;
+}
+
+
+void SpatialJoin::probe(const Feature& left, std::vector<std::pair<Feature,Feature>>& results)
+{
+    Probe probe{ this, &left, left.bounds(), nullptr, &results };
+    tree_.search(probe.bounds, acceptCandidate, &probe);
+}
+
+
+bool SpatialJoin::acceptCandidate(const RTree<const Candidate>::Node* node, Probe* probe)
+{
+    SpatialJoin* join = probe->join;
+    uint32_t n = node->item()->number;
+    const Feature& right = join->rightFeatures_[n];
+    const Feature& left = *probe->left;
+
+    // Cheap bounding-box checks for the containment predicates
+    if (join->predicate_ == Predicate::WITHIN)
+    {
+        if (!right.bounds().containsSimple(probe->bounds)) return false;
+    }
+    else if (join->predicate_ == Predicate::CONTAINS)
+    {
+        if (!probe->bounds.containsSimple(right.bounds())) return false;
+    }
+
+    bool match;
+    switch (join->predicate_)
+    {
+    case Predicate::INTERSECTS:
+    case Predicate::MAX_DISTANCE:
+    {
+        const Filter* filter = join->rightFilter(n);
+        if (filter)
+        {
+            match = filter->accept(left.store(), left.ptr(), FastFilterHint());
+        }
+        else
+        {
+            // No prepared filter for the right feature (e.g. a non-area
+            // relation), so try the reverse (both predicates are symmetric)
+            if (!probe->leftFilter) probe->leftFilter.reset(join->prepareFilter(left));
+            match = probe->leftFilter && probe->leftFilter->accept(
+                right.store(), right.ptr(), FastFilterHint());
+        }
+        break;
+    }
+    case Predicate::WITHIN:
+    {
+        const Filter* filter = join->rightFilter(n);
+        match = filter && filter->accept(left.store(), left.ptr(), FastFilterHint());
+        break;
+    }
+    default:
+        assert(join->predicate_ == Predicate::CONTAINS);
+        if (!probe->leftFilter) probe->leftFilter.reset(join->prepareFilter(left));
+        match = probe->leftFilter && probe->leftFilter->accept(
+            right.store(), right.ptr(), FastFilterHint());
+        break;
+    }
+    if (match) probe->results->emplace_back(left, right);
+    return false;   // keep going
+}
+
+
+/**
+ * Returns the prepared filter of the given right-side feature,
+ * creating it if necessary.
+ */
+const Filter* SpatialJoin::rightFilter(uint32_t n)
+{
+    std::call_once(filtersPrepared_[n], [this, n]()
+    {
+        filters_[n].reset(prepareFilter(rightFeatures_[n]));
+    });
+    return filters_[n].get();
+}
+
+
+/**
+ * Creates a "within" filter (for WITHIN and CONTAINS), a "max distance"
+ * filter or an "intersects" filter for the given feature, or returns
+ * `nullptr` if its type of geometry isn't supported by the filter.
+ */
+const Filter* SpatialJoin::prepareFilter(const Feature& feature) const
+{
+    switch (predicate_)
+    {
+    case Predicate::WITHIN:
+    case Predicate::CONTAINS:
+        return WithinFilterFactory().forFeature(feature.store(), feature.ptr());
+    case Predicate::MAX_DISTANCE:
+        return MaxDistanceFilterFactory(meters_).forFeature(feature.store(), feature.ptr());
+    default:
+        return IntersectsFilterFactory().forFeature(feature.store(), feature.ptr());
+    }
+}
+
+} // namespace geodesk
@@ -0,0 +1,193 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <geodesk/query/TileKeySummaries.h>
+#include <algorithm>
+#include <geodesk/feature/types.h>
+
+namespace geodesk {
+
+uint32_t TileKeySummary::keysOf(DataPtr pTile, DataPtr pChild) const
+{
+    uint32_t ofs = static_cast<uint32_t>(pChild - pTile);
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), ofs,
+        [](const Entry& entry, uint32_t ofs) { return entry.first < ofs; });
+    return (it != entries_.end() && it->first == ofs) ? it->second : 0xffff'ffff;
+}
+
+
+void TileKeySummaries::setIndexedKeys(const IndexedKeyMap& keysToCategories)
+{
+    keyBits_.assign(FeatureConstants::MAX_COMMON_KEY + 2, 0);
+    for (const auto& [keyCode, category] : keysToCategories)
+    {
+        if (keyCode < keyBits_.size())
+        {
+            keyBits_[keyCode] = IndexBits::fromCategory(category);
+        }
+    }
+}
+
+
+SharedTileKeySummary TileKeySummaries::get(Tip tip, DataPtr pTile)
+{
+    {
+        std::lock_guard lock(mutex_);
+        auto it = map_.find(tip);
+        if (it != map_.end())
+        {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->summary;
+        }
+    }
+
+    // Build the summary without holding the lock; if another thread
+    // summarized the same tile in the meantime, we keep its version
+
+    auto summary = std::make_shared<TileKeySummary>();
+    summarizeIndex(pTile, pTile + 8, true, summary.get());
+    for (int i = FeatureIndexType::WAYS; i <= FeatureIndexType::RELATIONS; i++)
+    {
+        summarizeIndex(pTile, pTile + 8 + i * 4, false, summary.get());
+    }
+    std::sort(summary->entries_.begin(), summary->entries_.end());
+    summary->entries_.shrink_to_fit();
+    size_t size = summary->size();
+
+    std::lock_guard lock(mutex_);
+    auto it = map_.find(tip);
+    if (it != map_.end()) return it->second->summary;
+    if (size > maxBytes_) return summary;
+    entries_.push_front({ tip, summary, size });
+    map_[tip] = entries_.begin();
+    totalBytes_ += size;
+    evict();
+    return summary;
+}
+
+
+void TileKeySummaries::setMaxBytes(size_t maxBytes)
+{
+    std::lock_guard lock(mutex_);
+    maxBytes_ = maxBytes;
+    evict();
+}
+
+
+void TileKeySummaries::clear()
+{
+    std::lock_guard lock(mutex_);
+    entries_.clear();
+    map_.clear();
+    totalBytes_ = 0;
+}
+
+
+void TileKeySummaries::evict()
+{
+    while (totalBytes_ > maxBytes_)
+    {
+        const Entry& last = entries_.back();
+        totalBytes_ -= last.size;
+        map_.erase(last.tip);
+        entries_.pop_back();
+    }
+}
+
+
+void TileKeySummaries::summarizeIndex(DataPtr pTile, DataPtr ppRoot,
+    bool isNodeTree, TileKeySummary* summary) const
+{
+    // Same layout as walked by TileQueryTask::searchIndexes():
+    // either a single root, or a list of (root, keys) buckets
+
+    int32_t ptr = ppRoot.getInt();
+    if (ptr == 0) return;
+    if ((ptr & 1) == 0)
+    {
+        summarizeRoot(pTile, ppRoot, isNodeTree, summary);
+        return;
+    }
+    DataPtr p = ppRoot + (ptr ^ 1);
+    for (;;)
+    {
+        int32_t last = p.getInt() & 1;
+        summarizeRoot(pTile, p, isNodeTree, summary);
+        if (last != 0) break;
+        p += 8;
+    }
+}
+
+
+void TileKeySummaries::summarizeRoot(DataPtr pTile, DataPtr ppRoot,
+    bool isNodeTree, TileKeySummary* summary) const
+{
+    int32_t ptr = ppRoot.getInt();
+    if (ptr)
+    {
+        summarizeTree(pTile, ppRoot + (ptr & 0xffff'fffc), ptr & 2,
+            isNodeTree, summary);
+    }
+}
+
+
+uint32_t TileKeySummaries::summarizeTree(DataPtr pTile, DataPtr p,
+    bool isLeaf, bool isNodeTree, TileKeySummary* summary) const
+{
+    uint32_t keys = 0;
+    DataPtr pStart = p;
+    if (isLeaf)
+    {
+        if (isNodeTree)
+        {
+            for (;;)
+            {
+                int32_t flags = (p + 8).getInt();
+                keys |= keysOfFeature(p + 8);
+                if (flags & 1) break;
+                p += 20 + (flags & 4);
+            }
+        }
+        else
+        {
+            for (;;)
+            {
+                int32_t flags = (p + 16).getInt();
+                keys |= keysOfFeature(p + 16);
+                if (flags & 1) break;
+                p += 32;
+            }
+        }
+    }
+    else
+    {
+        for (;;)
+        {
+            int32_t ptr = p.getInt();
+            keys |= summarizeTree(pTile, p + (ptr & 0xffff'fffc),
+                ptr & 2, isNodeTree, summary);      // NOLINT recursion
+            if (ptr & 1) break;
+            p += 20;
+        }
+    }
+    summary->entries_.emplace_back(static_cast<uint32_t>(pStart - pTile), keys);
+    return keys;
+}
+
+
+uint32_t TileKeySummaries::keysOfFeature(DataPtr pFeature) const
+{
+    DataPtr ppTags = pFeature + 8;
+    DataPtr p = ppTags + (ppTags.getInt() & ~1);
+    uint32_t keys = 0;
+    for (;;)
+    {
+        uint16_t key = p.getUnsignedShort();
+        keys |= keyBits_[(key & 0x7ffc) >> 2];
+        if (key & 0x8000) break;
+        p += 4 + (key & 2);
+    }
+    return keys;
+}
+
+} // namespace geodesk
@@ -2,8 +2,12 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <geodesk/query/TileQueryTask.h>
+#include <algorithm>
+#include <clarisma/util/Bits.h>
 #include <geodesk/feature/FeaturePtr.h>
+#include <geodesk/feature/NodePtr.h>
 #include <geodesk/feature/types.h>
+#include <geodesk/geom/index/hilbert.h>
 #include <geodesk/query/Query.h>
 
 namespace geodesk {
@@ -23,6 +27,11 @@ void TileQueryTask::operator()()
 	Tip tip = Tip(tipAndFlags_ >> 8);
 	pTile_ = query_->store()->fetchTile(tip);
 	uint32_t types = query_->types();
+	TileKeySummaries& keySummaries = query_->store()->keySummaries();
+	if (keySummaries.isEnabled() && query_->matcher()->usesIndexedKeys())
+	{
+		keySummary_ = keySummaries.get(tip, pTile_);
+	}
 
 	// LOG("Scanning tile %06X", tip);
 
@@ -30,12 +39,31 @@ void TileQueryTask::operator()()
 	if (types & FeatureTypes::NONAREA_WAYS) searchIndexes(FeatureIndexType::WAYS);
 	if (types & FeatureTypes::AREAS) searchIndexes(FeatureIndexType::AREAS);
 	if (types & FeatureTypes::NONAREA_RELATIONS) searchIndexes(FeatureIndexType::RELATIONS);
-	query_->offer(results_);
+	if (query_->isHilbertOrdered())
+	{
+		query_->offerSorted(sortResults());
+	}
+	else
+	{
+		query_->offer(results_);
+	}
+}
+
+/**
+ * Checks whether a branch or leaf may contain features with any of
+ * the indexed keys required by the matcher (always true if key
+ * summaries are not in use).
+ */
+bool TileQueryTask::acceptKeys(DataPtr pChild) const
+{
+	return keySummary_ == nullptr || query_->matcher()->acceptIndex(
+		indexType_, keySummary_->keysOf(pTile_, pChild));
 }
 
 void TileQueryTask::searchNodeIndexes()
 {
 	const MatcherHolder* matcher = query_->matcher();
+	indexType_ = FeatureIndexType::NODES;
 	DataPtr ppRoot = pTile_ + 8;
 	int32_t ptr = ppRoot.getInt();
 	if (ptr == 0) return;
@@ -63,9 +91,10 @@ void TileQueryTask::searchNodeIndexes()
 void TileQueryTask::searchNodeRoot(DataPtr ppRoot)
 {
 	int32_t ptr = ppRoot.getInt();
-	if (ptr)
+	if (ptr == 0) return;
+	DataPtr p = ppRoot + (ptr & 0xffff'fffc);
+	if (acceptKeys(p))
 	{
-		DataPtr p = ppRoot + (ptr & 0xffff'fffc);
 		if (ptr & 2)
 		{
 			searchNodeLeaf(p);
@@ -85,9 +114,10 @@ void TileQueryTask::searchNodeBranch(DataPtr p)
 	{
 		int32_t ptr = p.getInt();
 		int32_t last = ptr & 1;
-		if (box.intersects(*reinterpret_cast<const Box*>((const uint8_t *)p + 4)))
+		DataPtr pChild = p + (ptr & 0xffff'fffc);
+		if (box.intersects(*reinterpret_cast<const Box*>((const uint8_t *)p + 4)) &&
+			acceptKeys(pChild))
 		{
-			DataPtr pChild = p + (ptr & 0xffff'fffc);
 			if (ptr & 2)
 			{
 				searchNodeLeaf(pChild);
@@ -107,7 +137,8 @@ void TileQueryTask::searchNodeLeaf(DataPtr p)
 	// LOG("Searching leaf at %016X", p);
 	Box box = query_->bounds();
 	FeatureTypes acceptedTypes = query_->types();
-	const Matcher& matcher = query_->matcher()->mainMatcher();
+	FeaturePtr candidates[Matcher::MAX_BATCH_SIZE];
+	int candidateCount = 0;
 
 	for (;;)
 	{
@@ -116,16 +147,11 @@ void TileQueryTask::searchNodeLeaf(DataPtr p)
 		{
 			if (acceptedTypes.acceptFlags(flags))
 			{
-				FeaturePtr pFeature(p + 8);
-				if (matcher.accept(pFeature))
+				candidates[candidateCount++] = FeaturePtr(p + 8);
+				if (candidateCount == Matcher::MAX_BATCH_SIZE)
 				{
-					const Filter* filter = query_->filter();
-					if (filter == nullptr || filter->accept(query_->store(),
-						pFeature, fastFilterHint_))
-					{
-						// LOG("Found node/%llu", Feature::id(pFeature));
-						addResult(static_cast<uint32_t>(pFeature.ptr() - pTile_));
-					}
+					acceptCandidates(candidates, nullptr, candidateCount);
+					candidateCount = 0;
 				}
 			}
 		}
@@ -134,6 +160,7 @@ void TileQueryTask::searchNodeLeaf(DataPtr p)
 		// If Node is member of relation (flag bit 2), add
 		// extra 4 bytes for the relation table pointer
 	}
+	if (candidateCount) acceptCandidates(candidates, nullptr, candidateCount);
 }
 
 
@@ -141,6 +168,7 @@ void TileQueryTask::searchNodeLeaf(DataPtr p)
 void TileQueryTask::searchIndexes(FeatureIndexType indexType)
 {
 	const MatcherHolder* matcher = query_->matcher();
+	indexType_ = indexType;
 	DataPtr ppRoot = pTile_ + 8 + indexType * 4;
 	int32_t ptr = ppRoot.getInt();
 	if (ptr == 0) return;
@@ -169,9 +197,10 @@ void TileQueryTask::searchIndexes(FeatureIndexType indexType)
 void TileQueryTask::searchRoot(DataPtr ppRoot)
 {
 	int32_t ptr = ppRoot.getInt();
-	if (ptr)
+	if (ptr == 0) return;
+	DataPtr p = ppRoot + (ptr & 0xffff'fffc);
+	if (acceptKeys(p))
 	{
-		DataPtr p = ppRoot + (ptr & 0xffff'fffc);
 		if (ptr & 2)
 		{
 			searchLeaf(p);
@@ -190,9 +219,10 @@ void TileQueryTask::searchBranch(DataPtr p)
 	{
 		int32_t ptr = p.getInt();
 		int32_t last = ptr & 1;
-		if (box.intersects(*reinterpret_cast<const Box*>((const uint8_t*)p + 4)))
+		DataPtr pChild = p + (ptr & 0xffff'fffc);
+		if (box.intersects(*reinterpret_cast<const Box*>((const uint8_t*)p + 4)) &&
+			acceptKeys(pChild))
 		{
-			DataPtr pChild = p + (ptr & 0xffff'fffc);
 			if (ptr & 2)
 			{
 				searchLeaf(pChild);
@@ -212,7 +242,9 @@ void TileQueryTask::searchLeaf(DataPtr p)
 {
 	Box box = query_->bounds();
 	FeatureTypes acceptedTypes = query_->types();
-	const Matcher& matcher = query_->matcher()->mainMatcher();
+	FeaturePtr candidates[Matcher::MAX_BATCH_SIZE];
+	uint32_t candidateDupeFlags[Matcher::MAX_BATCH_SIZE];
+	int candidateCount = 0;
 
 	for (;;)
 	{
@@ -259,16 +291,12 @@ void TileQueryTask::searchLeaf(DataPtr p)
 
 				if (acceptedTypes.acceptFlags(flags))
 				{
-					FeaturePtr pFeature (p + 16);
-					if (matcher.accept(pFeature))
+					candidates[candidateCount] = FeaturePtr(p + 16);
+					candidateDupeFlags[candidateCount++] = dupeFlag;
+					if (candidateCount == Matcher::MAX_BATCH_SIZE)
 					{
-						const Filter* filter = query_->filter();
-						if (filter == nullptr || filter->accept(query_->store(), 
-							pFeature, fastFilterHint_))
-						{
-							// LOG("Found %s/%llu", Feature::typeName(pFeature), Feature::id(pFeature));
-							addResult(static_cast<uint32_t>(pFeature.ptr() - pTile_) | dupeFlag);	// TODO
-						}
+						acceptCandidates(candidates, candidateDupeFlags, candidateCount);
+						candidateCount = 0;
 					}
 				}
 			}
@@ -277,7 +305,41 @@ void TileQueryTask::searchLeaf(DataPtr p)
 		if (flags & 1) break;
 		p += 32;
 	}
+	if (candidateCount)
+	{
+		acceptCandidates(candidates, candidateDupeFlags, candidateCount);
+	}
+}
 
+/**
+ * Runs the matcher over a batch of candidates (which have already
+ * passed the bbox and type checks), then applies the filter (if any)
+ * to each accepted candidate and adds the survivors to the results.
+ * 
+ * @param candidates  the candidate features (at most Matcher::MAX_BATCH_SIZE)
+ * @param dupeFlags   the REQUIRES_DEDUP flag for each candidate,
+ *                    or nullptr if none requires deduplication
+ * @param count       the number of candidates
+ */
+void TileQueryTask::acceptCandidates(const FeaturePtr* candidates,
+	const uint32_t* dupeFlags, int count)
+{
+	const Matcher& matcher = query_->matcher()->mainMatcher();
+	const Filter* filter = query_->filter();
+	uint64_t accepted = matcher.acceptBatch(candidates, count);
+	while (accepted)
+	{
+		int i = clarisma::Bits::countTrailingZerosInNonZero(accepted);
+		accepted &= accepted - 1;
+		FeaturePtr pFeature = candidates[i];
+		if (filter == nullptr || filter->accept(query_->store(),
+			pFeature, fastFilterHint_))
+		{
+			// LOG("Found %s/%llu", Feature::typeName(pFeature), Feature::id(pFeature));
+			addResult(static_cast<uint32_t>(pFeature.ptr() - pTile_) |
+				(dupeFlags ? dupeFlags[i] : 0));
+		}
+	}
 }
 
 /**
@@ -301,5 +363,52 @@ void TileQueryTask::addResult(uint32_t item)
 	results_->items[results_->count++] = item;
 }
 
+/**
+ * Turns the results of this tile into a single run, sorted by the
+ * distance along the Hilbert curve (across the entire world) of
+ * each feature's center (or location, for nodes), and frees the
+ * buckets. The distances are calculated here, so the consumer
+ * only has to merge the sorted runs of all tiles.
+ */
+SortedQueryResults TileQueryTask::sortResults()
+{
+	SortedQueryResults sorted;
+	sorted.pTile = pTile_;
+	sorted.tileNumber = tileNumber_;
+	if (results_ == QueryResults::EMPTY) return sorted;
+
+	size_t count = 0;
+	QueryResults* res = results_;
+	do
+	{
+		count += res->count;
+		res = res->next;
+	}
+	while (res != results_);
+	sorted.entries.reserve(count);
+
+	Box world = Box::ofWorld();
+	res = results_->next;		// the first bucket
+	for (;;)
+	{
+		for (uint32_t i = 0; i < res->count; i++)
+		{
+			uint32_t item = res->items[i];
+			FeaturePtr pFeature(pTile_ + (item & ~Query::REQUIRES_DEDUP));
+			Coordinate center = pFeature.isNode() ?
+				NodePtr(pFeature).xy() : pFeature.bounds().center();
+			uint64_t distance = hilbert::calculateHilbertDistance(center, world);
+			sorted.entries.push_back((distance << 32) | item);
+		}
+		QueryResults* next = res->next;
+		bool isLast = (res == results_);
+		delete res;
+		if (isLast) break;
+		res = next;
+	}
+	results_ = QueryResults::EMPTY;
+	std::sort(sorted.entries.begin(), sorted.entries.end());
+	return sorted;
+}
 
 } // namespace geodesk
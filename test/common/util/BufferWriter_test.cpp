@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <random>
+#include <string>
+#include "clarisma/math/Math.h"
+#include "clarisma/util/StringBuilder.h"
+
+using namespace clarisma;
+
+static std::string fixed(int64_t scaled, int precision, bool zeroFill = false)
+{
+	StringBuilder s;
+	s.formatFixed(scaled, precision, zeroFill);
+	return s.toString();
+}
+
+static std::string dbl(double d, int precision, bool zeroFill = false)
+{
+	StringBuilder s;
+	s.formatDouble(d, precision, zeroFill);
+	return s.toString();
+}
+
+TEST_CASE("BufferWriter::formatFixed")
+{
+	REQUIRE(fixed(0, 0) == "0");
+	REQUIRE(fixed(0, 7) == "0");
+	REQUIRE(fixed(0, 3, true) == "0.000");
+	REQUIRE(fixed(1, 7) == "0.0000001");
+	REQUIRE(fixed(-1, 7) == "-0.0000001");
+	REQUIRE(fixed(-5, 1) == "-0.5");
+	REQUIRE(fixed(12345, 2) == "123.45");
+	REQUIRE(fixed(-12345, 2) == "-123.45");
+	REQUIRE(fixed(1230, 3) == "1.23");
+	REQUIRE(fixed(1230, 3, true) == "1.230");
+	REQUIRE(fixed(-10'000'000, 7) == "-1");
+	REQUIRE(fixed(1'800'000'000, 7) == "180");
+	REQUIRE(fixed(-1'799'999'999, 7) == "-179.9999999");
+	REQUIRE(fixed(-42, 0) == "-42");
+}
+
+TEST_CASE("BufferWriter::formatFixed matches formatDouble")
+{
+	std::mt19937 rng(48);
+	std::uniform_real_distribution<double> degrees(-180, 180);
+	std::uniform_real_distribution<double> small(-1e-6, 1e-6);
+	for (int precision = 0; precision <= 7; precision++)
+	{
+		double multiplier = Math::POWERS_OF_10[precision];
+		for (int i = 0; i < 10000; i++)
+		{
+			double d = (i % 4 == 0) ? small(rng) : degrees(rng);
+			int64_t scaled = static_cast<int64_t>(std::round(d * multiplier));
+			for (bool zeroFill : { false, true })
+			{
+				std::string expected = dbl(d, precision, zeroFill);
+				CAPTURE(d, precision, zeroFill);
+				if (scaled == 0 && d < 0)
+				{
+					// formatDouble() keeps the sign of a negative value
+					// that rounds to zero; formatFixed() can't (and
+					// shouldn't) tell it apart from a positive one
+					REQUIRE(expected.substr(0, 2) == "-0");
+					REQUIRE(fixed(scaled, precision, zeroFill) == expected.substr(1));
+				}
+				else
+				{
+					REQUIRE(fixed(scaled, precision, zeroFill) == expected);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+#include <clarisma/util/varint.h>
+#include <geodesk/feature/CoordinateDecoder.h>
+
+using namespace geodesk;
+using namespace clarisma;
+
+using Impl = CoordinateDecoder::Implementation;
+
+// Encodes the coordinates as deltas to their predecessors (the first
+// to `prev`), the way they are stored in a way's body
+static std::vector<uint8_t> encode(Coordinate prev, const std::vector<Coordinate>& coords)
+{
+	std::vector<uint8_t> buf(coords.size() * 10);
+	uint8_t* p = buf.data();
+	for (Coordinate c : coords)
+	{
+		writeSignedVarint(p, static_cast<int64_t>(c.x) - prev.x);
+		writeSignedVarint(p, static_cast<int64_t>(c.y) - prev.y);
+		prev = c;
+	}
+	// Trim the buffer, so reads past the end can be caught by
+	// sanitizers
+	buf.resize(p - buf.data());
+	buf.shrink_to_fit();
+	return buf;
+}
+
+
+// Produces deltas of up to `range` units in either direction;
+// deltas below 2^20 fit into the 3-byte varints of the vector path
+static std::vector<Coordinate> randomCoordinates(std::mt19937& rng,
+	Coordinate start, size_t count, int32_t range)
+{
+	std::uniform_int_distribution<int32_t> dist(-range, range);
+	std::vector<Coordinate> coords(count);
+	Coordinate c = start;
+	for (Coordinate& out : coords)
+	{
+		c = Coordinate(c.x + dist(rng), c.y + dist(rng));
+		out = c;
+	}
+	return coords;
+}
+
+
+static std::vector<Coordinate> decode(Impl impl, const std::vector<uint8_t>& encoded,
+	Coordinate prev, size_t count)
+{
+	REQUIRE(CoordinateDecoder::select(impl));
+	std::vector<Coordinate> out(count);
+	const uint8_t* end = CoordinateDecoder::decode(
+		encoded.data(), count, prev, out.data());
+	REQUIRE(end == encoded.data() + encoded.size());
+	return out;
+}
+
+
+static bool isSsse3Supported()
+{
+	Impl original = CoordinateDecoder::implementation();
+	bool supported = CoordinateDecoder::select(Impl::SSSE3);
+	CoordinateDecoder::select(original);
+	return supported;
+}
+
+
+TEST_CASE("CoordinateDecoder round-trips encoded coordinates")
+{
+	if (!isSsse3Supported()) return;
+	Impl original = CoordinateDecoder::implementation();
+	std::mt19937 rng(17);
+	Coordinate start(1000000, -2000000);
+	// Each iteration of the vector loop consumes 2 coordinates, and it
+	// only runs while 8 or more remain; the other counts cover the tail
+	for (int32_t range : { 1, 63, 64, 8191, 8192, (1 << 20) - 1, 1 << 20, 1 << 24 })
+	{
+		for (size_t count = 0; count <= 40; count++)
+		{
+			for (int i = 0; i < 20; i++)
+			{
+				std::vector<Coordinate> coords = randomCoordinates(rng, start, count, range);
+				std::vector<uint8_t> encoded = encode(start, coords);
+				CAPTURE(range, count, i);
+				REQUIRE(decode(Impl::SCALAR, encoded, start, count) == coords);
+				REQUIRE(decode(Impl::SSSE3, encoded, start, count) == coords);
+			}
+		}
+	}
+	CoordinateDecoder::select(original);
+}
+
+
+TEST_CASE("CoordinateDecoder handles mixed varint lengths")
+{
+	if (!isSsse3Supported()) return;
+	Impl original = CoordinateDecoder::implementation();
+	std::mt19937 rng(99);
+	std::uniform_int_distribution<int32_t> small(-50, 50);
+	std::uniform_int_distribution<int32_t> large(-(1 << 24), 1 << 24);
+	std::bernoulli_distribution isLarge(0.1);
+	Coordinate start(0, 0);
+	for (int i = 0; i < 500; i++)
+	{
+		// Mostly short deltas, with the occasional long one, so the
+		// vector code falls back to the scalar code at varying positions
+		std::vector<Coordinate> coords(8 + i % 57);
+		Coordinate c = start;
+		for (Coordinate& out : coords)
+		{
+			int32_t dx = isLarge(rng) ? large(rng) : small(rng);
+			int32_t dy = isLarge(rng) ? large(rng) : small(rng);
+			c = Coordinate(c.x + dx, c.y + dy);
+			out = c;
+		}
+		std::vector<uint8_t> encoded = encode(start, coords);
+		CAPTURE(i);
+		REQUIRE(decode(Impl::SCALAR, encoded, start, coords.size()) == coords);
+		REQUIRE(decode(Impl::SSSE3, encoded, start, coords.size()) == coords);
+	}
+	CoordinateDecoder::select(original);
+}
+
+
+TEST_CASE("CoordinateDecoder handles extreme deltas")
+{
+	if (!isSsse3Supported()) return;
+	Impl original = CoordinateDecoder::implementation();
+	// Alternating between opposite corners yields 5-byte varints
+	// and deltas of the largest magnitude that fits into 32 bits
+	const int32_t lo = -(1 << 30);
+	const int32_t hi = (1 << 30) - 1;
+	std::vector<Coordinate> coords;
+	for (int i = 0; i < 24; i++)
+	{
+		coords.emplace_back((i & 1) ? hi : lo, (i & 2) ? lo : hi);
+	}
+	Coordinate start(0, 0);
+	std::vector<uint8_t> encoded = encode(start, coords);
+	REQUIRE(decode(Impl::SCALAR, encoded, start, coords.size()) == coords);
+	REQUIRE(decode(Impl::SSSE3, encoded, start, coords.size()) == coords);
+	CoordinateDecoder::select(original);
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <geodesk/feature/LocalKeyCache.h>
+
+using namespace geodesk;
+using clarisma::ShortVarString;
+
+TEST_CASE("LocalKeyCache resolves each key string once")
+{
+	alignas(8) uint8_t buf[64];
+	ShortVarString* de = reinterpret_cast<ShortVarString*>(buf);
+	ShortVarString* fr = reinterpret_cast<ShortVarString*>(buf + 32);
+	de->init("name:de", 7);
+	fr->init("name:fr", 7);
+
+	LocalKeyCache cache("name:de");
+	REQUIRE(cache.matches(de));
+	REQUIRE_FALSE(cache.matches(fr));
+
+	// Repeated addresses are resolved without looking at the string
+	fr->init("name:de", 7);
+	REQUIRE_FALSE(cache.matches(fr));
+	cache.clear();
+	REQUIRE(cache.matches(fr));
+}
+
+TEST_CASE("LocalKeyCache::forKey() keeps a cache per key until a store is closed")
+{
+	alignas(8) uint8_t buf[32];
+	ShortVarString* s = reinterpret_cast<ShortVarString*>(buf);
+	s->init("name:de", 7);
+
+	std::string key = "name:de";
+	LocalKeyCache& cache = LocalKeyCache::forKey(key);
+	REQUIRE(cache.key() == "name:de");
+	REQUIRE(&LocalKeyCache::forKey("name:de") == &cache);
+	REQUIRE(&LocalKeyCache::forKey("name:fr") != &cache);
+	REQUIRE(LocalKeyCache::forKey("name:de").matches(s));
+
+	// Once a store has been closed, its memory may hold other strings
+	s->init("name:it", 7);
+	REQUIRE(LocalKeyCache::forKey("name:de").matches(s));
+	LocalKeyCache::invalidateAll();
+	REQUIRE_FALSE(LocalKeyCache::forKey("name:de").matches(s));
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <vector>
+#include <geodesk/feature/WayCoordinateIterator.h>
+
+using namespace geodesk;
+
+static constexpr int BATCH_SIZE = WayCoordinateIterator::BATCH_SIZE;
+
+// Collects the consecutive coordinate pairs (or triples) seen by
+// forEachSegmentBatch() for the coordinates 0..count-1, handed out
+// `chunk` at a time
+template<int Overlap>
+static std::vector<std::vector<int>> visit(int count, int chunk)
+{
+	std::vector<std::vector<int>> seen;
+	int next = 0;
+	WayCoordinateIterator::forEachSegmentBatch<Overlap>(
+		[&](Coordinate* coords, int maxCount)
+		{
+			int n = std::min({ maxCount, chunk, count - next });
+			for (int i = 0; i < n; i++) coords[i] = Coordinate(next++, 0);
+			return n;
+		},
+		[&](const Coordinate* coords, int n)
+		{
+			REQUIRE(n > Overlap);
+			REQUIRE(n <= BATCH_SIZE);
+			for (int i = 0; i + Overlap < n; i++)
+			{
+				std::vector<int> group;
+				for (int j = 0; j <= Overlap; j++) group.push_back(coords[i + j].x);
+				seen.push_back(group);
+			}
+		});
+	return seen;
+}
+
+
+template<int Overlap>
+static void checkVisitsEachGroupOnce()
+{
+	for (int count : { 0, 1, 2, 3, BATCH_SIZE - 1, BATCH_SIZE, BATCH_SIZE + 1,
+		2 * BATCH_SIZE - 2, 2 * BATCH_SIZE - 1, 2 * BATCH_SIZE, 500 })
+	{
+		for (int chunk : { 7, BATCH_SIZE })
+		{
+			CAPTURE(Overlap, count, chunk);
+			std::vector<std::vector<int>> seen = visit<Overlap>(count, chunk);
+			REQUIRE(seen.size() == static_cast<size_t>(std::max(count - Overlap, 0)));
+			for (size_t i = 0; i < seen.size(); i++)
+			{
+				for (int j = 0; j <= Overlap; j++)
+				{
+					REQUIRE(seen[i][j] == static_cast<int>(i) + j);
+				}
+			}
+		}
+	}
+}
+
+
+TEST_CASE("WayCoordinateIterator::forEachSegmentBatch visits each segment once")
+{
+	checkVisitsEachGroupOnce<1>();
+	checkVisitsEachGroupOnce<2>();
+}
+
+
+TEST_CASE("WayCoordinateIterator::forEachSegmentBatch stops early")
+{
+	int next = 0;
+	int calls = 0;
+	bool stopped = WayCoordinateIterator::forEachSegmentBatch(
+		[&next](Coordinate* coords, int maxCount)
+		{
+			int n = std::min(maxCount, 1000 - next);
+			for (int i = 0; i < n; i++) coords[i] = Coordinate(next++, 0);
+			return n;
+		},
+		[&calls](const Coordinate*, int)
+		{
+			return ++calls == 2;
+		});
+	REQUIRE(stopped);
+	REQUIRE(calls == 2);
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <geodesk/filter/FeatureDistanceFilter.h>
+#include <geodesk/geom/Mercator.h>
+#include <geodesk/geom/index/MCIndexBuilder.h>
+
+using namespace geodesk;
+
+class TestDistanceFilter : public FeatureDistanceFilter
+{
+public:
+	using FeatureDistanceFilter::FeatureDistanceFilter;
+	using FeatureDistanceFilter::isPointWithinDistance;
+	const Box& bufferedBounds() const { return bounds_; }
+};
+
+TEST_CASE("FeatureDistanceFilter uses the scale at each candidate's latitude")
+{
+	// A north-south line from 40 to 60 degrees latitude
+	int32_t x = Mercator::xFromLon(10);
+	Coordinate south(x, Mercator::yFromLat(40));
+	Coordinate north(x, Mercator::yFromLat(60));
+	MCIndexBuilder builder;
+	builder.addLineSegment(south, north);
+	Box bounds(x, south.y, x, north.y);
+	SharedMCIndex index = std::make_shared<const MCIndex>(builder.build(bounds));
+
+	double meters = 10'000;
+	auto filter = std::make_unique<TestDistanceFilter>(meters, bounds, index, false);
+	for (Coordinate c : { south, north })
+	{
+		int32_t inside = static_cast<int32_t>(Mercator::unitsFromMeters(meters * 0.95, c.y));
+		int32_t outside = static_cast<int32_t>(Mercator::unitsFromMeters(meters * 1.05, c.y));
+		Coordinate near(x + inside, c.y);
+		Coordinate far(x + outside, c.y);
+		REQUIRE(filter->bufferedBounds().contains(near));
+		REQUIRE(filter->isPointWithinDistance(near));
+		REQUIRE_FALSE(filter->isPointWithinDistance(far));
+	}
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <string>
+#include <vector>
+#include <clarisma/util/Buffer.h>
+#include <geodesk/format/GeometryWriter.h>
+
+using namespace geodesk;
+
+namespace {
+
+// The buffer must be constructed before the GeometryWriter, which
+// captures its pointers, so it lives in a base class
+struct TestBuffer
+{
+	clarisma::DynamicBuffer buf { 1024 };
+};
+
+class TestWriter : private TestBuffer, public GeometryWriter
+{
+public:
+	TestWriter() : GeometryWriter(&buf) {}
+
+	using GeometryWriter::writeCoordinate;
+	using GeometryWriter::writeCoordinateSegment;
+
+	std::string text() { return { data(), length() }; }
+};
+
+}
+
+TEST_CASE("GeometryWriter writes coordinates in batches")
+{
+	std::mt19937 rng(4848);
+	std::uniform_int_distribution<int32_t> dist(INT32_MIN, INT32_MAX);
+	for (int precision : { 0, 3, 7, 9, 15 })
+	{
+		// Batches are converted 64 coordinates at a time
+		for (size_t count : { 1, 2, 63, 64, 65, 127, 128, 129 })
+		{
+			std::vector<Coordinate> coords(count);
+			for (Coordinate& c : coords) c = Coordinate(dist(rng), dist(rng));
+			coords[0] = Coordinate(0, 0);
+
+			TestWriter batch;
+			batch.precision(precision);
+			batch.writeCoordinateSegment(true, coords.data(), count);
+
+			std::string expected;
+			for (size_t i = 0; i < count; i++)
+			{
+				TestWriter single;
+				single.precision(precision);
+				single.writeCoordinate(coords[i]);
+				if (i > 0) expected += ',';
+				expected += single.text();
+			}
+			CAPTURE(precision, count);
+			REQUIRE(batch.text() == expected);
+		}
+	}
+}
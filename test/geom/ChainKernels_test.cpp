@@ -0,0 +1,184 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+#include <geodesk/geom/index/ChainKernels.h>
+
+using namespace geodesk;
+
+using Impl = ChainKernels::Implementation;
+
+// Small ranges produce many collinear segments and points that lie
+// on vertexes or segments; full-range coordinates exercise the
+// precision of the cross products
+static Coordinate randomCoordinate(std::mt19937& rng, int32_t range)
+{
+	std::uniform_int_distribution<int32_t> dist(-range, range);
+	return Coordinate(dist(rng), dist(rng));
+}
+
+
+struct CrossingResult
+{
+	bool onBoundary;
+	uint32_t crossings;
+
+	bool operator==(const CrossingResult& other) const
+	{
+		// crossings are undefined if the point lies on the linestring
+		return onBoundary == other.onBoundary &&
+			(onBoundary || crossings == other.crossings);
+	}
+};
+
+
+static CrossingResult countCrossings(Impl impl,
+	const std::vector<Coordinate>& coords, size_t count, Coordinate pt)
+{
+	ChainKernels::select(impl);
+	uint32_t crossings = 0;
+	bool onBoundary = ChainKernels::countCrossings(coords.data(), count, pt, crossings);
+	return { onBoundary, crossings };
+}
+
+
+static bool anyIntersect(Impl impl, const ChainKernels::SegmentPairs& pairs)
+{
+	ChainKernels::select(impl);
+	return ChainKernels::anyIntersect(pairs);
+}
+
+
+static std::vector<Impl> vectorImplementations()
+{
+	Impl original = ChainKernels::implementation();
+	std::vector<Impl> impls;
+	for (Impl impl : { Impl::SSE2, Impl::AVX2 })
+	{
+		if (ChainKernels::select(impl)) impls.push_back(impl);
+	}
+	ChainKernels::select(original);
+	return impls;
+}
+
+
+TEST_CASE("ChainKernels::countCrossings matches scalar")
+{
+	Impl original = ChainKernels::implementation();
+	std::mt19937 rng(42);
+	// 0 and 1 have no segments; the others straddle the batch sizes
+	// of the SSE2 (2) and AVX2 (4) kernels
+	size_t counts[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 17, 33 };
+	for (Impl impl : vectorImplementations())
+	{
+		for (int32_t range : { 8, 1000, 1 << 30, INT32_MAX })
+		{
+			for (size_t count : counts)
+			{
+				for (int i = 0; i < 200; i++)
+				{
+					std::vector<Coordinate> coords(count);
+					for (Coordinate& c : coords) c = randomCoordinate(rng, range);
+					if (count > 2) coords.back() = coords.front();
+					Coordinate pt = (i % 4 == 0 && count > 0) ?
+						coords[i % count] : randomCoordinate(rng, range);
+					CAPTURE(static_cast<int>(impl), range, count, i);
+					REQUIRE(countCrossings(impl, coords, count, pt) ==
+						countCrossings(Impl::SCALAR, coords, count, pt));
+				}
+			}
+		}
+	}
+	ChainKernels::select(original);
+}
+
+
+TEST_CASE("ChainKernels::countCrossings with negative deltas")
+{
+	Impl original = ChainKernels::implementation();
+	// A square traversed clockwise, so every segment has at least one
+	// negative delta; points inside, outside and on the boundary
+	std::vector<Coordinate> square = {
+		{ -100, 100 }, { 100, 100 }, { 100, -100 }, { -100, -100 }, { -100, 100 } };
+	Coordinate inside(-1, -1);
+	Coordinate outside(-101, 0);
+	Coordinate onEdge(100, -7);
+	Coordinate onVertex(-100, -100);
+	for (Impl impl : vectorImplementations())
+	{
+		CAPTURE(static_cast<int>(impl));
+		CrossingResult r = countCrossings(impl, square, square.size(), inside);
+		REQUIRE_FALSE(r.onBoundary);
+		REQUIRE((r.crossings / 2) % 2 == 1);
+		r = countCrossings(impl, square, square.size(), outside);
+		REQUIRE_FALSE(r.onBoundary);
+		REQUIRE((r.crossings / 2) % 2 == 0);
+		REQUIRE(countCrossings(impl, square, square.size(), onEdge).onBoundary);
+		REQUIRE(countCrossings(impl, square, square.size(), onVertex).onBoundary);
+	}
+	ChainKernels::select(original);
+}
+
+
+TEST_CASE("ChainKernels::anyIntersect matches scalar")
+{
+	Impl original = ChainKernels::implementation();
+	std::mt19937 rng(7);
+	for (Impl impl : vectorImplementations())
+	{
+		for (int32_t range : { 4, 1000, INT32_MAX })
+		{
+			for (int count = 0; count <= ChainKernels::SegmentPairs::CAPACITY; count++)
+			{
+				for (int i = 0; i < 200; i++)
+				{
+					ChainKernels::SegmentPairs pairs;
+					for (int n = 0; n < count; n++)
+					{
+						pairs.add(randomCoordinate(rng, range), randomCoordinate(rng, range),
+							randomCoordinate(rng, range), randomCoordinate(rng, range));
+					}
+					CAPTURE(static_cast<int>(impl), range, count, i);
+					REQUIRE(anyIntersect(impl, pairs) == anyIntersect(Impl::SCALAR, pairs));
+				}
+			}
+		}
+	}
+	ChainKernels::select(original);
+}
+
+
+TEST_CASE("ChainKernels::anyIntersect finds the only intersecting pair")
+{
+	Impl original = ChainKernels::implementation();
+	// Each pair is disjoint except one, which is placed at every position
+	// in turn (so it falls into each lane and into the scalar tail)
+	for (Impl impl : vectorImplementations())
+	{
+		for (int count = 1; count <= ChainKernels::SegmentPairs::CAPACITY; count++)
+		{
+			for (int hit = 0; hit < count; hit++)
+			{
+				ChainKernels::SegmentPairs pairs;
+				for (int n = 0; n < count; n++)
+				{
+					int32_t y = -1000 * n;
+					if (n == hit)
+					{
+						pairs.add({ -50, y - 50 }, { 50, y + 50 }, { 50, y - 50 }, { -50, y + 50 });
+					}
+					else
+					{
+						pairs.add({ -50, y }, { 50, y }, { -50, y - 10 }, { 50, y - 10 });
+					}
+				}
+				CAPTURE(static_cast<int>(impl), count, hit);
+				REQUIRE(anyIntersect(impl, pairs));
+				REQUIRE(anyIntersect(Impl::SCALAR, pairs));
+			}
+		}
+	}
+	ChainKernels::select(original);
+}
@@ -0,0 +1,222 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <clarisma/math/Math.h>
+#include <geodesk/geom/CoordinateTransform.h>
+#include <geodesk/geom/Mercator.h>
+
+using namespace geodesk;
+
+using Impl = CoordinateTransform::Implementation;
+
+static bool isAvx2Supported()
+{
+	Impl original = CoordinateTransform::implementation();
+	bool supported = CoordinateTransform::select(Impl::AVX2);
+	CoordinateTransform::select(original);
+	return supported;
+}
+
+
+// The AVX2 kernels convert 4 coordinates at a time (the rest is
+// handled by the scalar code); GeometryWriter converts batches of 64
+static const size_t COUNTS[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 63, 64, 65, 127, 128, 129 };
+
+// Coordinates are drawn from [min, max]; the ranges include
+// coordinates that are all negative, and ones that descend
+// (negative deltas between neighbors)
+struct Range
+{
+	int32_t min;
+	int32_t max;
+	bool descending;
+};
+
+static const Range RANGES[] =
+{
+	{ -10, 10, false },
+	{ -2'000'000'000, -1'000'000'000, false },
+	{ INT32_MIN, INT32_MAX, false },
+	{ INT32_MIN, INT32_MAX, true },
+	{ -100'000, 100'000, true },
+};
+
+static std::vector<Coordinate> coordinates(std::mt19937& rng, size_t count, const Range& range)
+{
+	std::uniform_int_distribution<int32_t> dist(range.min, range.max);
+	std::vector<Coordinate> coords(count);
+	for (Coordinate& c : coords) c = Coordinate(dist(rng), dist(rng));
+	if (range.descending)
+	{
+		std::sort(coords.begin(), coords.end(), [](Coordinate a, Coordinate b)
+		{
+			return a.x > b.x;
+		});
+	}
+	// The extremes of the range, at the start and (if there is room)
+	// at the end, so they end up in a SIMD lane as well as in the tail
+	if (count > 0) coords[0] = Coordinate(range.min, range.max);
+	if (count > 1) coords[count - 1] = Coordinate(range.max, range.min);
+	return coords;
+}
+
+
+// Values written past `count` would overwrite these
+static constexpr double SENTINEL = 12345.0;
+static constexpr int64_t SCALED_SENTINEL = 0x5e5e5e5e;
+static constexpr size_t PADDING = 8;
+
+
+TEST_CASE("CoordinateTransform::toLonLat matches scalar")
+{
+	if (!isAvx2Supported()) return;
+	Impl original = CoordinateTransform::implementation();
+	std::mt19937 rng(48);
+	for (const Range& range : RANGES)
+	{
+		for (size_t count : COUNTS)
+		{
+			std::vector<Coordinate> coords = coordinates(rng, count, range);
+			std::vector<double> lon1(count + PADDING, SENTINEL);
+			std::vector<double> lat1(count + PADDING, SENTINEL);
+			std::vector<double> lon2(count + PADDING, SENTINEL);
+			std::vector<double> lat2(count + PADDING, SENTINEL);
+			CoordinateTransform::select(Impl::SCALAR);
+			CoordinateTransform::toLonLat(coords.data(), count, lon1.data(), lat1.data());
+			CoordinateTransform::select(Impl::AVX2);
+			CoordinateTransform::toLonLat(coords.data(), count, lon2.data(), lat2.data());
+			CAPTURE(range.min, range.max, count);
+			REQUIRE(lon1 == lon2);
+			REQUIRE(lat1 == lat2);
+			for (size_t i = count; i < count + PADDING; i++)
+			{
+				REQUIRE(lon2[i] == SENTINEL);
+				REQUIRE(lat2[i] == SENTINEL);
+			}
+		}
+	}
+	CoordinateTransform::select(original);
+}
+
+
+TEST_CASE("CoordinateTransform::toScaledLonLat matches scalar")
+{
+	if (!isAvx2Supported()) return;
+	Impl original = CoordinateTransform::implementation();
+	std::mt19937 rng(480);
+	for (int precision = 0; precision <= CoordinateTransform::MAX_SCALED_PRECISION; precision++)
+	{
+		for (const Range& range : RANGES)
+		{
+			for (size_t count : COUNTS)
+			{
+				std::vector<Coordinate> coords = coordinates(rng, count, range);
+				std::vector<int64_t> lon1(count + PADDING, SCALED_SENTINEL);
+				std::vector<int64_t> lat1(count + PADDING, SCALED_SENTINEL);
+				std::vector<int64_t> lon2(count + PADDING, SCALED_SENTINEL);
+				std::vector<int64_t> lat2(count + PADDING, SCALED_SENTINEL);
+				CoordinateTransform::select(Impl::SCALAR);
+				CoordinateTransform::toScaledLonLat(coords.data(), count, precision,
+					lon1.data(), lat1.data());
+				CoordinateTransform::select(Impl::AVX2);
+				CoordinateTransform::toScaledLonLat(coords.data(), count, precision,
+					lon2.data(), lat2.data());
+				CAPTURE(precision, range.min, range.max, count);
+				REQUIRE(lon1 == lon2);
+				REQUIRE(lat1 == lat2);
+				for (size_t i = count; i < count + PADDING; i++)
+				{
+					REQUIRE(lon2[i] == SCALED_SENTINEL);
+					REQUIRE(lat2[i] == SCALED_SENTINEL);
+				}
+			}
+		}
+	}
+	CoordinateTransform::select(original);
+}
+
+
+TEST_CASE("CoordinateTransform::toScaledLonLat rounds like std::round()")
+{
+	// The coordinates closest to the points halfway between two
+	// scaled values (on either side of zero)
+	Impl original = CoordinateTransform::implementation();
+	std::mt19937 rng(4800);
+	for (Impl impl : { Impl::SCALAR, Impl::AVX2 })
+	{
+		if (!CoordinateTransform::select(impl)) continue;
+		for (int precision = 0; precision <= CoordinateTransform::MAX_SCALED_PRECISION; precision++)
+		{
+			double multiplier = clarisma::Math::POWERS_OF_10[precision];
+			std::uniform_int_distribution<int64_t> dist(
+				static_cast<int64_t>(-180 * multiplier),
+				static_cast<int64_t>(180 * multiplier) - 1);
+			std::vector<Coordinate> coords;
+			for (int i = 0; i < 100; i++)
+			{
+				double halfway = (static_cast<double>(dist(rng)) + 0.5) / multiplier;
+				int64_t x = static_cast<int64_t>(std::round(
+					halfway * Mercator::MAP_WIDTH / 360));
+				for (int64_t dx = -1; dx <= 1; dx++)
+				{
+					coords.emplace_back(static_cast<int32_t>(std::clamp<int64_t>(
+						x + dx, INT32_MIN, INT32_MAX)), 0);
+				}
+			}
+			std::vector<int64_t> lon(coords.size());
+			std::vector<int64_t> lat(coords.size());
+			CoordinateTransform::toScaledLonLat(coords.data(), coords.size(), precision,
+				lon.data(), lat.data());
+			for (size_t i = 0; i < coords.size(); i++)
+			{
+				double scaled = Mercator::lonFromX(coords[i].x) * multiplier;
+				CAPTURE(precision, coords[i].x, scaled);
+				REQUIRE(lon[i] == static_cast<int64_t>(std::round(scaled)));
+				REQUIRE(lat[i] == 0);
+			}
+		}
+	}
+	CoordinateTransform::select(original);
+}
+
+
+TEST_CASE("CoordinateTransform is accurate")
+{
+	Impl original = CoordinateTransform::implementation();
+	std::mt19937 rng(4848);
+	for (Impl impl : { Impl::SCALAR, Impl::AVX2 })
+	{
+		if (!CoordinateTransform::select(impl)) continue;
+		for (const Range& range : RANGES)
+		{
+			std::vector<Coordinate> coords = coordinates(rng, 1000, range);
+			std::vector<double> lon(coords.size());
+			std::vector<double> lat(coords.size());
+			CoordinateTransform::toLonLat(coords.data(), coords.size(),
+				lon.data(), lat.data());
+			for (size_t i = 0; i < coords.size(); i++)
+			{
+				CAPTURE(coords[i].x, coords[i].y);
+				REQUIRE(lon[i] == Mercator::lonFromX(coords[i].x));
+				REQUIRE(std::abs(lat[i] - Mercator::latFromY(coords[i].y)) <= 1e-12);
+			}
+
+			// The inverse restores the coordinates (to within a unit,
+			// since the latitude is approximated)
+			std::vector<Coordinate> back(coords.size());
+			CoordinateTransform::fromLonLat(lon.data(), lat.data(), coords.size(), back.data());
+			for (size_t i = 0; i < coords.size(); i++)
+			{
+				CAPTURE(coords[i].x, coords[i].y);
+				REQUIRE(std::abs(static_cast<int64_t>(back[i].x) - coords[i].x) <= 1);
+				REQUIRE(std::abs(static_cast<int64_t>(back[i].y) - coords[i].y) <= 1);
+			}
+		}
+	}
+	CoordinateTransform::select(original);
+}
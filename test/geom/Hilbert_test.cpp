@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <random>
+#include <geodesk/geodesk.h>
+#include <geodesk/geom/index/hilbert.h>
+
+using namespace geodesk;
+
+TEST_CASE("lowestHilbertDistance matches a search of all cells")
+{
+	// With these reference bounds, coordinates map 1:1 to grid cells
+	Box grid(0, 0, hilbert::MAX_COORDINATE - 1, hilbert::MAX_COORDINATE - 1);
+	std::mt19937 rng(50);
+	std::uniform_int_distribution<int32_t> start(0, hilbert::MAX_COORDINATE - 1);
+	std::uniform_int_distribution<int32_t> size(0, 150);
+	for (int i = 0; i < 500; i++)
+	{
+		int32_t minX = start(rng);
+		int32_t minY = start(rng);
+		int32_t maxX = std::min(minX + size(rng), hilbert::MAX_COORDINATE - 1);
+		int32_t maxY = std::min(minY + ((i % 5) ? size(rng) : 0), hilbert::MAX_COORDINATE - 1);
+		uint32_t lowest = UINT32_MAX;
+		for (int32_t x = minX; x <= maxX; x++)
+		{
+			for (int32_t y = minY; y <= maxY; y++)
+			{
+				lowest = std::min(lowest, hilbert::calculateHilbertDistance(x, y));
+			}
+		}
+		CAPTURE(minX, minY, maxX, maxY);
+		REQUIRE(hilbert::lowestHilbertDistance(Box(minX, minY, maxX, maxY), grid) == lowest);
+	}
+
+	REQUIRE(hilbert::lowestHilbertDistance(grid, grid) == 0);
+	REQUIRE(hilbert::lowestHilbertDistance(Box::ofWorld(), Box::ofWorld()) == 0);
+}
+
+TEST_CASE("lowestHilbertDistance is a lower bound within the world")
+{
+	Box world = Box::ofWorld();
+	std::mt19937 rng(50);
+	std::uniform_int_distribution<int32_t> coord(INT32_MIN, INT32_MAX - 100'000'000);
+	std::uniform_int_distribution<int32_t> size(0, 100'000'000);
+	for (int i = 0; i < 10'000; i++)
+	{
+		int32_t minX = coord(rng);
+		int32_t minY = coord(rng);
+		Box box(minX, minY, minX + size(rng), minY + size(rng));
+		uint32_t lowest = hilbert::lowestHilbertDistance(box, world);
+		std::uniform_int_distribution<int32_t> x(box.minX(), box.maxX());
+		std::uniform_int_distribution<int32_t> y(box.minY(), box.maxY());
+		for (int j = 0; j < 20; j++)
+		{
+			REQUIRE(hilbert::calculateHilbertDistance(Coordinate(x(rng), y(rng)), world) >= lowest);
+		}
+		REQUIRE(hilbert::calculateHilbertDistance(box.bottomLeft(), world) >= lowest);
+		REQUIRE(hilbert::calculateHilbertDistance(box.topRight(), world) >= lowest);
+	}
+}
+
+TEST_CASE("Features sorted by Hilbert distance", "[.][gol]")
+{
+	Features world(R"(c:\geodesk\tests\w.gol)");
+	Features pubs = world("na[amenity=pub]");
+	Box bounds = Box::ofWorld();
+	uint32_t prev = 0;
+	uint64_t count = 0;
+	for (Feature pub : pubs.sortedByHilbert())
+	{
+		uint32_t distance = hilbert::calculateHilbertDistance(pub.xy(), bounds);
+		REQUIRE(distance >= prev);
+		prev = distance;
+		count++;
+	}
+	REQUIRE(count == pubs.count());
+}
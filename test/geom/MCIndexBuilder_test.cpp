@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <vector>
+#include <clarisma/util/varint.h>
+#include <geodesk/geom/index/MCIndexBuilder.h>
+
+using namespace geodesk;
+using namespace clarisma;
+
+// Lays out ways in the same format as a GOL: the bounding box, followed
+// by the header (flags at 0, relative pointer to the body at 12), with
+// the body holding the varint-encoded coordinates
+class WayBuffer
+{
+public:
+	void addStaircase(int32_t x, int32_t y, int vertexCount)
+	{
+		size_t start = data_.size();
+		data_.resize(start + 32 + vertexCount * 10 + 5);
+		uint8_t* p = data_.data() + start;
+		int32_t header[8] = { x, y, x + vertexCount, y + vertexCount / 2,
+			1 << 3, 0, 0, 4 };
+		std::copy_n(reinterpret_cast<uint8_t*>(header), sizeof(header), p);
+		uint8_t* pBody = p + 32;
+		writeVarint(pBody, vertexCount);
+		writeSignedVarint(pBody, 0);
+		writeSignedVarint(pBody, 0);
+		for (int i = 1; i < vertexCount; i++)
+		{
+			writeSignedVarint(pBody, 1);
+			writeSignedVarint(pBody, i & 1);
+		}
+		data_.resize(pBody - data_.data());
+		offsets_.push_back(start + 16);
+	}
+
+	std::vector<WayPtr> ways()
+	{
+		std::vector<WayPtr> ways;
+		for (size_t ofs : offsets_) ways.emplace_back(DataPtr(data_.data() + ofs));
+		return ways;
+	}
+
+private:
+	std::vector<uint8_t> data_;
+	std::vector<size_t> offsets_;
+};
+
+static bool collectChain(const RTree<const MonotoneChain>::Node* node,
+	std::vector<std::pair<Coordinate,int>>* chains)
+{
+	chains->emplace_back(node->item()->first(), node->item()->vertexCount());
+	return false;
+}
+
+static std::vector<std::pair<Coordinate,int>> chainsOf(MCIndexBuilder& builder, const Box& bounds)
+{
+	MCIndex index = builder.build(bounds);
+	std::vector<std::pair<Coordinate,int>> chains;
+	index.findChains(Box::ofWorld(), collectChain, &chains);
+	std::sort(chains.begin(), chains.end(), [](const auto& a, const auto& b)
+	{
+		return a.first.x < b.first.x || (a.first.x == b.first.x && a.first.y < b.first.y);
+	});
+	return chains;
+}
+
+TEST_CASE("segmentizeWays() yields the same chains as segmentizing each way")
+{
+	// Enough vertexes to slice the ways in parallel (if there are
+	// multiple cores), with ways of very different sizes
+	WayBuffer buffer;
+	Box bounds;
+	for (int i = 0; i < 200; i++)
+	{
+		int32_t x = i * 100'000;
+		int vertexCount = (i % 50 == 0) ? 60'000 : 2 + i * 7;
+		buffer.addStaircase(x, 0, vertexCount);
+		bounds.expandToInclude(Coordinate(x, 0));
+		bounds.expandToInclude(Coordinate(x + vertexCount, vertexCount / 2));
+	}
+	std::vector<WayPtr> ways = buffer.ways();
+
+	MCIndexBuilder parallel;
+	parallel.segmentizeWays(ways);
+	MCIndexBuilder sequential;
+	for (WayPtr way : ways) sequential.segmentizeWay(way);
+
+	REQUIRE(parallel.estimatedIndexSize() == sequential.estimatedIndexSize());
+	REQUIRE(chainsOf(parallel, bounds) == chainsOf(sequential, bounds));
+}
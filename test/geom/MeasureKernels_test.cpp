@@ -0,0 +1,167 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <geodesk/geom/MeasureKernels.h>
+#include <geodesk/geom/Mercator.h>
+
+using namespace geodesk;
+
+using Impl = MeasureKernels::Implementation;
+
+// Latitudes up to about 85 degrees; small ranges produce short
+// segments, and the offset moves the ring away from the origin
+static std::vector<Coordinate> randomCoordinates(std::mt19937& rng,
+	size_t count, int32_t range, Coordinate offset)
+{
+	std::uniform_int_distribution<int32_t> dist(-range, range);
+	std::vector<Coordinate> coords(count);
+	for (Coordinate& c : coords)
+	{
+		c = Coordinate(
+			static_cast<int32_t>(std::clamp<int64_t>(
+				static_cast<int64_t>(offset.x) + dist(rng), -2'000'000'000, 2'000'000'000)),
+			static_cast<int32_t>(std::clamp<int64_t>(
+				static_cast<int64_t>(offset.y) + dist(rng), -2'000'000'000, 2'000'000'000)));
+	}
+	return coords;
+}
+
+
+static bool isAvx2Supported()
+{
+	Impl original = MeasureKernels::implementation();
+	bool supported = MeasureKernels::select(Impl::AVX2);
+	MeasureKernels::select(original);
+	return supported;
+}
+
+
+// The AVX2 kernels add up 4 partial sums, so their totals may differ
+// from the scalar sums in the last few bits
+static bool isClose(double a, double b, double magnitude)
+{
+	return std::abs(a - b) <= magnitude * 1e-13;
+}
+
+
+// 0 to 2 coordinates have no segments (or no inner vertexes); the
+// others straddle the 4 lanes of the AVX2 kernels
+static const size_t COUNTS[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 63, 64, 65 };
+static const int32_t RANGES[] = { 10, 100'000, 100'000'000, 2'000'000'000 };
+
+
+TEST_CASE("MeasureKernels::projectSinusoidal matches scalar")
+{
+	if (!isAvx2Supported()) return;
+	Impl original = MeasureKernels::implementation();
+	std::mt19937 rng(3);
+	for (int32_t range : RANGES)
+	{
+		for (size_t count : COUNTS)
+		{
+			std::vector<Coordinate> coords = randomCoordinates(rng, count, range, {});
+			std::vector<double> x1(count), y1(count), x2(count), y2(count);
+			MeasureKernels::select(Impl::SCALAR);
+			MeasureKernels::projectSinusoidal(coords.data(), count, x1.data(), y1.data());
+			MeasureKernels::select(Impl::AVX2);
+			MeasureKernels::projectSinusoidal(coords.data(), count, x2.data(), y2.data());
+			CAPTURE(range, count);
+			// Each coordinate is projected on its own, so the results
+			// must be identical
+			REQUIRE(x1 == x2);
+			REQUIRE(y1 == y2);
+		}
+	}
+	MeasureKernels::select(original);
+}
+
+
+TEST_CASE("MeasureKernels::length matches scalar")
+{
+	if (!isAvx2Supported()) return;
+	Impl original = MeasureKernels::implementation();
+	std::mt19937 rng(5);
+	for (int32_t range : RANGES)
+	{
+		for (size_t count : COUNTS)
+		{
+			for (int i = 0; i < 20; i++)
+			{
+				std::vector<Coordinate> coords = randomCoordinates(rng, count, range, {});
+				MeasureKernels::select(Impl::SCALAR);
+				double scalar = MeasureKernels::length(coords.data(), count);
+				MeasureKernels::select(Impl::AVX2);
+				double avx2 = MeasureKernels::length(coords.data(), count);
+				CAPTURE(range, count, i, scalar, avx2);
+				REQUIRE(scalar >= 0);
+				REQUIRE(isClose(scalar, avx2, scalar));
+			}
+		}
+	}
+	MeasureKernels::select(original);
+}
+
+
+TEST_CASE("MeasureKernels::shoelace matches scalar")
+{
+	if (!isAvx2Supported()) return;
+	Impl original = MeasureKernels::implementation();
+	std::mt19937 rng(11);
+	for (int32_t range : RANGES)
+	{
+		for (size_t count : COUNTS)
+		{
+			for (int i = 0; i < 20; i++)
+			{
+				Coordinate offset(range / 4, -range / 4);
+				std::vector<Coordinate> coords = randomCoordinates(rng, count, range / 2, offset);
+				double x0 = count ? coords[0].x : 0;
+				std::vector<double> x(count), y(count);
+				MeasureKernels::projectSinusoidal(coords.data(), count, x.data(), y.data());
+				double px0 = count ? x[0] : 0;
+
+				// The terms may cancel out, so the tolerance is based on
+				// the magnitude of the terms rather than of the sum
+				double magnitude = 0;
+				double projectedMagnitude = 0;
+				for (size_t n = 1; n + 1 < count; n++)
+				{
+					magnitude += std::abs((coords[n].x - x0) *
+						(static_cast<double>(coords[n - 1].y) - coords[n + 1].y));
+					projectedMagnitude += std::abs((x[n] - px0) * (y[n - 1] - y[n + 1]));
+				}
+
+				MeasureKernels::select(Impl::SCALAR);
+				double scalar = MeasureKernels::shoelace(coords.data(), count, x0);
+				double projectedScalar = MeasureKernels::shoelace(x.data(), y.data(), count, px0);
+				MeasureKernels::select(Impl::AVX2);
+				double avx2 = MeasureKernels::shoelace(coords.data(), count, x0);
+				double projectedAvx2 = MeasureKernels::shoelace(x.data(), y.data(), count, px0);
+				CAPTURE(range, count, i);
+				REQUIRE(isClose(scalar, avx2, magnitude));
+				REQUIRE(isClose(projectedScalar, projectedAvx2, projectedMagnitude));
+			}
+		}
+	}
+	MeasureKernels::select(original);
+}
+
+
+TEST_CASE("MeasureKernels approximations are accurate")
+{
+	for (double t = -40; t <= 40; t += 0.0137)
+	{
+		CAPTURE(t);
+		REQUIRE(std::abs(MeasureKernels::exp(t) - std::exp(t)) <= std::exp(t) * 1e-15);
+	}
+	for (double x = -1000; x <= 1000; x += 0.731)
+	{
+		CAPTURE(x);
+		REQUIRE(std::abs(MeasureKernels::atan(x) - std::atan(x)) <= 1e-15 * 2);
+	}
+}
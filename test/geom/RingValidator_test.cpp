@@ -0,0 +1,150 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include <geodesk/geom/polygon/Polygonizer.h>
+#include "geom/polygon/Ring.h"
+#include "geom/polygon/RingCoordinateIterator.h"
+
+using namespace geodesk;
+
+using Coords = std::vector<Coordinate>;
+
+static void addRing(Polygonizer& polygonizer, const Coords& coords, bool isOuter)
+{
+	polygonizer.addRing(coords.data(), static_cast<int>(coords.size()), isOuter);
+}
+
+// Twice the signed area (positive if counter-clockwise)
+static double signedArea(const Polygonizer::Ring* ring)
+{
+	RingCoordinateIterator iter(ring);
+	Coords coords;
+	while (iter.coordinatesRemaining()) coords.push_back(iter.next());
+	double area = 0;
+	for (size_t i = 0; i + 1 < coords.size(); i++)
+	{
+		area += static_cast<double>(coords[i].x) * coords[i + 1].y -
+			static_cast<double>(coords[i + 1].x) * coords[i].y;
+	}
+	return area;
+}
+
+// A square, clockwise
+static const Coords SQUARE = { {0,0}, {0,100}, {100,100}, {100,0}, {0,0} };
+
+TEST_CASE("Polygonizer::validate() accepts simple polygons and fixes their orientation")
+{
+	Polygonizer polygonizer;
+	addRing(polygonizer, SQUARE, true);
+	// A hole, counter-clockwise, touching the shell at a vertex
+	addRing(polygonizer, { {0,0}, {50,10}, {10,50}, {0,0} }, false);
+	polygonizer.assignAndMergeHoles();
+	REQUIRE(polygonizer.validate() == 0);
+	REQUIRE(polygonizer.isValid());
+
+	const Polygonizer::Ring* outer = polygonizer.outerRings();
+	REQUIRE(outer->isValid());
+	REQUIRE(signedArea(outer) > 0);
+	REQUIRE(outer->firstInner());
+	REQUIRE(signedArea(outer->firstInner()) < 0);
+
+	// Rings with the right orientation are left alone
+	Polygonizer correct;
+	addRing(correct, { {0,0}, {100,0}, {100,100}, {0,100}, {0,0} }, true);
+	REQUIRE(correct.validate() == 0);
+	REQUIRE(signedArea(correct.outerRings()) > 0);
+}
+
+TEST_CASE("Polygonizer::validate() detects self-intersections")
+{
+	// A bow-tie
+	Polygonizer bowTie;
+	addRing(bowTie, { {0,0}, {100,100}, {100,0}, {0,100}, {0,0} }, true);
+	REQUIRE(bowTie.validate() == 1);
+	REQUIRE_FALSE(bowTie.outerRings()->isValid());
+
+	// A hole that crosses its shell
+	Polygonizer crossing;
+	addRing(crossing, SQUARE, true);
+	addRing(crossing, { {50,50}, {150,50}, {150,60}, {50,60}, {50,50} }, false);
+	crossing.assignAndMergeHoles();
+	REQUIRE(crossing.validate() == 1);
+	REQUIRE_FALSE(crossing.isValid());
+
+	// A ring that isn't closed
+	Polygonizer open;
+	addRing(open, { {0,0}, {100,0}, {100,100}, {0,100} }, true);
+	REQUIRE(open.validate() == 1);
+}
+
+TEST_CASE("Polygonizer::validate() detects spikes")
+{
+	// The edge to (100,150) doubles back on itself
+	Polygonizer spike;
+	addRing(spike, { {0,0}, {100,0}, {100,100}, {100,150}, {100,100},
+		{0,100}, {0,0} }, true);
+	REQUIRE(spike.validate() == 1);
+
+	// A horizontal spike
+	Polygonizer horizontal;
+	addRing(horizontal, { {0,0}, {100,0}, {100,50}, {150,50}, {100,50},
+		{100,100}, {0,100}, {0,0} }, true);
+	REQUIRE(horizontal.validate() == 1);
+
+	// Two collinear edges that overlap
+	Polygonizer overlap;
+	addRing(overlap, { {0,0}, {100,0}, {100,100}, {50,100}, {50,0},
+		{20,0}, {20,-50}, {0,-50}, {0,0} }, true);
+	REQUIRE(overlap.validate() == 1);
+}
+
+TEST_CASE("Polygonizer::validate() is exact for nearly collinear edges")
+{
+	// The products of the coordinate deltas exceed 2^53, so a
+	// double-precision cross product rounds the offsets of V2 and V3
+	// (1000 units of cross product, i.e. well below a unit of
+	// distance) from the long edge V0-V1 to zero
+	Coordinate v0(-2'000'000'000, -2'000'000'000);
+	Coordinate v1(2'000'000'000, 1'999'999'000);
+	Coordinate left1(840'000'001, 839'999'291);      // cross product: 1000
+	Coordinate left2(440'000'001, 439'999'391);      // 1000
+	Coordinate right(439'999'999, 439'999'389);     // -1000
+
+	// A very thin, but valid ring
+	Polygonizer thin;
+	addRing(thin, { v0, v1, left1, left2, v0 }, true);
+	REQUIRE(thin.validate() == 0);
+	REQUIRE(signedArea(thin.outerRings()) > 0);
+
+	// The edge from left1 to right crosses V0-V1
+	Polygonizer crossing;
+	addRing(crossing, { v0, v1, left1, right, v0 }, true);
+	REQUIRE(crossing.validate() == 1);
+}
+
+#ifdef GEODESK_WITH_GEOS
+TEST_CASE("Polygonizer::createPolygonal() repairs invalid polygons")
+{
+	GEOSContextHandle_t context = GEOS_init_r();
+
+	Polygonizer bowTie;
+	addRing(bowTie, { {0,0}, {100,100}, {100,0}, {0,100}, {0,0} }, true);
+	REQUIRE(bowTie.validate() == 1);
+	GEOSGeometry* repaired = bowTie.createPolygonal(context);
+	REQUIRE(repaired);
+	REQUIRE(GEOSisValid_r(context, repaired) == 1);
+	GEOSGeom_destroy_r(context, repaired);
+
+	Polygonizer square;
+	addRing(square, SQUARE, true);
+	REQUIRE(square.validate() == 0);
+	GEOSGeometry* polygon = square.createPolygonal(context);
+	REQUIRE(GEOSGeomTypeId_r(context, polygon) == GEOS_POLYGON);
+	REQUIRE(GEOSisValid_r(context, polygon) == 1);
+	GEOSGeom_destroy_r(context, polygon);
+
+	GEOS_finish_r(context);
+}
+#endif
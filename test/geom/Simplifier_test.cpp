@@ -0,0 +1,188 @@
+// Copyright (c) 2024 Clarisma / GeoDesk contributors
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <geodesk/geodesk.h>
+#include <geodesk/geom/Simplifier.h>
+
+using namespace geodesk;
+
+static std::vector<Coordinate> zigzag(size_t count, int32_t step, int32_t amplitude)
+{
+	std::vector<Coordinate> coords;
+	for (size_t i = 0; i < count; i++)
+	{
+		coords.emplace_back(static_cast<int32_t>(i) * step,
+			(i % 2) ? amplitude : 0);
+	}
+	return coords;
+}
+
+// Checks that `simplified` starts and ends with the endpoints of
+// `original`, and that its vertexes appear in `original` in order
+static bool isPinnedSubsequence(const std::vector<Coordinate>& original,
+	const Coordinate* simplified, size_t count)
+{
+	if (count < 2) return false;
+	if (simplified[0] != original.front()) return false;
+	if (simplified[count - 1] != original.back()) return false;
+	auto it = original.begin();
+	for (size_t i = 0; i < count; i++)
+	{
+		it = std::find(it, original.end(), simplified[i]);
+		if (it == original.end()) return false;
+		++it;
+	}
+	return true;
+}
+
+TEST_CASE("Douglas-Peucker and Visvalingam drop small deviations")
+{
+	for (auto method : { Simplifier::Method::DOUGLAS_PEUCKER, Simplifier::Method::VISVALINGAM })
+	{
+		Simplifier simplifier(1000, method);
+
+		// Deviations well below the tolerance: only the endpoints remain
+		std::vector<Coordinate> coords = zigzag(50, 10'000, 10);
+		std::vector<Coordinate> original = coords;
+		size_t n = simplifier.simplify(coords.data(), coords.size(), 1000);
+		REQUIRE(n == 2);
+		REQUIRE(isPinnedSubsequence(original, coords.data(), n));
+
+		// Deviations well above the tolerance: all vertexes remain
+		coords = zigzag(50, 10'000, 100'000);
+		n = simplifier.simplify(coords.data(), coords.size(), 1000);
+		REQUIRE(n == 50);
+
+		// Too few vertexes to simplify
+		coords = zigzag(2, 10'000, 10);
+		REQUIRE(simplifier.simplify(coords.data(), 2, 1000) == 2);
+	}
+}
+
+TEST_CASE("Disabled Simplifier leaves ways unchanged")
+{
+	Simplifier simplifier;
+	REQUIRE_FALSE(simplifier.isEnabled());
+	std::vector<Coordinate> coords = zigzag(20, 10'000, 10);
+	std::vector<Coordinate> original = coords;
+	REQUIRE(simplifier.simplifyWay(coords.data(), coords.size()) == 20);
+	REQUIRE(coords == original);
+}
+
+TEST_CASE("simplifyWay keeps an interior vertex of open ways")
+{
+	for (auto method : { Simplifier::Method::DOUGLAS_PEUCKER, Simplifier::Method::VISVALINGAM })
+	{
+		Simplifier simplifier(1000, method);
+		std::vector<Coordinate> coords = zigzag(21, 1000, 10);
+		coords[13].y = 90;        // the farthest vertex, still within tolerance
+		std::vector<Coordinate> original = coords;
+		size_t n = simplifier.simplifyWay(coords.data(), coords.size());
+		REQUIRE(n == 3);
+		REQUIRE(coords[1] == original[13]);
+		REQUIRE(isPinnedSubsequence(original, coords.data(), n));
+
+		// A way with only two vertexes is left alone
+		coords = zigzag(2, 10'000, 10);
+		REQUIRE(simplifier.simplifyWay(coords.data(), 2) == 2);
+	}
+}
+
+TEST_CASE("simplifyWay does not collapse closed ways")
+{
+	Simplifier simplifier(1000);
+
+	// A ring that would collapse to a triangle is left unchanged
+	std::vector<Coordinate> ring =
+	{
+		{ 0, 0 }, { 400, 0 }, { 400, 400 }, { 0, 400 }, { 0, 0 }
+	};
+	std::vector<Coordinate> original = ring;
+	REQUIRE(simplifier.simplifyWay(ring.data(), ring.size()) == ring.size());
+	REQUIRE(ring == original);
+
+	// A larger ring keeps its corners and is still closed
+	ring.clear();
+	for (int32_t i = 0; i < 100; i++) ring.emplace_back(i * 1000, (i % 2) * 10);
+	for (int32_t i = 0; i < 100; i++) ring.emplace_back(100'000 - (i % 2) * 10, i * 1000);
+	for (int32_t i = 0; i < 100; i++) ring.emplace_back(100'000 - i * 1000, 100'000);
+	for (int32_t i = 0; i < 100; i++) ring.emplace_back(0, 100'000 - i * 1000);
+	ring.push_back(ring.front());
+	original = ring;
+	size_t n = simplifier.simplifyWay(ring.data(), ring.size());
+	REQUIRE(n >= 4);
+	REQUIRE(n < 20);
+	REQUIRE(ring[0] == ring[n - 1]);
+	REQUIRE(isPinnedSubsequence(original, ring.data(), n));
+}
+
+TEST_CASE("simplifyWay is independent of how a way is used")
+{
+	// A way shared by two polygons is used forward in one ring and
+	// backward in the other; since it is always simplified in its
+	// stored order (and with the tolerance at its endpoints), both
+	// rings get the same vertexes for the shared edge
+	std::mt19937 rng(46);
+	std::uniform_int_distribution<int32_t> jitter(-3000, 3000);
+	std::vector<Coordinate> shared;
+	for (int32_t i = 0; i <= 200; i++)
+	{
+		shared.emplace_back(jitter(rng), 500'000'000 + i * 5000);
+	}
+
+	for (auto simplifier : { Simplifier(2000),
+		Simplifier::ofMeters(20, Simplifier::Method::VISVALINGAM) })
+	{
+		std::vector<Coordinate> forward = shared;
+		size_t n = simplifier.simplifyWay(forward.data(), forward.size());
+		REQUIRE(n >= 3);
+		REQUIRE(n < shared.size());
+		REQUIRE(isPinnedSubsequence(shared, forward.data(), n));
+
+		// Simplifying the same way again (e.g. for the neighboring
+		// polygon, or for a tile that contains another part of it)
+		// produces exactly the same vertexes
+		std::vector<Coordinate> again = shared;
+		REQUIRE(simplifier.simplifyWay(again.data(), again.size()) == n);
+		REQUIRE(std::equal(forward.begin(), forward.begin() + n, again.begin()));
+
+		// Simplifying it backward would not (in general), which is
+		// why the Polygonizer simplifies ways before assembling them
+		std::vector<Coordinate> backward(shared.rbegin(), shared.rend());
+		size_t nBackward = simplifier.simplifyWay(backward.data(), backward.size());
+		std::reverse(backward.begin(), backward.begin() + nBackward);
+		REQUIRE(isPinnedSubsequence(shared, backward.data(), nBackward));
+	}
+}
+
+TEST_CASE("Simplified features", "[.][gol]")
+{
+	Features world(R"(c:\geodesk\tests\w.gol)");
+	Simplifier simplifier = Simplifier::ofMeters(50);
+	int count = 0;
+	for (Feature area : world("a[boundary=administrative][admin_level=8]"))
+	{
+		if (++count > 100) break;
+		std::vector<std::vector<Coordinate>> parts = area.simplified(simplifier);
+		REQUIRE_FALSE(parts.empty());
+		for (const std::vector<Coordinate>& ring : parts)
+		{
+			REQUIRE(ring.size() >= 4);
+			REQUIRE(ring.front() == ring.back());
+		}
+	}
+	count = 0;
+	for (Feature node : world("n[place=city]"))
+	{
+		if (++count > 100) break;
+		std::vector<std::vector<Coordinate>> parts = node.simplified(simplifier);
+		REQUIRE(parts.size() == 1);
+		REQUIRE(parts[0].size() == 1);
+		REQUIRE(parts[0][0] == node.xy());
+	}
+}